@@ -12,8 +12,10 @@ ek79007_lcd lcd = ek79007_lcd(LCD_RST);
 gt911_touch touch = gt911_touch(TP_I2C_SDA, TP_I2C_SCL, TP_RST, TP_INT);
 
 static lv_disp_draw_buf_t draw_buf;
-static lv_color_t *buf;
-static lv_color_t *buf1;
+static lv_disp_drv_t disp_drv;
+
+// 条带模式：LVGL 在内部 SRAM 的小缓冲区中渲染，DMA2D 搬运到帧缓冲时 CPU 继续渲染下一条
+#define BAND_LINES 40
 
 // 显示刷新
 void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
@@ -22,8 +24,14 @@ void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color
   const int offsetx2 = area->x2;
   const int offsety1 = area->y1;
   const int offsety2 = area->y2;
-  lcd.lcd_draw_bitmap(offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, &color_p->full);
-  lv_disp_flush_ready(disp); // 告诉lvgl刷新完成
+  lcd.band_flush(offsetx1, offsety1, offsetx2 + 1, offsety2 + 1, &color_p->full);
+}
+
+// 条带搬运完成（中断上下文）
+static bool my_band_done(uint16_t *band, void *user_ctx)
+{
+  lv_disp_flush_ready((lv_disp_drv_t *)user_ctx); // 告诉lvgl刷新完成
+  return false;
 }
 
 void my_touchpad_read(lv_indev_drv_t *indev_driver, lv_indev_data_t *data)
@@ -71,22 +79,18 @@ void setup()
   touch.begin();
 
   lv_init();
-  size_t buffer_size = sizeof(lv_color_t) * LCD_H_RES * LCD_V_RES;
-  buf = (lv_color_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-  buf1 = (lv_color_t *)heap_caps_malloc(buffer_size, MALLOC_CAP_SPIRAM);
-  assert(buf);
-  assert(buf1);
+  bool band_ok = lcd.band_begin(BAND_LINES, 2);
+  assert(band_ok);
+  lcd.band_set_done_callback(my_band_done, &disp_drv);
 
-  lv_disp_draw_buf_init(&draw_buf, buf, buf1, LCD_H_RES * LCD_V_RES);
+  lv_disp_draw_buf_init(&draw_buf, lcd.band_buffer(0), lcd.band_buffer(1), LCD_H_RES * BAND_LINES);
 
-  static lv_disp_drv_t disp_drv;
   /*Initialize the display*/
   lv_disp_drv_init(&disp_drv);
   disp_drv.hor_res = LCD_H_RES;
   disp_drv.ver_res = LCD_V_RES;
   disp_drv.flush_cb = my_disp_flush;
   disp_drv.draw_buf = &draw_buf;
-  disp_drv.full_refresh = true;
   lv_disp_drv_register(&disp_drv);
 
   static lv_indev_drv_t indev_drv;
@@ -0,0 +1,242 @@
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_async.h"
+
+static const char *TAG = "lcd_async";
+
+// 协程帧池：固定槽位，不走堆分配
+alignas(16) static uint8_t s_frames[LCD_ASYNC_MAX_TASKS][LCD_ASYNC_FRAME_SIZE];
+static bool s_frame_used[LCD_ASYNC_MAX_TASKS];
+static portMUX_TYPE s_frame_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void *lcd_async_task::promise_type::operator new(size_t size) noexcept
+{
+    if (size > LCD_ASYNC_FRAME_SIZE) {
+        ESP_LOGE(TAG, "coroutine frame of %u bytes exceeds %d", (unsigned)size, LCD_ASYNC_FRAME_SIZE);
+        return NULL;
+    }
+    void *frame = NULL;
+    portENTER_CRITICAL(&s_frame_lock);
+    for (int i = 0; i < LCD_ASYNC_MAX_TASKS; i++) {
+        if (!s_frame_used[i]) {
+            s_frame_used[i] = true;
+            frame = s_frames[i];
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_frame_lock);
+    if (!frame) {
+        ESP_LOGE(TAG, "all %d coroutine frames in use", LCD_ASYNC_MAX_TASKS);
+    }
+    return frame;
+}
+
+void lcd_async_task::promise_type::operator delete(void *frame) noexcept
+{
+    int i = ((uint8_t *)frame - &s_frames[0][0]) / LCD_ASYNC_FRAME_SIZE;
+    portENTER_CRITICAL(&s_frame_lock);
+    s_frame_used[i] = false;
+    portEXIT_CRITICAL(&s_frame_lock);
+}
+
+void lcd_async_task::promise_type::unhandled_exception()
+{
+    ESP_LOGE(TAG, "unhandled exception in coroutine");
+    abort();
+}
+
+lcd_async_task::~lcd_async_task()
+{
+    // 没交给执行器的协程还停在起点，直接销毁
+    if (_handle) {
+        _handle.destroy();
+    }
+}
+
+lcd_executor::lcd_executor()
+{
+    _ready = NULL;
+    _task = NULL;
+}
+
+lcd_executor::~lcd_executor()
+{
+    end();
+}
+
+esp_err_t lcd_executor::begin(uint32_t stack_size, UBaseType_t priority, BaseType_t core)
+{
+    ESP_RETURN_ON_FALSE(!_ready, ESP_ERR_INVALID_STATE, TAG, "executor already started");
+
+    // 每个协程同一时刻最多挂在一个操作上，队列按协程数即可保证中断里投递不会失败
+    _ready = xQueueCreate(LCD_ASYNC_MAX_TASKS, sizeof(void *));
+    ESP_RETURN_ON_FALSE(_ready, ESP_ERR_NO_MEM, TAG, "no mem for ready queue");
+    if (xTaskCreatePinnedToCore(task_fn, "lcd_async", stack_size, this, priority, &_task, core) != pdPASS) {
+        vQueueDelete(_ready);
+        _ready = NULL;
+        ESP_LOGE(TAG, "create executor task failed");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void lcd_executor::end()
+{
+    if (!_ready) {
+        return;
+    }
+    // 空句柄让任务退出；仍在等待的协程不会再被恢复
+    void *stop = NULL;
+    xQueueSend(_ready, &stop, portMAX_DELAY);
+    while (_task) {
+        vTaskDelay(1);
+    }
+    vQueueDelete(_ready);
+    _ready = NULL;
+}
+
+bool lcd_executor::started()
+{
+    return _ready != NULL;
+}
+
+esp_err_t lcd_executor::spawn(lcd_async_task task)
+{
+    ESP_RETURN_ON_FALSE(_ready, ESP_ERR_INVALID_STATE, TAG, "executor not started");
+    ESP_RETURN_ON_FALSE(task.valid(), ESP_ERR_NO_MEM, TAG, "no coroutine frame");
+
+    void *addr = task._handle.address();
+    if (xQueueSend(_ready, &addr, portMAX_DELAY) != pdTRUE) {
+        return ESP_FAIL;
+    }
+    // 交给执行器后由协程自己在结束时释放帧
+    task._handle = nullptr;
+    return ESP_OK;
+}
+
+bool lcd_executor::post(std::coroutine_handle<> handle)
+{
+    void *addr = handle.address();
+    return xQueueSend(_ready, &addr, portMAX_DELAY) == pdTRUE;
+}
+
+bool lcd_executor::post_from_isr(std::coroutine_handle<> handle)
+{
+    void *addr = handle.address();
+    BaseType_t need_yield = pdFALSE;
+    xQueueSendFromISR(_ready, &addr, &need_yield);
+    return need_yield == pdTRUE;
+}
+
+void lcd_executor::task_fn(void *arg)
+{
+    lcd_executor *self = (lcd_executor *)arg;
+    void *addr = NULL;
+
+    while (xQueueReceive(self->_ready, &addr, portMAX_DELAY) == pdTRUE && addr) {
+        std::coroutine_handle<>::from_address(addr).resume();
+    }
+    self->_task = NULL;
+    vTaskDelete(NULL);
+}
+
+lcd_async_op::lcd_async_op(lcd_executor *executor, lcd_async_start_t start, void *ctx)
+{
+    _executor = executor;
+    _waiter = nullptr;
+    _fired = false;
+    _done = false;
+    _err = ESP_OK;
+    _spinlock = portMUX_INITIALIZER_UNLOCKED;
+
+    esp_err_t ret = executor ? start(ctx, on_done, this) : ESP_ERR_INVALID_STATE;
+    if (ret != ESP_OK) {
+        _err = ret;
+        _fired = true;
+        _done.store(true, std::memory_order_release);
+    }
+}
+
+lcd_async_op::~lcd_async_op()
+{
+    // 完成回调还会写这个对象，要等它最后一次写入之后才能释放
+    while (!_done.load(std::memory_order_acquire)) {
+        vTaskDelay(1);
+    }
+}
+
+bool lcd_async_op::await_suspend(std::coroutine_handle<> handle)
+{
+    // 完成可能发生在 await_ready 之后、挂起之前，加锁再判断一次
+    portENTER_CRITICAL(&_spinlock);
+    bool fired = _fired;
+    if (!fired) {
+        _waiter = handle;
+    }
+    portEXIT_CRITICAL(&_spinlock);
+    return !fired;
+}
+
+bool lcd_async_op::on_done(void *done_ctx)
+{
+    lcd_async_op *self = (lcd_async_op *)done_ctx;
+
+    portENTER_CRITICAL_ISR(&self->_spinlock);
+    std::coroutine_handle<> waiter = self->_waiter;
+    lcd_executor *executor = self->_executor;
+    self->_fired = true;
+    portEXIT_CRITICAL_ISR(&self->_spinlock);
+
+    bool need_yield = waiter ? executor->post_from_isr(waiter) : false;
+    // 协程此时可能已在另一个核上继续并开始析构本对象，析构会等 _done；这是对 *self 的最后一次访问
+    self->_done.store(true, std::memory_order_release);
+    return need_yield;
+}
+
+lcd_async_waiters::lcd_async_waiters()
+{
+    memset(_waiters, 0, sizeof(_waiters));
+    _num = 0;
+    _spinlock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+esp_err_t lcd_async_waiters::add(lcd_async_done_cb_t done_cb, void *done_ctx)
+{
+    esp_err_t ret = ESP_OK;
+
+    portENTER_CRITICAL(&_spinlock);
+    if (_num < LCD_ASYNC_MAX_WAITERS) {
+        _waiters[_num].cb = done_cb;
+        _waiters[_num].ctx = done_ctx;
+        _num++;
+    } else {
+        ret = ESP_ERR_NO_MEM;
+    }
+    portEXIT_CRITICAL(&_spinlock);
+    return ret;
+}
+
+bool lcd_async_waiters::complete_from_isr()
+{
+    waiter_t waiters[LCD_ASYNC_MAX_WAITERS];
+    uint8_t num;
+    bool need_yield = false;
+
+    portENTER_CRITICAL_ISR(&_spinlock);
+    num = _num;
+    memcpy(waiters, _waiters, num * sizeof(waiter_t));
+    _num = 0;
+    portEXIT_CRITICAL_ISR(&_spinlock);
+
+    for (uint8_t i = 0; i < num; i++) {
+        need_yield |= waiters[i].cb(waiters[i].ctx);
+    }
+    return need_yield;
+}
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <coroutine>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#define LCD_ASYNC_MAX_TASKS 8        // 同时存在的协程数
+#define LCD_ASYNC_FRAME_SIZE 1024    // 每个协程帧的大小上限，超出时创建失败
+#define LCD_ASYNC_MAX_WAITERS LCD_ASYNC_MAX_TASKS // 同一事件上同时等待的操作数，按协程数给足
+
+/**
+ * @brief Completion callback handed to the code that starts an operation, ISR-safe
+ *
+ * Same signature as lcd_event_cb_t, so it can be passed straight to `lcd_events::draw()`.
+ *
+ * @return true if a higher priority task has been woken
+ */
+typedef bool (*lcd_async_done_cb_t)(void *done_ctx);
+
+/**
+ * @brief Starts an operation and arranges for `done_cb(done_ctx)` to be called when it completes
+ */
+typedef esp_err_t (*lcd_async_start_t)(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx);
+
+class lcd_executor;
+
+/**
+ * @brief Fire-and-forget coroutine, run by an lcd_executor
+ *
+ * Frames come from a fixed pool of LCD_ASYNC_MAX_TASKS slots of LCD_ASYNC_FRAME_SIZE bytes, never
+ * from the heap. If the pool is full or the frame is too big, the task is invalid and
+ * `lcd_executor::spawn()` fails with ESP_ERR_NO_MEM. The frame is freed when the coroutine returns.
+ */
+class lcd_async_task
+{
+public:
+    struct promise_type {
+        lcd_async_task get_return_object()
+        {
+            return lcd_async_task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        static lcd_async_task get_return_object_on_allocation_failure()
+        {
+            return lcd_async_task();
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+        void return_void() {}
+        void unhandled_exception();
+
+        static void *operator new(size_t size) noexcept;
+        static void operator delete(void *frame) noexcept;
+    };
+
+    lcd_async_task() : _handle(nullptr) {}
+    lcd_async_task(lcd_async_task &&other) noexcept : _handle(other._handle)
+    {
+        other._handle = nullptr;
+    }
+    lcd_async_task(const lcd_async_task &) = delete;
+    lcd_async_task &operator=(const lcd_async_task &) = delete;
+    ~lcd_async_task();
+
+    bool valid() const
+    {
+        return _handle != nullptr;
+    }
+
+private:
+    friend class lcd_executor;
+    explicit lcd_async_task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * @brief Single-threaded executor: one FreeRTOS task resumes coroutines as their operations complete
+ *
+ * Completions arrive from ISRs (DMA done, refresh done, touch interrupt) and only queue the
+ * coroutine; all coroutine code runs in the executor task, one at a time.
+ */
+class lcd_executor
+{
+public:
+    lcd_executor();
+    ~lcd_executor();
+
+    esp_err_t begin(uint32_t stack_size = 4096, UBaseType_t priority = 5, BaseType_t core = tskNO_AFFINITY);
+    void end();
+    bool started();
+    esp_err_t spawn(lcd_async_task task);
+    bool post(std::coroutine_handle<> handle);
+    bool post_from_isr(std::coroutine_handle<> handle);
+
+private:
+    static void task_fn(void *arg);
+
+    QueueHandle_t _ready;
+    TaskHandle_t _task;
+};
+
+/**
+ * @brief Awaitable operation, started when constructed and awaited with `co_await`
+ *
+ * Returned by value from the `*_async()` methods. Construction calls `start`, so work can overlap
+ * with whatever the coroutine does before it awaits; awaiting an operation that has already
+ * completed does not suspend. `co_await` yields the operation's esp_err_t. Not copyable or
+ * movable, because the completion refers to it; if it is destroyed without being awaited, the
+ * destructor waits for the completion.
+ */
+class lcd_async_op
+{
+public:
+    lcd_async_op(lcd_executor *executor, lcd_async_start_t start, void *ctx);
+    lcd_async_op(const lcd_async_op &) = delete;
+    lcd_async_op &operator=(const lcd_async_op &) = delete;
+    ~lcd_async_op();
+
+    bool await_ready() const
+    {
+        return _done.load(std::memory_order_acquire);
+    }
+    bool await_suspend(std::coroutine_handle<> handle);
+    esp_err_t await_resume() const
+    {
+        return _err;
+    }
+
+    static bool on_done(void *done_ctx);
+
+protected:
+    lcd_executor *_executor;
+    std::coroutine_handle<> _waiter;
+    bool _fired;              /*!< Completion seen, guarded by _spinlock */
+    std::atomic<bool> _done;  /*!< Completion finished with this object, the last thing on_done() writes */
+    esp_err_t _err;
+    portMUX_TYPE _spinlock;
+};
+
+/**
+ * @brief Touch state delivered by a touch controller's `next_event()`
+ */
+typedef struct {
+    uint16_t x;       /*!< X coordinate, valid when `pressed` */
+    uint16_t y;       /*!< Y coordinate, valid when `pressed` */
+    bool pressed;     /*!< Touch point present after the interrupt */
+    esp_err_t err;    /*!< ESP_OK, or why no event could be waited for */
+} lcd_touch_event_t;
+
+/**
+ * @brief Reads the current touch point, called in the executor task after the interrupt
+ */
+typedef bool (*lcd_async_touch_read_t)(void *ctx, uint16_t *x, uint16_t *y);
+
+/**
+ * @brief Awaitable touch interrupt; `co_await` reads the controller over I2C and yields an lcd_touch_event_t
+ *
+ * The I2C read happens in `await_resume()`, i.e. in the executor task, not in the ISR.
+ */
+class lcd_touch_op : public lcd_async_op
+{
+public:
+    lcd_touch_op(lcd_executor *executor, lcd_async_start_t start, lcd_async_touch_read_t read, void *ctx)
+        : lcd_async_op(executor, start, ctx), _read(read), _ctx(ctx) {}
+
+    lcd_touch_event_t await_resume() const
+    {
+        lcd_touch_event_t event = {0, 0, false, _err};
+        if (_err == ESP_OK) {
+            event.pressed = _read(_ctx, &event.x, &event.y);
+        }
+        return event;
+    }
+
+private:
+    lcd_async_touch_read_t _read;
+    void *_ctx;
+};
+
+/**
+ * @brief Operations waiting for a recurring event (refresh done, touch interrupt)
+ *
+ * `add()` is an lcd_async_start_t-style registration; `complete_from_isr()` completes every
+ * operation registered so far and clears the list.
+ */
+class lcd_async_waiters
+{
+public:
+    lcd_async_waiters();
+
+    esp_err_t add(lcd_async_done_cb_t done_cb, void *done_ctx);
+    bool complete_from_isr();
+
+private:
+    typedef struct {
+        lcd_async_done_cb_t cb;
+        void *ctx;
+    } waiter_t;
+
+    waiter_t _waiters[LCD_ASYNC_MAX_WAITERS];
+    uint8_t _num;
+    portMUX_TYPE _spinlock;
+};
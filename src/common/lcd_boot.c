@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+#include "lcd_boot.h"
+
+static inline uint32_t lcd_boot_now_us(const lcd_boot_timeline_t *tl)
+{
+    return (uint32_t)(esp_timer_get_time() - tl->t0);
+}
+
+void lcd_boot_timeline_reset(lcd_boot_timeline_t *tl)
+{
+    if (!tl) {
+        return;
+    }
+    memset(tl, 0, sizeof(*tl));
+    tl->t0 = esp_timer_get_time();
+}
+
+void lcd_boot_stage_begin(lcd_boot_timeline_t *tl, const char *name, int32_t arg)
+{
+    if (!tl) {
+        return;
+    }
+
+    // 阶段表满了或嵌套过深时丢弃该阶段，但深度照常计数，保证 begin/end 配对
+    int16_t idx = -1;
+    if (tl->num < LCD_BOOT_MAX_STAGES && tl->depth < LCD_BOOT_MAX_DEPTH) {
+        idx = tl->num++;
+        lcd_boot_stage_t *stage = &tl->stages[idx];
+        stage->name = name;
+        stage->arg = arg;
+        stage->start_us = lcd_boot_now_us(tl);
+        stage->dur_us = 0;
+        stage->sleep_us = 0;
+        stage->depth = tl->depth;
+        LCD_TRACE_BEGIN(name);
+    } else {
+        tl->dropped++;
+    }
+    if (tl->depth < LCD_BOOT_MAX_DEPTH) {
+        tl->open[tl->depth] = idx;
+    }
+    tl->depth++;
+}
+
+void lcd_boot_stage_end(lcd_boot_timeline_t *tl)
+{
+    if (!tl || !tl->depth) {
+        return;
+    }
+
+    tl->depth--;
+    if (tl->depth < LCD_BOOT_MAX_DEPTH && tl->open[tl->depth] >= 0) {
+        lcd_boot_stage_t *stage = &tl->stages[tl->open[tl->depth]];
+        stage->dur_us = lcd_boot_now_us(tl) - stage->start_us;
+        LCD_TRACE_END(stage->name);
+    }
+}
+
+void lcd_boot_sleep_ms(lcd_boot_timeline_t *tl, uint32_t ms)
+{
+    if (!ms) {
+        return;
+    }
+
+    int64_t start = esp_timer_get_time();
+    vTaskDelay(pdMS_TO_TICKS(ms));
+    if (!tl) {
+        return;
+    }
+
+    uint32_t slept = (uint32_t)(esp_timer_get_time() - start);
+    for (uint8_t i = 0; i < tl->depth && i < LCD_BOOT_MAX_DEPTH; i++) {
+        if (tl->open[i] >= 0) {
+            tl->stages[tl->open[i]].sleep_us += slept;
+        }
+    }
+}
+
+uint32_t lcd_boot_cmd_delay_ms(const lcd_boot_delays_t *delays, int cmd, uint32_t default_ms)
+{
+    switch (cmd) {
+    case 0x11: // SLPOUT
+        return LCD_BOOT_DELAY(delays, sleep_out_ms, default_ms);
+    case 0x29: // DISPON
+        return LCD_BOOT_DELAY(delays, display_on_ms, default_ms);
+    default:
+        // 原本没有延时的命令保持不延时
+        return default_ms ? LCD_BOOT_DELAY(delays, cmd_ms, default_ms) : 0;
+    }
+}
+
+uint32_t lcd_boot_total_us(const lcd_boot_timeline_t *tl)
+{
+    uint32_t total = 0;
+
+    for (uint16_t i = 0; tl && i < tl->num; i++) {
+        if (tl->stages[i].depth == 0) {
+            total += tl->stages[i].dur_us;
+        }
+    }
+    return total;
+}
+
+void lcd_boot_timeline_print(const lcd_boot_timeline_t *tl, lcd_trace_write_t write, void *user_ctx)
+{
+    char line[96];
+    uint32_t sleep_us = 0;
+
+    if (!tl) {
+        return;
+    }
+    for (uint16_t i = 0; i < tl->num; i++) {
+        if (tl->stages[i].depth == 0) {
+            sleep_us += tl->stages[i].sleep_us;
+        }
+    }
+
+    snprintf(line, sizeof(line), "boot timeline: %u.%03u ms, %u.%03u ms in delays, %u stage(s) dropped\n",
+             (unsigned)(lcd_boot_total_us(tl) / 1000), (unsigned)(lcd_boot_total_us(tl) % 1000),
+             (unsigned)(sleep_us / 1000), (unsigned)(sleep_us % 1000), (unsigned)tl->dropped);
+    write ? write(line, user_ctx) : (void)printf("%s", line);
+    write ? write("   start_ms     dur_ms   delay_ms  stage\n", user_ctx) :
+            (void)printf("   start_ms     dur_ms   delay_ms  stage\n");
+
+    for (uint16_t i = 0; i < tl->num; i++) {
+        const lcd_boot_stage_t *stage = &tl->stages[i];
+        int n = snprintf(line, sizeof(line), "%11.3f%11.3f%11.3f  %*s%s", stage->start_us / 1000.0, stage->dur_us / 1000.0,
+                         stage->sleep_us / 1000.0, stage->depth * 2, "", stage->name);
+        if (stage->arg >= 0 && n > 0 && n < (int)sizeof(line)) {
+            snprintf(line + n, sizeof(line) - n, " 0x%02X", (unsigned)stage->arg);
+        }
+        strncat(line, "\n", sizeof(line) - strlen(line) - 1);
+        write ? write(line, user_ctx) : (void)printf("%s", line);
+    }
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "lcd_trace.h"
+
+#define LCD_BOOT_MAX_STAGES 64
+#define LCD_BOOT_MAX_DEPTH 8
+#define LCD_BOOT_DELAY_DEFAULT (-1) // 沿用驱动里的默认延时
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Fast-boot overrides for the bring-up delays, in milliseconds
+ *
+ * Every field left at `LCD_BOOT_DELAY_DEFAULT` keeps the driver's own delay. The panel and touch
+ * headers provide presets taken from the controller datasheet minimums.
+ */
+typedef struct {
+    int16_t reset_idle_ms;     /*!< Reset line inactive before the pulse */
+    int16_t reset_assert_ms;   /*!< Width of the reset pulse */
+    int16_t reset_release_ms;  /*!< Wait after releasing reset, or after a software reset */
+    int16_t sleep_out_ms;      /*!< Wait after SLPOUT (0x11) in the init sequence */
+    int16_t display_on_ms;     /*!< Wait after DISPON (0x29) in the init sequence */
+    int16_t cmd_ms;            /*!< Wait after any other init command that has a delay */
+} lcd_boot_delays_t;
+
+#define LCD_BOOT_DELAYS_DEFAULT()                    \
+    {                                                \
+        .reset_idle_ms = LCD_BOOT_DELAY_DEFAULT,     \
+        .reset_assert_ms = LCD_BOOT_DELAY_DEFAULT,   \
+        .reset_release_ms = LCD_BOOT_DELAY_DEFAULT,  \
+        .sleep_out_ms = LCD_BOOT_DELAY_DEFAULT,      \
+        .display_on_ms = LCD_BOOT_DELAY_DEFAULT,     \
+        .cmd_ms = LCD_BOOT_DELAY_DEFAULT,            \
+    }
+
+/**
+ * @brief Pick the override for `field` if one is set, `default_ms` otherwise
+ */
+#define LCD_BOOT_DELAY(delays, field, default_ms) \
+    (((delays) && (delays)->field >= 0) ? (uint32_t)(delays)->field : (uint32_t)(default_ms))
+
+/**
+ * @brief One bring-up stage; stages nest, `depth` is 0 for the outermost
+ */
+typedef struct {
+    const char *name;   /*!< Stage name, must be a string literal */
+    int32_t arg;        /*!< Command code for init commands, -1 otherwise */
+    uint32_t start_us;  /*!< Start, relative to `lcd_boot_timeline_reset()` */
+    uint32_t dur_us;    /*!< Duration */
+    uint32_t sleep_us;  /*!< Part of the duration spent in `lcd_boot_sleep_ms()` */
+    uint8_t depth;      /*!< Nesting level */
+} lcd_boot_stage_t;
+
+/**
+ * @brief Boot timeline filled by the driver classes and the native panel/touch drivers
+ */
+typedef struct {
+    int64_t t0;
+    uint16_t num;
+    uint16_t dropped;
+    uint8_t depth;
+    int16_t open[LCD_BOOT_MAX_DEPTH];
+    lcd_boot_stage_t stages[LCD_BOOT_MAX_STAGES];
+} lcd_boot_timeline_t;
+
+/**
+ * @brief Clear the timeline and restart its clock
+ */
+void lcd_boot_timeline_reset(lcd_boot_timeline_t *tl);
+
+/**
+ * @brief Open a stage nested in the current one; `tl` may be NULL
+ */
+void lcd_boot_stage_begin(lcd_boot_timeline_t *tl, const char *name, int32_t arg);
+
+/**
+ * @brief Close the innermost open stage
+ */
+void lcd_boot_stage_end(lcd_boot_timeline_t *tl);
+
+/**
+ * @brief Sleep and charge the time to every open stage; sleeps even if `tl` is NULL
+ */
+void lcd_boot_sleep_ms(lcd_boot_timeline_t *tl, uint32_t ms);
+
+/**
+ * @brief Delay after an init command: the SLPOUT/DISPON/other override if set, `default_ms` otherwise
+ */
+uint32_t lcd_boot_cmd_delay_ms(const lcd_boot_delays_t *delays, int cmd, uint32_t default_ms);
+
+/**
+ * @brief Sum of the outermost stages, in microseconds
+ */
+uint32_t lcd_boot_total_us(const lcd_boot_timeline_t *tl);
+
+/**
+ * @brief Print the timeline as a table
+ *
+ * @param write Line writer, NULL to use printf
+ */
+void lcd_boot_timeline_print(const lcd_boot_timeline_t *tl, lcd_trace_write_t write, void *user_ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+#include "lcd_trace.h"
+
+#if LCD_TRACE_ENABLE
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_attr.h"
+
+_Static_assert((LCD_TRACE_RECORDS & (LCD_TRACE_RECORDS - 1)) == 0, "LCD_TRACE_RECORDS must be a power of two");
+
+// 每个核一个环形缓冲区，写入位置用原子加预留，任务和中断都不需要加锁
+static lcd_trace_record_t s_ring[portNUM_PROCESSORS][LCD_TRACE_RECORDS];
+static atomic_uint s_write_idx[portNUM_PROCESSORS];
+static volatile bool s_paused;
+
+void IRAM_ATTR lcd_trace_record(const char *name, uint8_t phase, uint32_t arg)
+{
+    if (s_paused) {
+        return;
+    }
+
+    uint32_t ts = (uint32_t)esp_timer_get_time();
+    uint32_t core = (uint32_t)esp_cpu_get_core_id();
+    // 预留槽位后任务即使被迁移到另一个核，写入的仍是自己预留的槽位
+    uint32_t idx = atomic_fetch_add_explicit(&s_write_idx[core], 1, memory_order_relaxed);
+    lcd_trace_record_t *rec = &s_ring[core][idx & (LCD_TRACE_RECORDS - 1)];
+
+    rec->ts = ts;
+    rec->tid = xPortInIsrContext() ? 0 : (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+    rec->name = name;
+    rec->arg = arg;
+    rec->phase = phase;
+    rec->core = (uint8_t)core;
+}
+
+void lcd_trace_dump(lcd_trace_write_t write, void *user_ctx)
+{
+    char line[96];
+
+    s_paused = true;
+    // 等可能正在另一个核上写的记录落地
+    vTaskDelay(1);
+
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        uint32_t end = atomic_load(&s_write_idx[core]);
+        uint32_t start = end > LCD_TRACE_RECORDS ? end - LCD_TRACE_RECORDS : 0;
+
+        snprintf(line, sizeof(line), "# lcd_trace core %d records %u lost %u\n", core,
+                 (unsigned)(end - start), (unsigned)start);
+        write ? write(line, user_ctx) : (void)printf("%s", line);
+        for (uint32_t i = start; i < end; i++) {
+            const lcd_trace_record_t *rec = &s_ring[core][i & (LCD_TRACE_RECORDS - 1)];
+            snprintf(line, sizeof(line), "@%u,%u,%08x,%c,%u,%s\n", (unsigned)rec->core, (unsigned)rec->ts,
+                     (unsigned)rec->tid, rec->phase, (unsigned)rec->arg, rec->name ? rec->name : "?");
+            write ? write(line, user_ctx) : (void)printf("%s", line);
+        }
+    }
+    write ? write("# lcd_trace end\n", user_ctx) : (void)printf("# lcd_trace end\n");
+
+    s_paused = false;
+}
+
+void lcd_trace_clear(void)
+{
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        atomic_store(&s_write_idx[core], 0);
+    }
+}
+
+#endif
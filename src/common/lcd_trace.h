@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+/* 置 1 开启跟踪；为 0 时所有宏展开为空，接口变为空的内联函数 */
+#ifndef LCD_TRACE_ENABLE
+#define LCD_TRACE_ENABLE 0
+#endif
+
+#ifndef LCD_TRACE_RECORDS
+#define LCD_TRACE_RECORDS 1024 // 每个核的记录数，必须是 2 的幂
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Record phase, same letters as the Chrome trace event format
+ */
+typedef enum {
+    LCD_TRACE_PH_BEGIN = 'B',        /*!< Span begin on the current task */
+    LCD_TRACE_PH_END = 'E',          /*!< Span end on the current task */
+    LCD_TRACE_PH_INSTANT = 'i',      /*!< Point event */
+    LCD_TRACE_PH_ASYNC_BEGIN = 'b',  /*!< Async span begin, `arg` is the span id */
+    LCD_TRACE_PH_ASYNC_END = 'e',    /*!< Async span end, `arg` is the span id */
+    LCD_TRACE_PH_COUNTER = 'C',      /*!< Counter sample, `arg` is the value */
+} lcd_trace_phase_t;
+
+/**
+ * @brief Fixed-size binary trace record
+ */
+typedef struct {
+    uint32_t ts;       /*!< esp_timer time in microseconds, low 32 bits */
+    uint32_t tid;      /*!< Current task handle, 0 when recorded from an ISR */
+    const char *name;  /*!< Event name, must be a string literal */
+    uint32_t arg;      /*!< Span id, counter value or free-form argument */
+    uint8_t phase;     /*!< lcd_trace_phase_t */
+    uint8_t core;      /*!< Core the record was written on */
+} lcd_trace_record_t;
+
+/**
+ * @brief Line writer used by `lcd_trace_dump()`, e.g. a wrapper around `Serial.print`
+ */
+typedef void (*lcd_trace_write_t)(const char *line, void *user_ctx);
+
+#if LCD_TRACE_ENABLE
+
+/**
+ * @brief Append a record to the current core's ring; safe from tasks and ISRs
+ */
+void lcd_trace_record(const char *name, uint8_t phase, uint32_t arg);
+
+/**
+ * @brief Print all records as text lines for `tools/trace2json.py`; recording pauses meanwhile
+ *
+ * @param write Line writer, NULL to use printf
+ */
+void lcd_trace_dump(lcd_trace_write_t write, void *user_ctx);
+
+/**
+ * @brief Drop all records
+ */
+void lcd_trace_clear(void);
+
+#define LCD_TRACE_BEGIN(name) lcd_trace_record(name, LCD_TRACE_PH_BEGIN, 0)
+#define LCD_TRACE_END(name) lcd_trace_record(name, LCD_TRACE_PH_END, 0)
+#define LCD_TRACE_INSTANT(name, arg) lcd_trace_record(name, LCD_TRACE_PH_INSTANT, (uint32_t)(arg))
+#define LCD_TRACE_ASYNC_BEGIN(name, id) lcd_trace_record(name, LCD_TRACE_PH_ASYNC_BEGIN, (uint32_t)(id))
+#define LCD_TRACE_ASYNC_END(name, id) lcd_trace_record(name, LCD_TRACE_PH_ASYNC_END, (uint32_t)(id))
+#define LCD_TRACE_COUNTER(name, value) lcd_trace_record(name, LCD_TRACE_PH_COUNTER, (uint32_t)(value))
+
+#else
+
+static inline void lcd_trace_record(const char *name, uint8_t phase, uint32_t arg) {}
+static inline void lcd_trace_dump(lcd_trace_write_t write, void *user_ctx) {}
+static inline void lcd_trace_clear(void) {}
+
+#define LCD_TRACE_BEGIN(name) do {} while (0)
+#define LCD_TRACE_END(name) do {} while (0)
+#define LCD_TRACE_INSTANT(name, arg) do { (void)(arg); } while (0)
+#define LCD_TRACE_ASYNC_BEGIN(name, id) do { (void)(id); } while (0)
+#define LCD_TRACE_ASYNC_END(name, id) do { (void)(id); } while (0)
+#define LCD_TRACE_COUNTER(name, value) do { (void)(value); } while (0)
+
+#endif
+
+#ifdef __cplusplus
+}
+
+#if LCD_TRACE_ENABLE
+/**
+ * @brief Span covering the enclosing C++ scope
+ */
+class lcd_trace_scope
+{
+public:
+    lcd_trace_scope(const char *name) : _name(name)
+    {
+        lcd_trace_record(_name, LCD_TRACE_PH_BEGIN, 0);
+    }
+    ~lcd_trace_scope()
+    {
+        lcd_trace_record(_name, LCD_TRACE_PH_END, 0);
+    }
+
+private:
+    const char *_name;
+};
+
+#define LCD_TRACE_CONCAT_(a, b) a##b
+#define LCD_TRACE_CONCAT(a, b) LCD_TRACE_CONCAT_(a, b)
+#define LCD_TRACE_SCOPE(name) lcd_trace_scope LCD_TRACE_CONCAT(_trace_scope_, __LINE__)(name)
+#else
+#define LCD_TRACE_SCOPE(name) do {} while (0)
+#endif
+#endif
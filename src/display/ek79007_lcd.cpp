@@ -13,6 +13,7 @@
 #include "Arduino.h"
 
 #include "ek79007_lcd.h"
+#include "lcd_boot.h"
 
 #define LCD_H_RES 1024
 #define LCD_V_RES 600
@@ -28,24 +29,31 @@
 #define EXAMPLE_PIN_NUM_BK_LIGHT GPIO_NUM_1
 
 static const char *TAG = "example";
-esp_lcd_panel_handle_t panel_handle = NULL;
-esp_lcd_panel_io_handle_t io_handle = NULL;
 
 ek79007_lcd::ek79007_lcd(int8_t lcd_rst)
 {
     _lcd_rst = lcd_rst;
+    _ldo_mipi_phy = NULL;
+    _mipi_dsi_bus = NULL;
+    _panel_handle = NULL;
+    _io_handle = NULL;
+    memset(&_stats, 0, sizeof(_stats));
+    memset(&_boot, 0, sizeof(_boot));
+    _boot_delays = LCD_BOOT_DELAYS_DEFAULT();
+    _suspended = false;
+    _splash_label = NULL;
+    _executor = NULL;
 }
 
 void ek79007_lcd::example_bsp_enable_dsi_phy_power()
 {
     // 打开 MIPI DSI PHY 的电源，使其从“无电”状态进入“关机”状态
-    esp_ldo_channel_handle_t ldo_mipi_phy = NULL;
 #ifdef EXAMPLE_MIPI_DSI_PHY_PWR_LDO_CHAN
     esp_ldo_channel_config_t ldo_mipi_phy_config = {
         .chan_id = EXAMPLE_MIPI_DSI_PHY_PWR_LDO_CHAN,
         .voltage_mv = EXAMPLE_MIPI_DSI_PHY_PWR_LDO_VOLTAGE_MV,
     };
-    ESP_ERROR_CHECK(esp_ldo_acquire_channel(&ldo_mipi_phy_config, &ldo_mipi_phy));
+    ESP_ERROR_CHECK(esp_ldo_acquire_channel(&ldo_mipi_phy_config, &_ldo_mipi_phy));
     ESP_LOGI(TAG, "MIPI DSI PHY Powered on");
 #endif
 }
@@ -68,31 +76,46 @@ void ek79007_lcd::example_bsp_set_lcd_backlight(uint32_t level)
 #endif
 }
 
+void ek79007_lcd::set_splash(const char *partition_label)
+{
+    // 需在 begin() 之前调用，标签字符串需一直有效
+    _splash_label = partition_label;
+}
+
 void ek79007_lcd::begin()
 {   
+    lcd_boot_timeline_reset(&_boot);
+    lcd_boot_stage_begin(&_boot, "begin", -1);
+    lcd_boot_stage_begin(&_boot, "phy_power", -1);
     example_bsp_enable_dsi_phy_power();
     example_bsp_init_lcd_backlight();
     example_bsp_set_lcd_backlight(EXAMPLE_LCD_BK_LIGHT_OFF_LEVEL);
+    lcd_boot_stage_end(&_boot);
 
     // 首先创建 MIPI DSI 总线，它还将初始化 DSI PHY
-    esp_lcd_dsi_bus_handle_t mipi_dsi_bus;
+    lcd_boot_stage_begin(&_boot, "dsi_bus", -1);
     esp_lcd_dsi_bus_config_t bus_config = EK79007_PANEL_BUS_DSI_2CH_CONFIG();
-    ESP_ERROR_CHECK(esp_lcd_new_dsi_bus(&bus_config, &mipi_dsi_bus));
+    ESP_ERROR_CHECK(esp_lcd_new_dsi_bus(&bus_config, &_mipi_dsi_bus));
+    lcd_boot_stage_end(&_boot);
 
     ESP_LOGI(TAG, "Install MIPI DSI LCD control panel");
     // 我们使用DBI接口发送LCD命令和参数
     esp_lcd_dbi_io_config_t dbi_config = EK79007_PANEL_IO_DBI_CONFIG();
 
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_dbi(mipi_dsi_bus, &dbi_config, &io_handle));
+    lcd_boot_stage_begin(&_boot, "dbi_io", -1);
+    ESP_ERROR_CHECK(esp_lcd_new_panel_io_dbi(_mipi_dsi_bus, &dbi_config, &_io_handle));
+    lcd_boot_stage_end(&_boot);
 
     // 创建EK79007控制面板
     esp_lcd_dpi_panel_config_t dpi_config = EK79007_1024_600_PANEL_60HZ_CONFIG(MIPI_DPI_PX_FORMAT);
 
     ek79007_vendor_config_t vendor_config = {
         .mipi_config = {
-            .dsi_bus = mipi_dsi_bus,
+            .dsi_bus = _mipi_dsi_bus,
             .dpi_config = &dpi_config,
         },
+        .boot_timeline = &_boot,
+        .boot_delays = &_boot_delays,
     };
     const esp_lcd_panel_dev_config_t panel_config = {
         .reset_gpio_num = _lcd_rst,
@@ -100,17 +123,104 @@ void ek79007_lcd::begin()
         .bits_per_pixel = LCD_BIT_PER_PIXEL,
         .vendor_config = &vendor_config,
     };
-    ESP_ERROR_CHECK(esp_lcd_new_panel_ek79007(io_handle, &panel_config, &panel_handle));
-    ESP_ERROR_CHECK(esp_lcd_panel_reset(panel_handle));
-    ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle));
+    lcd_boot_stage_begin(&_boot, "new_panel", -1);
+    ESP_ERROR_CHECK(esp_lcd_new_panel_ek79007(_io_handle, &panel_config, &_panel_handle));
+    lcd_boot_stage_end(&_boot);
+    lcd_boot_stage_begin(&_boot, "reset", -1);
+    ESP_ERROR_CHECK(esp_lcd_panel_reset(_panel_handle));
+    lcd_boot_stage_end(&_boot);
+    lcd_boot_stage_begin(&_boot, "init", -1);
+    ESP_ERROR_CHECK(esp_lcd_panel_init(_panel_handle));
+    lcd_boot_stage_end(&_boot);
+    lcd_boot_stage_begin(&_boot, "components", -1);
+    ESP_ERROR_CHECK(_events.begin(_panel_handle));
+    ESP_ERROR_CHECK(_blit.begin(_panel_handle, &_events, LCD_H_RES, LCD_V_RES, &_stats));
+    _blit.set_color_lut(&_color_lut);
+    _blit.set_pipeline(&_pipeline);
+    ESP_ERROR_CHECK(_render_scale.begin(&_blit, &_stats, LCD_H_RES, LCD_V_RES));
+    lcd_boot_stage_end(&_boot);
+
+    // 在打开背光前画好启动画面，上电后不再先黑屏
+    if (_splash_label) {
+        lcd_boot_stage_begin(&_boot, "splash", -1);
+        show_splash(_splash_label);
+        lcd_boot_stage_end(&_boot);
+    }
 
     // 打开背光
     example_bsp_set_lcd_backlight(EXAMPLE_LCD_BK_LIGHT_ON_LEVEL);
+    lcd_boot_stage_end(&_boot);
+}
+
+typedef struct {
+    uint16_t *dst;
+    const uint8_t *src;
+    uint32_t src_stride;
+    uint16_t w;
+    uint16_t x;
+    uint16_t y;
+} dither_job_t;
+
+static void dither_rows(uint16_t row, uint16_t rows, void *arg)
+{
+    dither_job_t *job = (dither_job_t *)arg;
+    lcd_dither_rgb888(job->dst + (uint32_t)row * LCD_H_RES, LCD_H_RES, job->src + row * job->src_stride,
+                      job->src_stride, job->w, rows, job->x, job->y + row, NULL);
 }
 
 void ek79007_lcd::lcd_draw_bitmap(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data)
 {
-    esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, color_data);
+    if (!fb_writable()) {
+        return;
+    }
+    LCD_TRACE_SCOPE("lcd_draw_bitmap");
+    _stats.draw_calls++;
+    _stats.draw_pixels += (uint32_t)(x_end - x_start) * (y_end - y_start);
+    if (_render_scale.active()) {
+        // 坐标按渲染分辨率给出，放大后直接写入帧缓冲，不做瓦片比较；颜色校正由 lcd_blit 完成
+        uint16_t bounds[4];
+        esp_err_t ret = _render_scale.draw(x_start, y_start, x_end, y_end, color_data, bounds);
+        if (bounds[2]) {
+            _tile_diff.invalidate(bounds[0], bounds[1], bounds[0] + bounds[2], bounds[1] + bounds[3]);
+        }
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "upscale failed: %s", esp_err_to_name(ret));
+        }
+        return;
+    }
+    if (_color_lut.active()) {
+        // 查表和拷贝合成一次 CPU 写入，由 lcd_blit 完成（流水线在跑时两个核分行一起做）；
+        // 源缓冲不能改，可能是映射的 flash
+        // 空矩形或完全在屏幕外的矩形先排除，否则下面裁剪后的宽高会下溢
+        if (x_start >= x_end || y_start >= y_end || x_start >= LCD_H_RES || y_start >= LCD_V_RES) {
+            return;
+        }
+        uint16_t w = (x_end < LCD_H_RES ? x_end : LCD_H_RES) - x_start;
+        uint16_t h = (y_end < LCD_V_RES ? y_end : LCD_V_RES) - y_start;
+        lcd_blit_desc_t desc = {
+            .src = color_data,
+            .src_stride = (uint16_t)(x_end - x_start),
+            .src_x = 0,
+            .src_y = 0,
+            .x = x_start,
+            .y = y_start,
+            .w = w,
+            .h = h,
+        };
+        if (_blit.blit(&desc) != ESP_OK) {
+            ESP_LOGW(TAG, "corrected copy failed");
+        }
+        _tile_diff.invalidate(x_start, y_start, x_start + w, y_start + h);
+        return;
+    }
+    if (_tile_diff.started()) {
+        // 只把内容有变化的瓦片写入帧缓冲
+        if (_tile_diff.draw(x_start, y_start, x_end, y_end, color_data) != ESP_OK) {
+            ESP_LOGW(TAG, "tile diff draw failed");
+        }
+        return;
+    }
+    _events.draw(x_start, y_start, x_end, y_end, color_data);
 }
 
 void ek79007_lcd::draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t *color_data)
@@ -120,7 +230,7 @@ void ek79007_lcd::draw16bitbergbbitmap(uint16_t x, uint16_t y, uint16_t w, uint1
     uint16_t x_end = w + x;
     uint16_t y_end = h + y;
 
-    esp_lcd_panel_draw_bitmap(panel_handle, x_start, y_start, x_end, y_end, color_data);
+    lcd_draw_bitmap(x_start, y_start, x_end, y_end, color_data);
 }
 
 void ek79007_lcd::fillScreen(uint16_t color)
@@ -133,12 +243,359 @@ void ek79007_lcd::fillScreen(uint16_t color)
 
 void ek79007_lcd::te_on()
 {
-    esp_lcd_panel_io_tx_param(io_handle, 0x35,new (uint8_t[]){0x00}, 1);
+    esp_lcd_panel_io_tx_param(_io_handle, 0x35,new (uint8_t[]){0x00}, 1);
 }
 
 void ek79007_lcd::te_off()
 {
-    esp_lcd_panel_io_tx_param(io_handle, 0x34,new (uint8_t[]){0x00}, 0);
+    esp_lcd_panel_io_tx_param(_io_handle, 0x34,new (uint8_t[]){0x00}, 0);
+}
+
+bool ek79007_lcd::suspend()
+{
+    if (!_panel_handle || _suspended) {
+        return _panel_handle != NULL;
+    }
+
+    // 等在途的 DMA 搬运结束；DSI 链路和帧缓冲保持不动，休眠期间的绘制在唤醒后直接可见
+    _events.wait_idle();
+    example_bsp_set_lcd_backlight(EXAMPLE_LCD_BK_LIGHT_OFF_LEVEL);
+    if (esp_lcd_panel_disp_on_off(_panel_handle, false) != ESP_OK ||
+        esp_lcd_panel_disp_sleep(_panel_handle, true) != ESP_OK) {
+        ESP_LOGE(TAG, "panel suspend failed");
+        return false;
+    }
+    _suspended = true;
+    return true;
+}
+
+bool ek79007_lcd::resume()
+{
+    if (!_suspended) {
+        return _panel_handle != NULL;
+    }
+
+    // 只发送退出休眠和开显示命令，不再复位和重发初始化序列；耗时记录在 boot_timeline() 中
+    lcd_boot_timeline_reset(&_boot);
+    lcd_boot_stage_begin(&_boot, "resume", -1);
+    esp_err_t ret = esp_lcd_panel_disp_sleep(_panel_handle, false);
+    if (ret == ESP_OK) {
+        ret = esp_lcd_panel_disp_on_off(_panel_handle, true);
+    }
+    lcd_boot_stage_end(&_boot);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "panel resume failed");
+        return false;
+    }
+    example_bsp_set_lcd_backlight(EXAMPLE_LCD_BK_LIGHT_ON_LEVEL);
+    _suspended = false;
+    return true;
+}
+
+bool ek79007_lcd::suspended()
+{
+    return _suspended;
+}
+
+bool ek79007_lcd::show_splash(const char *partition_label)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    esp_err_t ret = lcd_splash_show(&_events, &_blit, partition_label, LCD_H_RES, LCD_V_RES);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "splash \"%s\" not shown: %s", partition_label, esp_err_to_name(ret));
+        return false;
+    }
+    _tile_diff.invalidate_all();
+    return true;
+}
+
+bool ek79007_lcd::assets_begin(const char *partition_label)
+{
+    return _assets.begin(partition_label) == ESP_OK;
+}
+
+const lcd_asset_t *ek79007_lcd::find_asset(const char *name)
+{
+    return _assets.find(name);
+}
+
+bool ek79007_lcd::draw_asset(const char *name, uint16_t x, uint16_t y)
+{
+    const lcd_asset_t *asset = _assets.find(name);
+    if (!asset) {
+        ESP_LOGW(TAG, "no asset \"%s\"", name);
+        return false;
+    }
+    return draw_asset(asset, x, y);
+}
+
+bool ek79007_lcd::draw_asset(const lcd_asset_t *asset, uint16_t x, uint16_t y)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    if (asset && asset->format == LCD_ASSET_FORMAT_Q565) {
+        return draw_q565(_assets.pixels(asset), _assets.data_size(asset), x, y);
+    }
+    if (!asset || asset->format != LCD_ASSET_FORMAT_RGB565 ||
+        x + asset->width > LCD_H_RES || y + asset->height > LCD_V_RES) {
+        return false;
+    }
+    // 像素直接从映射的 flash 交给绘制路径，不做拷贝；资源包在整个运行期间保持映射
+    lcd_draw_bitmap(x, y, x + asset->width, y + asset->height, (uint16_t *)_assets.pixels(asset));
+    return true;
+}
+
+bool ek79007_lcd::draw_q565(const void *data, size_t size, int16_t x, int16_t y)
+{
+    return draw_q565(data, size, x, y, 0, 0, LCD_H_RES, LCD_V_RES);
+}
+
+bool ek79007_lcd::draw_q565(const void *data, size_t size, int16_t x, int16_t y,
+                            uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    // 逐行解码直接写入帧缓冲，不经过暂存缓冲；写入的区域需让瓦片比较失效
+    esp_err_t ret = lcd_q565_draw(&_blit, &_stats, data, size, x, y, LCD_H_RES, LCD_V_RES, clip_x, clip_y, clip_w, clip_h);
+    _tile_diff.invalidate(clip_x, clip_y, clip_x + clip_w < LCD_H_RES ? clip_x + clip_w : LCD_H_RES,
+                          clip_y + clip_h < LCD_V_RES ? clip_y + clip_h : LCD_V_RES);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Q565 draw failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
+bool ek79007_lcd::font_begin(const void *data, size_t size)
+{
+    return _font.begin(data, size) == ESP_OK;
+}
+
+bool ek79007_lcd::draw_text(int16_t x, int16_t y, const char *text, uint16_t color)
+{
+    return draw_text(x, y, text, color, 0, 0, LCD_H_RES, LCD_V_RES);
+}
+
+bool ek79007_lcd::draw_text(int16_t x, int16_t y, const char *text, uint16_t color,
+                            uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    uint16_t *fb = _blit.cpu_begin();
+    if (!fb) {
+        return false;
+    }
+
+    // 整串文字一次混合进帧缓冲，结束后只回写并失效实际画到的矩形；字形边缘是混合出来的，
+    // 只能校正文字颜色，不能事后原地查表
+    lcd_font_surface_t surface = {
+        .pixels = fb,
+        .stride = LCD_H_RES,
+        .width = LCD_H_RES,
+        .height = LCD_V_RES,
+        .format = LCD_FONT_SURFACE_RGB565,
+    };
+    uint16_t bounds[4];
+    esp_err_t ret = lcd_font_draw(&surface, &_font, text, x, y, _color_lut.map(color), clip_x, clip_y, clip_w, clip_h,
+                                  bounds, &_stats);
+    if (bounds[2]) {
+        _blit.cpu_end(bounds[0], bounds[1], bounds[2], bounds[3], true);
+        _tile_diff.invalidate(bounds[0], bounds[1], bounds[0] + bounds[2], bounds[1] + bounds[3]);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "text draw failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
+int32_t ek79007_lcd::text_width(const char *text)
+{
+    return _font.text_width(text);
+}
+
+bool ek79007_lcd::draw_affine(const lcd_affine_image_t *img, const lcd_affine_xform_t *xf)
+{
+    return draw_affine(img, xf, 0, 0, LCD_H_RES, LCD_V_RES);
+}
+
+bool ek79007_lcd::draw_affine(const lcd_affine_image_t *img, const lcd_affine_xform_t *xf,
+                              uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    uint16_t *fb = _blit.cpu_begin();
+    if (!fb) {
+        return false;
+    }
+
+    // 旋转后的外接矩形往往比实际像素大，只回写并失效真正写过的范围；
+    // 外接矩形里有没写到的像素，颜色校正在采样时做，不能事后原地查表
+    uint16_t bounds[4];
+    const lcd_color_lut_table_t *lut = _color_lut.acquire_table();
+    esp_err_t ret = lcd_affine_draw(fb, LCD_H_RES, LCD_H_RES, LCD_V_RES, img, xf, clip_x, clip_y, clip_w, clip_h,
+                                    bounds, &_stats, lut);
+    _color_lut.release_table(lut);
+    if (bounds[2]) {
+        _blit.cpu_end(bounds[0], bounds[1], bounds[2], bounds[3], true);
+        _tile_diff.invalidate(bounds[0], bounds[1], bounds[0] + bounds[2], bounds[1] + bounds[3]);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "affine draw failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
+bool ek79007_lcd::draw_rgb888(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t *rgb, uint32_t stride)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    if (x >= LCD_H_RES || y >= LCD_V_RES) {
+        return true;
+    }
+    uint16_t *fb = _blit.cpu_begin();
+    if (!fb) {
+        return false;
+    }
+
+    // 抖动和格式转换一步完成，直接写进帧缓冲，不需要中间的 RGB565 缓冲
+    uint16_t draw_w = x + w > LCD_H_RES ? LCD_H_RES - x : w;
+    uint16_t draw_h = y + h > LCD_V_RES ? LCD_V_RES - y : h;
+    uint32_t src_stride = stride ? stride : (uint32_t)w * 3;
+    if (!rgb || src_stride < (uint32_t)draw_w * 3) {
+        ESP_LOGW(TAG, "RGB888 draw failed: invalid arguments");
+        return false;
+    }
+    // 抖动阈值按屏幕坐标取，按行分块并行的结果和整块一样；统计在这里记一次
+    int64_t start = esp_timer_get_time();
+    dither_job_t job = {fb + (uint32_t)y * LCD_H_RES + x, rgb, src_stride, draw_w, x, y};
+    _blit.parallel_rows(draw_h, dither_rows, &job);
+    _stats.dither_pixels += (uint32_t)draw_w * draw_h;
+    _stats.dither_us += esp_timer_get_time() - start;
+    _blit.cpu_end(x, y, draw_w, draw_h);
+    _tile_diff.invalidate(x, y, x + draw_w, y + draw_h);
+    return true;
+}
+
+bool ek79007_lcd::draw_indexed(lcd_indexed *surface, uint16_t x, uint16_t y)
+{
+    return draw_indexed(surface, 0, 0, x, y, surface->width(), surface->height());
+}
+
+bool ek79007_lcd::draw_indexed(lcd_indexed *surface, uint16_t src_x, uint16_t src_y, uint16_t x, uint16_t y,
+                               uint16_t w, uint16_t h)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    if (x >= LCD_H_RES || y >= LCD_V_RES || src_x >= surface->width() || src_y >= surface->height()) {
+        return true;
+    }
+    w = x + w > LCD_H_RES ? LCD_H_RES - x : w;
+    h = y + h > LCD_V_RES ? LCD_V_RES - y : h;
+    w = src_x + w > surface->width() ? surface->width() - src_x : w;
+    h = src_y + h > surface->height() ? surface->height() - src_y : h;
+
+    // 开了颜色校正时只校正 256 色调色板，展开本身不再多花时间
+    uint16_t corrected[LCD_INDEXED_COLORS];
+    const uint16_t *palette = NULL;
+    if (_color_lut.active()) {
+        const uint16_t *src = surface->palette();
+        for (int i = 0; i < LCD_INDEXED_COLORS; i++) {
+            corrected[i] = _color_lut.map(src[i]);
+        }
+        palette = corrected;
+    }
+
+    uint16_t *fb = _blit.cpu_begin();
+    if (!fb) {
+        return false;
+    }
+    esp_err_t ret = surface->expand(fb + (uint32_t)y * LCD_H_RES + x, LCD_H_RES, src_x, src_y, w, h, palette, &_stats);
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "indexed draw failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    _blit.cpu_end(x, y, w, h, true);
+    _tile_diff.invalidate(x, y, x + w, y + h);
+    return true;
+}
+
+bool ek79007_lcd::screen_cache_begin(uint8_t slots)
+{
+    return _screens.begin(&_blit, &_events, &_stats, LCD_H_RES, LCD_V_RES, slots) == ESP_OK;
+}
+
+bool ek79007_lcd::screen_store(uint32_t id)
+{
+    // 保存当前帧缓冲里已经画好的整屏画面
+    return _screens.store(id) == ESP_OK;
+}
+
+bool ek79007_lcd::screen_restore(uint32_t id)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    if (_screens.restore(id) != ESP_OK) {
+        return false;
+    }
+    _stats.draw_calls++;
+    _stats.draw_pixels += (uint32_t)LCD_H_RES * LCD_V_RES;
+    // 帧缓冲整体被替换，瓦片哈希全部作废
+    _tile_diff.invalidate_all();
+    return true;
+}
+
+void ek79007_lcd::screen_invalidate(uint32_t id)
+{
+    _screens.invalidate(id);
+}
+
+bool ek79007_lcd::transition(const uint16_t *from, const uint16_t *to, lcd_transition_type_t type,
+                             uint32_t duration_ms)
+{
+    return run_transition(from, to, type, duration_ms, false);
+}
+
+bool ek79007_lcd::run_transition(const uint16_t *from, const uint16_t *to, lcd_transition_type_t type,
+                                 uint32_t duration_ms, bool corrected)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    // 第一次使用时才注册刷新完成监听
+    if (!_transition.started() && _transition.begin(&_blit, &_events, &_stats, LCD_H_RES, LCD_V_RES) != ESP_OK) {
+        return false;
+    }
+    esp_err_t ret = _transition.run(from, to, type, duration_ms, corrected);
+    _tile_diff.invalidate_all();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "transition failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
+bool ek79007_lcd::screen_transition(uint32_t from_id, uint32_t to_id, lcd_transition_type_t type,
+                                    uint32_t duration_ms)
+{
+    const uint16_t *from = _screens.pixels(from_id);
+    const uint16_t *to = _screens.pixels(to_id);
+    if (!from || !to) {
+        ESP_LOGW(TAG, "screen 0x%08lx not cached", (unsigned long)(from ? to_id : from_id));
+        return false;
+    }
+    // 缓存的画面是从帧缓冲读回的，已经校正过
+    return run_transition(from, to, type, duration_ms, true);
 }
 
 uint16_t ek79007_lcd::width()
@@ -150,3 +607,445 @@ uint16_t ek79007_lcd::height()
 {
     return LCD_V_RES;
 }
+
+bool ek79007_lcd::set_color_lut(const uint8_t r[32], const uint8_t g[64], const uint8_t b[32])
+{
+    return _color_lut.set(r, g, b) == ESP_OK;
+}
+
+bool ek79007_lcd::set_color_gamma(float r, float g, float b)
+{
+    return _color_lut.set_gamma(r, g, b) == ESP_OK;
+}
+
+void ek79007_lcd::clear_color_lut()
+{
+    _color_lut.clear();
+}
+
+lcd_surface<lcd_format_rgb565> ek79007_lcd::fb_begin(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    uint16_t *fb = fb_writable() ? _blit.cpu_begin() : NULL;
+    if (!fb) {
+        return lcd_surface<lcd_format_rgb565>();
+    }
+    return lcd_surface<lcd_format_rgb565>(fb, LCD_H_RES, LCD_V_RES).sub(x, y, w, h);
+}
+
+void ek79007_lcd::fb_end(const lcd_surface<lcd_format_rgb565> &area, uint16_t x, uint16_t y)
+{
+    _blit.cpu_end(x, y, area.width(), area.height());
+    _tile_diff.invalidate(x, y, x + area.width(), y + area.height());
+}
+
+bool ek79007_lcd::set_render_scale(uint8_t level)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    if (level == _render_scale.level()) {
+        return true;
+    }
+    if (_render_scale.set_level(level) != ESP_OK) {
+        return false;
+    }
+    // 换档后帧缓冲里是旧分辨率的内容，瓦片记录全部作废
+    _tile_diff.invalidate_all();
+    return true;
+}
+
+uint8_t ek79007_lcd::render_scale()
+{
+    return _render_scale.level();
+}
+
+void ek79007_lcd::set_render_scale_filter(lcd_render_scale_filter_t filter)
+{
+    _render_scale.set_filter(filter);
+}
+
+void ek79007_lcd::set_render_scale_budget(uint32_t frame_budget_us)
+{
+    _render_scale.set_budget(frame_budget_us);
+}
+
+bool ek79007_lcd::render_scale_update(uint32_t frame_us)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    if (!_render_scale.update(frame_us)) {
+        return false;
+    }
+    _tile_diff.invalidate_all();
+    return true;
+}
+
+uint16_t ek79007_lcd::render_width()
+{
+    return _render_scale.width();
+}
+
+uint16_t ek79007_lcd::render_height()
+{
+    return _render_scale.height();
+}
+
+bool ek79007_lcd::set_executor(lcd_executor *executor)
+{
+    if (!executor) {
+        return false;
+    }
+    // 刷新完成监听只登记一次，之后换执行器只换指针
+    if (!_executor && _events.add_refresh_done_listener(on_vsync, this) != ESP_OK) {
+        ESP_LOGE(TAG, "register vsync listener failed");
+        return false;
+    }
+    _executor = executor;
+    return true;
+}
+
+lcd_async_op ek79007_lcd::blit_async(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end,
+                                     const uint16_t *color_data)
+{
+    blit_args_t args = {this, x_start, y_start, x_end, y_end, color_data};
+    // 构造时就提交，参数只在构造期间使用
+    return lcd_async_op(_executor, blit_start, &args);
+}
+
+lcd_async_op ek79007_lcd::vsync()
+{
+    return lcd_async_op(_executor, vsync_start, this);
+}
+
+esp_err_t ek79007_lcd::blit_start(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx)
+{
+    blit_args_t *args = (blit_args_t *)ctx;
+    ek79007_lcd *self = args->self;
+
+    if (!args->color_data || args->x_start >= args->x_end || args->y_start >= args->y_end ||
+        args->x_end > LCD_H_RES || args->y_end > LCD_V_RES) {
+        ESP_LOGW(TAG, "blit_async: invalid rectangle");
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!self->fb_writable()) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    self->_stats.draw_calls++;
+    self->_stats.draw_pixels += (uint32_t)(args->x_end - args->x_start) * (args->y_end - args->y_start);
+    // 不经过瓦片比较和渲染缩放；帧缓冲变了，瓦片比较的旧内容作废
+    self->_tile_diff.invalidate(args->x_start, args->y_start, args->x_end, args->y_end);
+    if (self->_color_lut.active()) {
+        // DMA2D 不能查表，开了颜色校正时同步拷贝并校正，返回前就已完成
+        lcd_blit_desc_t desc = {
+            .src = args->color_data,
+            .src_stride = (uint16_t)(args->x_end - args->x_start),
+            .src_x = 0,
+            .src_y = 0,
+            .x = args->x_start,
+            .y = args->y_start,
+            .w = (uint16_t)(args->x_end - args->x_start),
+            .h = (uint16_t)(args->y_end - args->y_start),
+        };
+        esp_err_t ret = self->_blit.blit(&desc);
+        if (ret != ESP_OK) {
+            ESP_LOGW(TAG, "blit_async: corrected copy failed");
+            return ret;
+        }
+        done_cb(done_ctx);
+        return ESP_OK;
+    }
+    // 直接交给 DMA 搬运
+    return self->_events.draw(args->x_start, args->y_start, args->x_end, args->y_end, args->color_data, done_cb,
+                              done_ctx);
+}
+
+esp_err_t ek79007_lcd::vsync_start(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx)
+{
+    ek79007_lcd *self = (ek79007_lcd *)ctx;
+    return self->_vsync_waiters.add(done_cb, done_ctx);
+}
+
+bool ek79007_lcd::on_vsync(void *user_ctx)
+{
+    ek79007_lcd *self = (ek79007_lcd *)user_ctx;
+    return self->_vsync_waiters.complete_from_isr();
+}
+
+esp_lcd_panel_handle_t ek79007_lcd::get_panel_handle()
+{
+    return _panel_handle;
+}
+
+esp_lcd_panel_io_handle_t ek79007_lcd::get_io_handle()
+{
+    return _io_handle;
+}
+
+bool ek79007_lcd::band_begin(uint16_t band_lines, uint8_t band_num)
+{
+    return _band.begin(&_events, &_stats, LCD_H_RES, band_lines, band_num) == ESP_OK;
+}
+
+uint16_t *ek79007_lcd::band_buffer(uint8_t index)
+{
+    return _band.get_buffer(index);
+}
+
+uint16_t *ek79007_lcd::band_acquire()
+{
+    return _band.acquire();
+}
+
+bool ek79007_lcd::band_flush(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *band)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    if (_render_scale.active() || _color_lut.active()) {
+        // DMA2D 搬运不做缩放和查表，改走 lcd_draw_bitmap 的同步路径；返回时条带已读完，可以直接完成
+        lcd_draw_bitmap(x_start, y_start, x_end, y_end, band);
+        _band.complete(band);
+        return true;
+    }
+    _stats.draw_calls++;
+    _stats.draw_pixels += (uint32_t)(x_end - x_start) * (y_end - y_start);
+    _tile_diff.invalidate(x_start, y_start, x_end, y_end);
+    if (_band.flush(x_start, y_start, x_end, y_end, band) != ESP_OK) {
+        ESP_LOGW(TAG, "band flush failed");
+        return false;
+    }
+    return true;
+}
+
+void ek79007_lcd::band_set_done_callback(lcd_band_done_cb_t cb, void *user_ctx)
+{
+    _band.set_done_callback(cb, user_ctx);
+}
+
+uint16_t ek79007_lcd::band_lines()
+{
+    return _band.lines();
+}
+
+bool ek79007_lcd::tile_diff_begin()
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    return _tile_diff.begin(_panel_handle, &_events, &_blit, &_stats, LCD_H_RES, LCD_V_RES) == ESP_OK;
+}
+
+void ek79007_lcd::tile_diff_end()
+{
+    if (!fb_writable()) {
+        return;
+    }
+    _tile_diff.end();
+}
+
+void ek79007_lcd::cache_batch_begin()
+{
+    // 之后的 CPU 绘制只记录脏缓存行，到 cache_batch_end() 或下一次 DMA 前合并写回
+    _blit.batch_begin();
+}
+
+void ek79007_lcd::cache_batch_end()
+{
+    _blit.batch_end();
+}
+
+void ek79007_lcd::blit_rect(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                            uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    if (!fb_writable()) {
+        return;
+    }
+    lcd_blit_desc_t desc = {
+        .src = src,
+        .src_stride = src_stride,
+        .src_x = src_x,
+        .src_y = src_y,
+        .x = x,
+        .y = y,
+        .w = w,
+        .h = h,
+    };
+    blit_batch(&desc, 1);
+}
+
+void ek79007_lcd::blit_batch(const lcd_blit_desc_t *descs, size_t num)
+{
+    if (!fb_writable()) {
+        return;
+    }
+    for (size_t i = 0; i < num; i++) {
+        _stats.draw_calls++;
+        _stats.draw_pixels += (uint32_t)descs[i].w * descs[i].h;
+        _tile_diff.invalidate(descs[i].x, descs[i].y, descs[i].x + descs[i].w, descs[i].y + descs[i].h);
+    }
+    _blit.blit_batch(descs, num);
+}
+
+bool ek79007_lcd::dlist_begin(size_t capacity)
+{
+    return _dlist.begin(&_blit, &_stats, capacity) == ESP_OK;
+}
+
+bool ek79007_lcd::dlist_fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    _tile_diff.invalidate(x, y, x + w, y + h);
+    return _dlist.fill(x, y, w, h, color);
+}
+
+bool ek79007_lcd::dlist_blit(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                             uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    _tile_diff.invalidate(x, y, x + w, y + h);
+    return _dlist.blit(src, src_stride, src_x, src_y, x, y, w, h);
+}
+
+bool ek79007_lcd::dlist_blend(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                              uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t alpha)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    _tile_diff.invalidate(x, y, x + w, y + h);
+    return _dlist.blend(src, src_stride, src_x, src_y, x, y, w, h, alpha);
+}
+
+bool ek79007_lcd::dlist_copy(uint16_t src_x, uint16_t src_y, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    if (!fb_writable()) {
+        return false;
+    }
+    _tile_diff.invalidate(x, y, x + w, y + h);
+    return _dlist.copy(src_x, src_y, x, y, w, h);
+}
+
+void ek79007_lcd::dlist_execute()
+{
+    if (!fb_writable()) {
+        return;
+    }
+    _dlist.execute();
+}
+
+bool ek79007_lcd::pipeline_begin(BaseType_t flush_core)
+{
+    if (_submit.started()) {
+        ESP_LOGE(TAG, "submit queue and pipeline cannot be used together");
+        return false;
+    }
+    return _pipeline.begin(pipeline_flush, this, flush_core) == ESP_OK;
+}
+
+bool ek79007_lcd::pipeline_submit(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data,
+                                  TickType_t timeout)
+{
+    lcd_frame_t frame = {
+        .x_start = x_start,
+        .y_start = y_start,
+        .x_end = x_end,
+        .y_end = y_end,
+        .color_data = color_data,
+        .user_data = NULL,
+    };
+    return _pipeline.submit(&frame, timeout);
+}
+
+void ek79007_lcd::pipeline_set_post_process(lcd_frame_cb_t cb, void *user_ctx)
+{
+    _pipeline.set_post_process(cb, user_ctx);
+}
+
+void ek79007_lcd::pipeline_set_done_callback(lcd_frame_cb_t cb, void *user_ctx)
+{
+    _pipeline.set_done_callback(cb, user_ctx);
+}
+
+void ek79007_lcd::pipeline_parallel_for(uint32_t tiles, lcd_tile_fn_t fn, void *arg)
+{
+    _pipeline.parallel_for(tiles, fn, arg);
+}
+
+bool ek79007_lcd::submit_begin(BaseType_t flush_core)
+{
+    // 和渲染流水线共用刷新函数；两者只能用其一，否则又有两个任务同时画面板
+    if (_pipeline.started()) {
+        ESP_LOGE(TAG, "submit queue and pipeline cannot be used together");
+        return false;
+    }
+    return _submit.begin(pipeline_flush, this, &_stats, flush_core) == ESP_OK;
+}
+
+int ek79007_lcd::submit_add_producer(uint8_t z, lcd_frame_cb_t done_cb, void *user_ctx)
+{
+    return _submit.add_producer(z, done_cb, user_ctx);
+}
+
+bool ek79007_lcd::submit(int producer, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data,
+                         TickType_t timeout)
+{
+    lcd_frame_t frame = {
+        .x_start = x_start,
+        .y_start = y_start,
+        .x_end = x_end,
+        .y_end = y_end,
+        .color_data = color_data,
+        .user_data = NULL,
+    };
+    return _submit.submit(producer, &frame, timeout);
+}
+
+bool ek79007_lcd::fb_writable()
+{
+    // 流水线或提交队列启动后帧缓冲归刷新任务：pipeline_flush 在刷新核上不加锁地改统计、瓦片记录和
+    // lcd_blit 的脏范围，别的任务再直接画就会和它同时改；刷新任务里的后处理和完成回调仍可直接画
+    if ((_pipeline.started() && !_pipeline.in_flush_task()) || (_submit.started() && !_submit.in_flush_task())) {
+        ESP_LOGW(TAG, "frame buffer owned by the flush task, submit the frame instead");
+        return false;
+    }
+    return true;
+}
+
+void ek79007_lcd::pipeline_flush(lcd_frame_t *frame, void *user_ctx)
+{
+    ek79007_lcd *self = (ek79007_lcd *)user_ctx;
+
+    // 在刷新核上执行；等 DMA 搬运完成后再释放队列槽位，渲染端才能复用该缓冲区
+    self->lcd_draw_bitmap(frame->x_start, frame->y_start, frame->x_end, frame->y_end, frame->color_data);
+    self->_events.wait_idle();
+}
+
+void ek79007_lcd::get_stats(lcd_stats_t *stats)
+{
+    *stats = _stats;
+}
+
+void ek79007_lcd::reset_stats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void ek79007_lcd::set_fast_boot(const lcd_boot_delays_t *delays)
+{
+    // 需在 begin() 之前调用；传 NULL 恢复驱动默认延时
+    if (delays) {
+        _boot_delays = *delays;
+    } else {
+        _boot_delays = LCD_BOOT_DELAYS_DEFAULT();
+    }
+}
+
+const lcd_boot_timeline_t *ek79007_lcd::boot_timeline()
+{
+    return &_boot;
+}
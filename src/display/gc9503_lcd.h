@@ -1,12 +1,37 @@
 #ifndef _GC9503_LCD_H
 #define _GC9503_LCD_H
 #include <stdio.h>
+#include "esp_lcd_mipi_dsi.h"
+#include "esp_ldo_regulator.h"
+#include "lcd_events.h"
+#include "lcd_band.h"
+#include "lcd_stats.h"
+#include "lcd_tile_diff.h"
+#include "lcd_blit.h"
+#include "lcd_display_list.h"
+#include "lcd_pipeline.h"
+#include "lcd_submit.h"
+#include "lcd_splash.h"
+#include "lcd_assets.h"
+#include "lcd_q565.h"
+#include "lcd_font.h"
+#include "lcd_screen_cache.h"
+#include "lcd_transition.h"
+#include "lcd_affine.h"
+#include "lcd_render_scale.h"
+#include "lcd_dither.h"
+#include "lcd_color_lut.h"
+#include "lcd_indexed.h"
+#include "lcd_surface.h"
+#include "lcd_async.h"
+#include "lcd_boot.h"
 
 class gc9503_lcd
 {
 public:
     gc9503_lcd(int8_t lcd_rst);
 
+    void set_splash(const char *partition_label);
     void begin();
     void example_bsp_enable_dsi_phy_power();
     void example_bsp_init_lcd_backlight();
@@ -17,10 +42,188 @@ public:
     void fillScreen(uint16_t color);
     void te_on();
     void te_off();
+    bool suspend();
+    bool resume();
+    bool suspended();
+    bool show_splash(const char *partition_label);
+
+    bool assets_begin(const char *partition_label);
+    const lcd_asset_t *find_asset(const char *name);
+    bool draw_asset(const char *name, uint16_t x, uint16_t y);
+    bool draw_asset(const lcd_asset_t *asset, uint16_t x, uint16_t y);
+    bool draw_q565(const void *data, size_t size, int16_t x, int16_t y);
+    bool draw_q565(const void *data, size_t size, int16_t x, int16_t y,
+                   uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h);
+    bool font_begin(const void *data, size_t size);
+    bool draw_text(int16_t x, int16_t y, const char *text, uint16_t color);
+    bool draw_text(int16_t x, int16_t y, const char *text, uint16_t color,
+                   uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h);
+    int32_t text_width(const char *text);
+    bool draw_affine(const lcd_affine_image_t *img, const lcd_affine_xform_t *xf);
+    bool draw_affine(const lcd_affine_image_t *img, const lcd_affine_xform_t *xf,
+                     uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h);
+    bool draw_rgb888(uint16_t x, uint16_t y, uint16_t w, uint16_t h, const uint8_t *rgb, uint32_t stride = 0);
+    bool draw_indexed(lcd_indexed *surface, uint16_t x, uint16_t y);
+    bool draw_indexed(lcd_indexed *surface, uint16_t src_x, uint16_t src_y, uint16_t x, uint16_t y,
+                      uint16_t w, uint16_t h);
+    template <class F>
+    bool draw_surface(const lcd_surface<F> &src, uint16_t x, uint16_t y);
+    template <lcd_surface_rotation_t R>
+    bool draw_surface_rotated(const lcd_surface<lcd_format_rgb565> &src, uint16_t x, uint16_t y);
+
+    bool screen_cache_begin(uint8_t slots = 2);
+    bool screen_store(uint32_t id);
+    bool screen_restore(uint32_t id);
+    void screen_invalidate(uint32_t id);
+    bool transition(const uint16_t *from, const uint16_t *to, lcd_transition_type_t type,
+                    uint32_t duration_ms = 300);
+    bool screen_transition(uint32_t from_id, uint32_t to_id, lcd_transition_type_t type,
+                           uint32_t duration_ms = 300);
     uint16_t width();
     uint16_t height();
+    esp_lcd_panel_handle_t get_panel_handle();
+    esp_lcd_panel_io_handle_t get_io_handle();
+
+    bool set_color_lut(const uint8_t r[32], const uint8_t g[64], const uint8_t b[32]);
+    bool set_color_gamma(float r, float g, float b);
+    void clear_color_lut();
+
+    bool set_render_scale(uint8_t level);
+    uint8_t render_scale();
+    void set_render_scale_filter(lcd_render_scale_filter_t filter);
+    void set_render_scale_budget(uint32_t frame_budget_us);
+    bool render_scale_update(uint32_t frame_us);
+    uint16_t render_width();
+    uint16_t render_height();
+
+    bool set_executor(lcd_executor *executor);
+    lcd_async_op blit_async(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end,
+                            const uint16_t *color_data);
+    lcd_async_op vsync();
+
+    bool band_begin(uint16_t band_lines, uint8_t band_num = 2);
+    uint16_t *band_buffer(uint8_t index);
+    uint16_t *band_acquire();
+    bool band_flush(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *band);
+    void band_set_done_callback(lcd_band_done_cb_t cb, void *user_ctx);
+    uint16_t band_lines();
+
+    bool tile_diff_begin();
+    void tile_diff_end();
+
+    void cache_batch_begin();
+    void cache_batch_end();
+
+    void blit_rect(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                   uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void blit_batch(const lcd_blit_desc_t *descs, size_t num);
+
+    bool dlist_begin(size_t capacity = 256);
+    bool dlist_fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+    bool dlist_blit(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                    uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    bool dlist_blend(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                     uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t alpha);
+    bool dlist_copy(uint16_t src_x, uint16_t src_y, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void dlist_execute();
+
+    // 流水线或提交队列启动后只有刷新任务能画帧缓冲，其他任务的直接绘制会被拒绝
+    bool pipeline_begin(BaseType_t flush_core = 1);
+    bool pipeline_submit(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data,
+                         TickType_t timeout = portMAX_DELAY);
+    void pipeline_set_post_process(lcd_frame_cb_t cb, void *user_ctx);
+    void pipeline_set_done_callback(lcd_frame_cb_t cb, void *user_ctx);
+    void pipeline_parallel_for(uint32_t tiles, lcd_tile_fn_t fn, void *arg);
+
+    bool submit_begin(BaseType_t flush_core = 1);
+    int submit_add_producer(uint8_t z, lcd_frame_cb_t done_cb = NULL, void *user_ctx = NULL);
+    bool submit(int producer, uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *color_data,
+                TickType_t timeout = portMAX_DELAY);
+
+    void get_stats(lcd_stats_t *stats);
+    void reset_stats();
+
+    void set_fast_boot(const lcd_boot_delays_t *delays);
+    const lcd_boot_timeline_t *boot_timeline();
 
 private:
+    typedef struct {
+        gc9503_lcd *self;
+        uint16_t x_start;
+        uint16_t y_start;
+        uint16_t x_end;
+        uint16_t y_end;
+        const uint16_t *color_data;
+    } blit_args_t;
+
+    static void pipeline_flush(lcd_frame_t *frame, void *user_ctx);
+    bool fb_writable();
+    static esp_err_t blit_start(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx);
+    static esp_err_t vsync_start(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx);
+    static bool on_vsync(void *user_ctx);
+    bool run_transition(const uint16_t *from, const uint16_t *to, lcd_transition_type_t type, uint32_t duration_ms,
+                        bool corrected);
+    lcd_surface<lcd_format_rgb565> fb_begin(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void fb_end(const lcd_surface<lcd_format_rgb565> &area, uint16_t x, uint16_t y);
+
     int8_t _lcd_rst;
+    esp_ldo_channel_handle_t _ldo_mipi_phy;
+    esp_lcd_dsi_bus_handle_t _mipi_dsi_bus;
+    esp_lcd_panel_handle_t _panel_handle;
+    esp_lcd_panel_io_handle_t _io_handle;
+    lcd_events _events;
+    lcd_band _band;
+    lcd_tile_diff _tile_diff;
+    lcd_blit _blit;
+    lcd_display_list _dlist;
+    lcd_pipeline _pipeline;
+    lcd_submit _submit;
+    lcd_asset_pack _assets;
+    lcd_font _font;
+    lcd_screen_cache _screens;
+    lcd_transition _transition;
+    lcd_render_scale _render_scale;
+    lcd_color_lut _color_lut;
+    lcd_executor *_executor;
+    lcd_async_waiters _vsync_waiters;
+    lcd_stats_t _stats;
+    lcd_boot_timeline_t _boot;
+    lcd_boot_delays_t _boot_delays;
+    bool _suspended;
+    const char *_splash_label;
 };
+
+template <class F>
+bool gc9503_lcd::draw_surface(const lcd_surface<F> &src, uint16_t x, uint16_t y)
+{
+    if (x >= width() || y >= height()) {
+        return true;
+    }
+    lcd_surface<lcd_format_rgb565> dst = fb_begin(x, y, src.width(), src.height());
+    if (dst.empty()) {
+        return false;
+    }
+    // 源格式在编译期确定，RGB565 源就是逐行拷贝
+    lcd_surface_convert(dst, src);
+    fb_end(dst, x, y);
+    return true;
+}
+
+template <lcd_surface_rotation_t R>
+bool gc9503_lcd::draw_surface_rotated(const lcd_surface<lcd_format_rgb565> &src, uint16_t x, uint16_t y)
+{
+    // 旋转后的矩形必须整个在屏幕内
+    uint16_t w = R == LCD_SURFACE_ROTATE_180 ? src.width() : src.height();
+    uint16_t h = R == LCD_SURFACE_ROTATE_180 ? src.height() : src.width();
+    if (x + w > width() || y + h > height()) {
+        return false;
+    }
+    lcd_surface<lcd_format_rgb565> dst = fb_begin(x, y, w, h);
+    if (dst.empty()) {
+        return false;
+    }
+    lcd_surface_rotate<R>(dst, src);
+    fb_end(dst, x, y);
+    return true;
+}
 #endif
\ No newline at end of file
@@ -0,0 +1,280 @@
+#include <math.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_affine.h"
+
+static const char *TAG = "lcd_affine";
+
+#define RGB565_SPREAD_MASK 0x07E0F81F     // G 移到高半字，三个分量之间留出保护位，一次乘法同时算三个通道
+#define LCD_AFFINE_MAX_SIZE 32767         // 16.16 坐标在 int32 内不溢出
+
+static inline uint32_t spread565(uint16_t c)
+{
+    return (c | ((uint32_t)c << 16)) & RGB565_SPREAD_MASK;
+}
+
+static inline uint16_t pack565(uint32_t c)
+{
+    return (uint16_t)(c | (c >> 16));
+}
+
+// 两个展开后的 RGB565 按 0~32 的权重插值
+static inline uint32_t lerp565(uint32_t a, uint32_t b, uint32_t f)
+{
+    return ((a * (32 - f) + b * f) >> 5) & RGB565_SPREAD_MASK;
+}
+
+// 两个 ARGB8888 按 0~256 的权重插值：A/G 和 R/B 各用一次乘法
+static inline uint32_t lerp8888(uint32_t a, uint32_t b, uint32_t f)
+{
+    uint32_t rb = (((a & 0x00FF00FF) * (256 - f) + (b & 0x00FF00FF) * f) >> 8) & 0x00FF00FF;
+    uint32_t ag = (((a >> 8) & 0x00FF00FF) * (256 - f) + ((b >> 8) & 0x00FF00FF) * f) & 0xFF00FF00;
+    return rb | ag;
+}
+
+template <bool LUT>
+static inline void blend8888(uint16_t *dst, uint32_t p, const lcd_color_lut_table_t *lut)
+{
+    uint32_t a = p >> 24;
+    uint16_t c = ((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F);
+
+    if (a == 0) {
+        return;
+    }
+    // 先校正源颜色再混合，目标里已校正过的背景不会被再查一次表
+    if (LUT) {
+        c = lcd_color_lut_lookup(lut, c);
+    }
+    if (a == 255) {
+        *dst = c;
+        return;
+    }
+    *dst = pack565(lerp565(spread565(*dst), spread565(c), (a + 4) >> 3));
+}
+
+static inline int64_t floor_div(int64_t n, int64_t d)
+{
+    int64_t q = n / d;
+    if ((n % d) != 0 && ((n < 0) != (d < 0))) {
+        q--;
+    }
+    return q;
+}
+
+// 把 [x0, x1) 收窄到满足 lo <= a + d * x < hi 的整数 x
+static void solve_span(int64_t a, int64_t d, int64_t lo, int64_t hi, int32_t *x0, int32_t *x1)
+{
+    int64_t from, to;
+
+    if (d == 0) {
+        if (a < lo || a >= hi) {
+            *x1 = *x0;
+        }
+        return;
+    }
+    if (d > 0) {
+        from = -floor_div(a - lo, d);
+        to = -floor_div(a - hi, d);
+    } else {
+        from = floor_div(hi - a, d) + 1;
+        to = floor_div(lo - a, d) + 1;
+    }
+    if (from > *x0) {
+        *x0 = from > *x1 ? *x1 : (int32_t)from;
+    }
+    if (to < *x1) {
+        *x1 = to < *x0 ? *x0 : (int32_t)to;
+    }
+}
+
+template <bool BILINEAR, bool LUT>
+static void span_rgb565(uint16_t *dst, const lcd_affine_image_t *img, int32_t u, int32_t v, int32_t du, int32_t dv,
+                        int32_t n, const lcd_color_lut_table_t *lut)
+{
+    const uint16_t *src = (const uint16_t *)img->pixels;
+    uint32_t stride = img->stride;
+
+    for (int32_t i = 0; i < n; i++, u += du, v += dv) {
+        if (!BILINEAR) {
+            uint16_t c = src[(uint32_t)(v >> 16) * stride + (uint32_t)(u >> 16)];
+            dst[i] = LUT ? lcd_color_lut_lookup(lut, c) : c;
+            continue;
+        }
+        // 采样点移到像素中心，相邻像素在边缘处夹住
+        int32_t ub = u - 0x8000;
+        int32_t vb = v - 0x8000;
+        int32_t ix = ub >> 16;
+        int32_t iy = vb >> 16;
+        uint32_t fx = (ub >> 11) & 31;
+        uint32_t fy = (vb >> 11) & 31;
+        uint32_t x0 = ix < 0 ? 0 : ix;
+        uint32_t y0 = iy < 0 ? 0 : iy;
+        uint32_t x1 = ix + 1 < img->width ? ix + 1 : img->width - 1;
+        uint32_t y1 = iy + 1 < img->height ? iy + 1 : img->height - 1;
+        const uint16_t *r0 = src + y0 * stride;
+        const uint16_t *r1 = src + y1 * stride;
+        uint32_t top = lerp565(spread565(r0[x0]), spread565(r0[x1]), fx);
+        uint32_t bottom = lerp565(spread565(r1[x0]), spread565(r1[x1]), fx);
+        uint16_t c = pack565(lerp565(top, bottom, fy));
+        dst[i] = LUT ? lcd_color_lut_lookup(lut, c) : c;
+    }
+}
+
+template <bool BILINEAR, bool LUT>
+static void span_argb8888(uint16_t *dst, const lcd_affine_image_t *img, int32_t u, int32_t v, int32_t du, int32_t dv,
+                          int32_t n, const lcd_color_lut_table_t *lut)
+{
+    const uint32_t *src = (const uint32_t *)img->pixels;
+    uint32_t stride = img->stride;
+
+    for (int32_t i = 0; i < n; i++, u += du, v += dv) {
+        if (!BILINEAR) {
+            blend8888<LUT>(&dst[i], src[(uint32_t)(v >> 16) * stride + (uint32_t)(u >> 16)], lut);
+            continue;
+        }
+        int32_t ub = u - 0x8000;
+        int32_t vb = v - 0x8000;
+        int32_t ix = ub >> 16;
+        int32_t iy = vb >> 16;
+        uint32_t fx = (ub >> 8) & 0xFF;
+        uint32_t fy = (vb >> 8) & 0xFF;
+        uint32_t x0 = ix < 0 ? 0 : ix;
+        uint32_t y0 = iy < 0 ? 0 : iy;
+        uint32_t x1 = ix + 1 < img->width ? ix + 1 : img->width - 1;
+        uint32_t y1 = iy + 1 < img->height ? iy + 1 : img->height - 1;
+        const uint32_t *r0 = src + y0 * stride;
+        const uint32_t *r1 = src + y1 * stride;
+        uint32_t top = lerp8888(r0[x0], r0[x1], fx);
+        uint32_t bottom = lerp8888(r1[x0], r1[x1], fx);
+        blend8888<LUT>(&dst[i], lerp8888(top, bottom, fy), lut);
+    }
+}
+
+typedef void (*span_fn_t)(uint16_t *dst, const lcd_affine_image_t *img, int32_t u, int32_t v, int32_t du, int32_t dv,
+                          int32_t n, const lcd_color_lut_table_t *lut);
+
+// 按格式、滤波和是否查表选内层循环，循环里不再判断
+static const span_fn_t s_spans[2][2][2] = {
+    {{span_rgb565<false, false>, span_rgb565<false, true>}, {span_rgb565<true, false>, span_rgb565<true, true>}},
+    {{span_argb8888<false, false>, span_argb8888<false, true>}, {span_argb8888<true, false>, span_argb8888<true, true>}},
+};
+
+esp_err_t lcd_affine_draw(uint16_t *dst, uint32_t dst_stride, uint16_t dst_w, uint16_t dst_h,
+                          const lcd_affine_image_t *img, const lcd_affine_xform_t *xf, uint16_t clip_x, uint16_t clip_y,
+                          uint16_t clip_w, uint16_t clip_h, uint16_t bounds[4], lcd_stats_t *stats,
+                          const lcd_color_lut_table_t *lut)
+{
+    if (bounds) {
+        memset(bounds, 0, 4 * sizeof(uint16_t));
+    }
+    ESP_RETURN_ON_FALSE(dst && img && img->pixels && xf, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(img->width && img->height && img->width <= LCD_AFFINE_MAX_SIZE &&
+                        img->height <= LCD_AFFINE_MAX_SIZE && img->stride >= img->width,
+                        ESP_ERR_INVALID_SIZE, TAG, "invalid source size");
+    ESP_RETURN_ON_FALSE(img->format <= LCD_AFFINE_ARGB8888, ESP_ERR_NOT_SUPPORTED, TAG, "unknown source format");
+    ESP_RETURN_ON_FALSE(fabsf(xf->scale_x) >= 1.0f / 256 && fabsf(xf->scale_y) >= 1.0f / 256 &&
+                        fabsf(xf->scale_x) <= 256 && fabsf(xf->scale_y) <= 256,
+                        ESP_ERR_INVALID_ARG, TAG, "scale out of range");
+
+    int64_t start = esp_timer_get_time();
+    float rad = xf->angle * (float)M_PI / 180.0f;
+    float c = cosf(rad);
+    float s = sinf(rad);
+
+    // 源图四个角正变换到屏幕，求外接矩形，再与裁剪区、目标取交集
+    float fx[4] = {0, (float)img->width, 0, (float)img->width};
+    float fy[4] = {0, 0, (float)img->height, (float)img->height};
+    float min_x = 1e9f, min_y = 1e9f, max_x = -1e9f, max_y = -1e9f;
+    for (int i = 0; i < 4; i++) {
+        float dx = (fx[i] - xf->pivot_x) * xf->scale_x;
+        float dy = (fy[i] - xf->pivot_y) * xf->scale_y;
+        float X = xf->x + c * dx - s * dy;
+        float Y = xf->y + s * dx + c * dy;
+        min_x = X < min_x ? X : min_x;
+        max_x = X > max_x ? X : max_x;
+        min_y = Y < min_y ? Y : min_y;
+        max_y = Y > max_y ? Y : max_y;
+    }
+    int32_t cx1 = (int32_t)clip_x + clip_w < dst_w ? (int32_t)clip_x + clip_w : dst_w;
+    int32_t cy1 = (int32_t)clip_y + clip_h < dst_h ? (int32_t)clip_y + clip_h : dst_h;
+    int32_t bx0 = min_x > clip_x ? (int32_t)floorf(min_x) : clip_x;
+    int32_t by0 = min_y > clip_y ? (int32_t)floorf(min_y) : clip_y;
+    int32_t bx1 = max_x < cx1 ? (int32_t)ceilf(max_x) : cx1;
+    int32_t by1 = max_y < cy1 ? (int32_t)ceilf(max_y) : cy1;
+    if (bx0 >= bx1 || by0 >= by1) {
+        return ESP_OK;
+    }
+
+    // 逆变换：屏幕像素中心映射回源图，16.16 定点；只在这里用一次浮点
+    int32_t du_dx = (int32_t)lrintf(c / xf->scale_x * 65536.0f);
+    int32_t dv_dx = (int32_t)lrintf(-s / xf->scale_y * 65536.0f);
+    int32_t du_dy = (int32_t)lrintf(s / xf->scale_x * 65536.0f);
+    int32_t dv_dy = (int32_t)lrintf(c / xf->scale_y * 65536.0f);
+    float ox = bx0 + 0.5f - xf->x;
+    float oy = by0 + 0.5f - xf->y;
+    int64_t u_base = (int64_t)llrintf((xf->pivot_x + (c * ox + s * oy) / xf->scale_x) * 65536.0f);
+    int64_t v_base = (int64_t)llrintf((xf->pivot_y + (-s * ox + c * oy) / xf->scale_y) * 65536.0f);
+    int64_t u_hi = (int64_t)img->width << 16;
+    int64_t v_hi = (int64_t)img->height << 16;
+
+    span_fn_t span = s_spans[img->format == LCD_AFFINE_ARGB8888][xf->bilinear][lut != NULL];
+
+    int32_t tx0 = INT32_MAX, ty0 = INT32_MAX, tx1 = INT32_MIN, ty1 = INT32_MIN;
+    uint32_t pixels = 0;
+    int32_t row_x0[LCD_AFFINE_TILE];
+    int32_t row_x1[LCD_AFFINE_TILE];
+    int64_t row_u[LCD_AFFINE_TILE];
+    int64_t row_v[LCD_AFFINE_TILE];
+
+    for (int32_t band = by0; band < by1; band += LCD_AFFINE_TILE) {
+        int32_t rows = by1 - band < LCD_AFFINE_TILE ? by1 - band : LCD_AFFINE_TILE;
+
+        // 先解出这一条带每行落在源图内的区间，坐标都是精确的整数步进，内层循环不再检查越界
+        for (int32_t r = 0; r < rows; r++) {
+            int32_t dy = band + r - by0;
+            row_u[r] = u_base + (int64_t)du_dy * dy;
+            row_v[r] = v_base + (int64_t)dv_dy * dy;
+            row_x0[r] = 0;
+            row_x1[r] = bx1 - bx0;
+            solve_span(row_u[r], du_dx, 0, u_hi, &row_x0[r], &row_x1[r]);
+            solve_span(row_v[r], dv_dx, 0, v_hi, &row_x0[r], &row_x1[r]);
+            if (row_x0[r] < row_x1[r]) {
+                ty0 = band + r < ty0 ? band + r : ty0;
+                ty1 = band + r + 1;
+                tx0 = bx0 + row_x0[r] < tx0 ? bx0 + row_x0[r] : tx0;
+                tx1 = bx0 + row_x1[r] > tx1 ? bx0 + row_x1[r] : tx1;
+            }
+        }
+
+        // 再按列分块，一块目标只读源图中对应的一小片
+        for (int32_t tile = 0; tile < bx1 - bx0; tile += LCD_AFFINE_TILE) {
+            for (int32_t r = 0; r < rows; r++) {
+                int32_t a = row_x0[r] > tile ? row_x0[r] : tile;
+                int32_t b = row_x1[r] < tile + LCD_AFFINE_TILE ? row_x1[r] : tile + LCD_AFFINE_TILE;
+                if (a >= b) {
+                    continue;
+                }
+                uint16_t *out = dst + (uint32_t)(band + r) * dst_stride + bx0 + a;
+                span(out, img, (int32_t)(row_u[r] + (int64_t)du_dx * a), (int32_t)(row_v[r] + (int64_t)dv_dx * a),
+                     du_dx, dv_dx, b - a, lut);
+                pixels += b - a;
+            }
+        }
+    }
+
+    if (bounds && pixels) {
+        bounds[0] = tx0;
+        bounds[1] = ty0;
+        bounds[2] = tx1 - tx0;
+        bounds[3] = ty1 - ty0;
+    }
+    if (stats) {
+        stats->affine_pixels += pixels;
+        stats->affine_us += esp_timer_get_time() - start;
+    }
+    return ESP_OK;
+}
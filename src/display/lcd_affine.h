@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "lcd_stats.h"
+#include "lcd_color_lut.h"
+
+#define LCD_AFFINE_TILE 32 // 目标按 32x32 分块绘制，旋转后读源图的范围也局限在一小块里，缓存命中高
+
+/**
+ * @brief Pixel formats an affine source can have
+ */
+typedef enum {
+    LCD_AFFINE_RGB565 = 0,   /*!< Opaque little-endian RGB565 */
+    LCD_AFFINE_ARGB8888,     /*!< 0xAARRGGBB per pixel, blended over the destination */
+} lcd_affine_format_t;
+
+/**
+ * @brief Source image of an affine draw
+ */
+typedef struct {
+    const void *pixels;      /*!< Top-left pixel */
+    uint32_t stride;         /*!< Row length in pixels */
+    uint16_t width;
+    uint16_t height;
+    uint8_t format;          /*!< lcd_affine_format_t */
+} lcd_affine_image_t;
+
+/**
+ * @brief Rotation and scale about a pivot; the pivot of the source lands on (x, y)
+ */
+typedef struct {
+    float angle;             /*!< Clockwise rotation in degrees */
+    float scale_x;           /*!< Horizontal scale, 1.0 is unscaled */
+    float scale_y;           /*!< Vertical scale */
+    float pivot_x;           /*!< Pivot in source pixels, e.g. the needle's hub */
+    float pivot_y;
+    int32_t x;               /*!< Destination of the pivot */
+    int32_t y;
+    bool bilinear;           /*!< Bilinear filtering instead of nearest neighbour */
+} lcd_affine_xform_t;
+
+/**
+ * @brief Draw a rotated and scaled image into an RGB565 buffer
+ *
+ * Every destination pixel is mapped back into the source with 16.16 fixed-point steps along the
+ * scanline. The span of each scanline that lands inside the source is solved exactly up front, so
+ * the inner loops do no bounds checks; destination rows are also clipped to the clip rectangle.
+ *
+ * @param bounds Optional, receives the touched rectangle as x, y, w, h; w is 0 if nothing was drawn
+ * @param stats Optional, receives the pixel count and draw time
+ * @param lut Optional, colour correction applied to every source sample before it is stored or blended
+ */
+esp_err_t lcd_affine_draw(uint16_t *dst, uint32_t dst_stride, uint16_t dst_w, uint16_t dst_h,
+                          const lcd_affine_image_t *img, const lcd_affine_xform_t *xf, uint16_t clip_x, uint16_t clip_y,
+                          uint16_t clip_w, uint16_t clip_h, uint16_t bounds[4], lcd_stats_t *stats,
+                          const lcd_color_lut_table_t *lut = NULL);
@@ -0,0 +1,158 @@
+#include <string.h>
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_assets.h"
+
+static const char *TAG = "lcd_assets";
+
+// 条目里的偏移来自 flash，可能损坏：名字必须在包内以 NUL 结尾，未压缩的像素必须整块落在包内
+static bool entry_valid(const uint8_t *base, const lcd_assets_header_t *header, const lcd_asset_t *asset)
+{
+    if (asset->name_offset < header->names_offset || asset->name_offset >= header->size ||
+        !memchr(base + asset->name_offset, '\0', header->size - asset->name_offset)) {
+        return false;
+    }
+    if (asset->data_offset > header->size) {
+        return false;
+    }
+    switch (asset->format) {
+    case LCD_ASSET_FORMAT_RGB565:
+    case LCD_ASSET_FORMAT_RGB565_SWAPPED:
+        return (uint64_t)asset->width * asset->height * sizeof(uint16_t) <= header->size - asset->data_offset;
+    case LCD_ASSET_FORMAT_Q565:
+        return asset->data_offset < header->size;
+    default:
+        return false;
+    }
+}
+
+lcd_asset_pack::lcd_asset_pack()
+{
+    _base = NULL;
+    _header = NULL;
+    _seeds = NULL;
+    _entries = NULL;
+    _mmap_handle = 0;
+}
+
+lcd_asset_pack::~lcd_asset_pack()
+{
+    end();
+}
+
+esp_err_t lcd_asset_pack::begin(const char *partition_label)
+{
+    ESP_RETURN_ON_FALSE(partition_label, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(!_base, ESP_ERR_INVALID_STATE, TAG, "already started");
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, partition_label);
+    ESP_RETURN_ON_FALSE(part, ESP_ERR_NOT_FOUND, TAG, "no partition \"%s\"", partition_label);
+
+    // 先读头部确定包的实际大小，只映射这部分
+    lcd_assets_header_t header;
+    ESP_RETURN_ON_ERROR(esp_partition_read(part, 0, &header, sizeof(header)), TAG, "read header failed");
+    ESP_RETURN_ON_FALSE(header.magic == LCD_ASSETS_MAGIC && header.version == LCD_ASSETS_VERSION, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "not an asset pack");
+    ESP_RETURN_ON_FALSE(header.size <= part->size && header.buckets &&
+                        (uint64_t)header.seeds_offset + (uint64_t)header.buckets * sizeof(int32_t) <= header.size &&
+                        (uint64_t)header.entries_offset + (uint64_t)header.count * sizeof(lcd_asset_t) <= header.size &&
+                        header.names_offset <= header.size,
+                        ESP_ERR_INVALID_SIZE, TAG, "corrupt asset pack");
+
+    const void *mapped = NULL;
+    ESP_RETURN_ON_ERROR(esp_partition_mmap(part, 0, header.size, ESP_PARTITION_MMAP_DATA, &mapped, &_mmap_handle), TAG,
+                        "mmap failed");
+    _base = (const uint8_t *)mapped;
+    _header = (const lcd_assets_header_t *)_base;
+    _seeds = (const int32_t *)(_base + header.seeds_offset);
+    _entries = (const lcd_asset_t *)(_base + header.entries_offset);
+
+    // 一次性检查所有条目，之后 find()/name()/pixels()/data_size() 都可以直接信任偏移
+    for (uint16_t i = 0; i < header.count; i++) {
+        if (!entry_valid(_base, &header, &_entries[i])) {
+            ESP_LOGE(TAG, "corrupt asset entry %u", i);
+            end();
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+    ESP_LOGI(TAG, "%u asset(s), %u bytes", header.count, (unsigned)header.size);
+    return ESP_OK;
+}
+
+void lcd_asset_pack::end()
+{
+    if (_base) {
+        esp_partition_munmap(_mmap_handle);
+    }
+    _base = NULL;
+    _header = NULL;
+    _seeds = NULL;
+    _entries = NULL;
+}
+
+bool lcd_asset_pack::started()
+{
+    return _base != NULL;
+}
+
+uint32_t lcd_asset_pack::hash(const char *name, uint32_t seed)
+{
+    // 带种子的 FNV-1a，与 tools/asset_pack.py 中的实现保持一致
+    uint32_t h = 2166136261u ^ seed;
+    while (*name) {
+        h = (h ^ (uint8_t)*name++) * 16777619u;
+    }
+    return h;
+}
+
+const lcd_asset_t *lcd_asset_pack::find(const char *name)
+{
+    if (!_base || !name || !_header->count) {
+        return NULL;
+    }
+
+    // 负的位移直接给出槽位（只有一个键的桶），否则用位移作种子再哈希一次
+    int32_t d = _seeds[hash(name, 0) % _header->buckets];
+    uint32_t slot = (d < 0) ? (uint32_t)(-d - 1) : hash(name, (uint32_t)d) % _header->count;
+    if (slot >= _header->count) {
+        return NULL;
+    }
+
+    // 完美哈希只对打包时的名字成立，未知名字必须靠比较排除
+    const lcd_asset_t *asset = &_entries[slot];
+    return strcmp(this->name(asset), name) == 0 ? asset : NULL;
+}
+
+const lcd_asset_t *lcd_asset_pack::at(uint16_t index)
+{
+    if (!_base || index >= _header->count) {
+        return NULL;
+    }
+    return &_entries[index];
+}
+
+uint16_t lcd_asset_pack::count()
+{
+    return _base ? _header->count : 0;
+}
+
+const char *lcd_asset_pack::name(const lcd_asset_t *asset)
+{
+    return (const char *)(_base + asset->name_offset);
+}
+
+const uint16_t *lcd_asset_pack::pixels(const lcd_asset_t *asset)
+{
+    return (const uint16_t *)(_base + asset->data_offset);
+}
+
+size_t lcd_asset_pack::data_size(const lcd_asset_t *asset)
+{
+    // 压缩数据的确切长度在流头部里，这里给出到包末尾的上限
+    if (asset->format == LCD_ASSET_FORMAT_Q565) {
+        return _header->size - asset->data_offset;
+    }
+    return (size_t)asset->width * asset->height * sizeof(uint16_t);
+}
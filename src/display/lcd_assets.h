@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#define LCD_ASSETS_MAGIC 0x314B5041 // "APK1"，小端
+#define LCD_ASSETS_VERSION 1
+
+/**
+ * @brief Pixel formats of the asset pack; the DPI panels here take LCD_ASSET_FORMAT_RGB565
+ */
+typedef enum {
+    LCD_ASSET_FORMAT_RGB565 = 0,         /*!< Little-endian RGB565, same as the DPI frame buffer */
+    LCD_ASSET_FORMAT_RGB565_SWAPPED = 1, /*!< Big-endian RGB565, for SPI/I80 panels */
+    LCD_ASSET_FORMAT_Q565 = 2,           /*!< Q565 stream (see lcd_q565.h), decoded while drawing */
+} lcd_asset_format_t;
+
+/**
+ * @brief Pack header at offset 0, written by `tools/asset_pack.py`
+ *
+ * The header is followed by the displacement table, the entry table, the name strings and the
+ * pixel data; every offset is relative to the start of the pack.
+ */
+typedef struct {
+    uint32_t magic;         /*!< LCD_ASSETS_MAGIC */
+    uint16_t version;       /*!< LCD_ASSETS_VERSION */
+    uint16_t count;         /*!< Number of assets */
+    uint32_t buckets;       /*!< Size of the displacement table */
+    uint32_t seeds_offset;  /*!< int32_t displacement per bucket */
+    uint32_t entries_offset;/*!< lcd_asset_t per asset, in hash slot order */
+    uint32_t names_offset;  /*!< NUL-terminated names */
+    uint32_t size;          /*!< Total pack size */
+    uint32_t align;         /*!< Alignment of every pixel block */
+} lcd_assets_header_t;
+
+/**
+ * @brief One image of the pack; the pixels are already rotated and converted
+ */
+typedef struct {
+    uint32_t name_offset;   /*!< Name, relative to the start of the pack */
+    uint32_t data_offset;   /*!< Pixels, relative to the start of the pack, `align` aligned */
+    uint16_t width;         /*!< Width as stored, i.e. after rotation */
+    uint16_t height;        /*!< Height as stored */
+    uint8_t format;         /*!< lcd_asset_format_t */
+    uint8_t rotation;       /*!< Pre-rotation applied by the packer, in 90 degree steps clockwise */
+    uint16_t reserved;
+} lcd_asset_t;
+
+static_assert(sizeof(lcd_assets_header_t) == 32, "layout is shared with tools/asset_pack.py");
+static_assert(sizeof(lcd_asset_t) == 16, "layout is shared with tools/asset_pack.py");
+
+/**
+ * @brief Read-only image pack, memory-mapped from a data partition
+ *
+ * Names are looked up through a hash-and-displace perfect hash: one hash picks a bucket, the
+ * bucket's displacement picks the slot, and a single name compare rejects unknown names. The
+ * pixels stay in flash and are handed to the draw path by pointer.
+ */
+class lcd_asset_pack
+{
+public:
+    lcd_asset_pack();
+    ~lcd_asset_pack();
+
+    esp_err_t begin(const char *partition_label);
+    void end();
+    bool started();
+    const lcd_asset_t *find(const char *name);
+    const lcd_asset_t *at(uint16_t index);
+    uint16_t count();
+    const char *name(const lcd_asset_t *asset);
+    const uint16_t *pixels(const lcd_asset_t *asset);
+    size_t data_size(const lcd_asset_t *asset);
+
+    static uint32_t hash(const char *name, uint32_t seed);
+
+private:
+    const uint8_t *_base;
+    const lcd_assets_header_t *_header;
+    const int32_t *_seeds;
+    const lcd_asset_t *_entries;
+    esp_partition_mmap_handle_t _mmap_handle;
+};
@@ -0,0 +1,183 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_band.h"
+
+static const char *TAG = "lcd_band";
+
+lcd_band::lcd_band()
+{
+    _events = NULL;
+    _stats = NULL;
+    memset(_bufs, 0, sizeof(_bufs));
+    memset(_pending, 0, sizeof(_pending));
+    _h_res = 0;
+    _lines = 0;
+    _num = 0;
+    _next = 0;
+    _free_sem = NULL;
+    _done_cb = NULL;
+    _done_ctx = NULL;
+}
+
+lcd_band::~lcd_band()
+{
+    end();
+}
+
+esp_err_t lcd_band::begin(lcd_events *events, lcd_stats_t *stats, uint16_t h_res, uint16_t band_lines, uint8_t band_num)
+{
+    ESP_RETURN_ON_FALSE(events && h_res && band_lines, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(band_num >= 2 && band_num <= LCD_BAND_MAX_NUM, ESP_ERR_INVALID_ARG, TAG, "band number must be 2~%d", LCD_BAND_MAX_NUM);
+    ESP_RETURN_ON_FALSE(_num == 0, ESP_ERR_INVALID_STATE, TAG, "band mode already started");
+
+    // 缓冲区放在内部 SRAM，并按缓存行对齐，DMA2D 可直接读取
+    size_t size = (size_t)h_res * band_lines * sizeof(uint16_t);
+    for (uint8_t i = 0; i < band_num; i++) {
+        _bufs[i] = (uint16_t *)heap_caps_aligned_calloc(LCD_BAND_ALIGN, 1, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_DMA);
+        if (!_bufs[i]) {
+            ESP_LOGE(TAG, "no mem for band %d (%u bytes)", i, (unsigned)size);
+            end();
+            return ESP_ERR_NO_MEM;
+        }
+        _pending[i].band = this;
+        _pending[i].buf = _bufs[i];
+    }
+
+    _free_sem = xSemaphoreCreateCounting(band_num, band_num);
+    if (!_free_sem) {
+        end();
+        return ESP_ERR_NO_MEM;
+    }
+
+    _events = events;
+    _stats = stats;
+    _h_res = h_res;
+    _lines = band_lines;
+    _num = band_num;
+    _next = 0;
+    ESP_LOGI(TAG, "%d bands of %d lines, %u bytes internal SRAM", band_num, band_lines, (unsigned)(size * band_num));
+    return ESP_OK;
+}
+
+void lcd_band::end()
+{
+    for (uint8_t i = 0; i < LCD_BAND_MAX_NUM; i++) {
+        if (_bufs[i]) {
+            heap_caps_free(_bufs[i]);
+            _bufs[i] = NULL;
+        }
+    }
+    if (_free_sem) {
+        vSemaphoreDelete(_free_sem);
+        _free_sem = NULL;
+    }
+    _num = 0;
+}
+
+uint16_t *lcd_band::acquire(TickType_t timeout)
+{
+    if (!_num) {
+        return NULL;
+    }
+
+    if (xSemaphoreTake(_free_sem, 0) != pdTRUE) {
+        // 所有条带都在传输中，记录渲染等待时间
+        int64_t start = esp_timer_get_time();
+        if (xSemaphoreTake(_free_sem, timeout) != pdTRUE) {
+            return NULL;
+        }
+        if (_stats) {
+            _stats->band_stalls++;
+            _stats->band_stall_us += esp_timer_get_time() - start;
+        }
+    }
+
+    uint16_t *band = _bufs[_next];
+    _next = (_next + 1) % _num;
+    return band;
+}
+
+esp_err_t lcd_band::flush(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *band)
+{
+    esp_err_t ret = ESP_OK;
+    pending_t *pending = NULL;
+
+    ESP_GOTO_ON_FALSE(_num, ESP_ERR_INVALID_STATE, err, TAG, "band mode not started");
+    ESP_GOTO_ON_FALSE((uint32_t)(x_end - x_start) * (y_end - y_start) <= (uint32_t)_h_res * _lines, ESP_ERR_INVALID_SIZE,
+                      err, TAG, "area larger than a band");
+    for (uint8_t i = 0; i < _num; i++) {
+        if (_bufs[i] == band) {
+            pending = &_pending[i];
+            break;
+        }
+    }
+    ESP_GOTO_ON_FALSE(pending, ESP_ERR_INVALID_ARG, err, TAG, "not a band buffer");
+
+    if (_stats) {
+        _stats->band_flushes++;
+    }
+    ret = _events->draw(x_start, y_start, x_end, y_end, band, on_band_done, pending);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "draw band failed");
+    return ESP_OK;
+
+err:
+    // 没交给 DMA 就不会有完成中断，这里直接完成，调用方（例如等 flush ready 的 LVGL）不会卡住
+    complete(band);
+    return ret;
+}
+
+void lcd_band::set_done_callback(lcd_band_done_cb_t cb, void *user_ctx)
+{
+    _done_ctx = user_ctx;
+    _done_cb = cb;
+}
+
+void lcd_band::complete(uint16_t *band)
+{
+    // 只归还本环里的条带，外来的缓冲区不能多放出一个空位
+    for (uint8_t i = 0; i < _num; i++) {
+        if (_bufs[i] == band) {
+            xSemaphoreGive(_free_sem);
+            break;
+        }
+    }
+    if (_done_cb) {
+        _done_cb(band, _done_ctx);
+    }
+}
+
+uint16_t *lcd_band::get_buffer(uint8_t index)
+{
+    return index < _num ? _bufs[index] : NULL;
+}
+
+uint16_t lcd_band::lines()
+{
+    return _lines;
+}
+
+uint8_t lcd_band::count()
+{
+    return _num;
+}
+
+bool lcd_band::on_band_done(void *user_ctx)
+{
+    pending_t *pending = (pending_t *)user_ctx;
+    lcd_band *self = pending->band;
+    BaseType_t need_yield = pdFALSE;
+
+    // 未通过 acquire() 取得的条带（例如交给 LVGL 管理）归还时信号量已满，忽略即可
+    xSemaphoreGiveFromISR(self->_free_sem, &need_yield);
+    if (self->_done_cb) {
+        need_yield |= self->_done_cb(pending->buf, self->_done_ctx);
+    }
+    return need_yield == pdTRUE;
+}
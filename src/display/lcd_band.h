@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "lcd_events.h"
+#include "lcd_stats.h"
+
+#define LCD_BAND_MAX_NUM 4
+#define LCD_BAND_ALIGN 64 // 缓存行对齐
+
+/**
+ * @brief Band completion callback, called from ISR once the band has been copied into the framebuffer
+ *
+ * Called from the flushing task instead when the band was consumed synchronously or could not be submitted.
+ *
+ * @return true if a higher priority task has been woken
+ */
+typedef bool (*lcd_band_done_cb_t)(uint16_t *band, void *user_ctx);
+
+/**
+ * @brief Ring of small RGB565 draw buffers in internal SRAM
+ *
+ * The renderer fills one band while the DMA2D copies the previous one into the DPI framebuffer.
+ * A band is `h_res * band_lines` pixels; the ring holds `band_num` of them.
+ */
+class lcd_band
+{
+public:
+    lcd_band();
+    ~lcd_band();
+
+    esp_err_t begin(lcd_events *events, lcd_stats_t *stats, uint16_t h_res, uint16_t band_lines, uint8_t band_num);
+    void end();
+    uint16_t *acquire(TickType_t timeout = portMAX_DELAY);
+    esp_err_t flush(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, uint16_t *band);
+    void set_done_callback(lcd_band_done_cb_t cb, void *user_ctx);
+    void complete(uint16_t *band);
+    uint16_t *get_buffer(uint8_t index);
+    uint16_t lines();
+    uint8_t count();
+
+private:
+    typedef struct {
+        lcd_band *band;
+        uint16_t *buf;
+    } pending_t;
+
+    static bool on_band_done(void *user_ctx);
+
+    lcd_events *_events;
+    lcd_stats_t *_stats;
+    uint16_t *_bufs[LCD_BAND_MAX_NUM];
+    pending_t _pending[LCD_BAND_MAX_NUM];
+    uint16_t _h_res;
+    uint16_t _lines;
+    uint8_t _num;
+    uint8_t _next;
+    SemaphoreHandle_t _free_sem;
+    lcd_band_done_cb_t _done_cb;
+    void *_done_ctx;
+};
@@ -0,0 +1,724 @@
+#include <string.h>
+#include "esp_lcd_mipi_dsi.h"
+#include "esp_heap_caps.h"
+#include "esp_cache.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_blit.h"
+
+static const char *TAG = "lcd_blit";
+
+// RGB565 常量透明度混合：把 G 移到高半字，三个分量之间留出保护位，一次乘法算完，alpha 取 0~32
+static inline uint16_t blend565(uint16_t fg, uint16_t bg, uint32_t alpha)
+{
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+    uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+    b = (b + (((f - b) * alpha) >> 5)) & 0x07E0F81F;
+    return (uint16_t)(b | (b >> 16));
+}
+
+typedef struct {
+    lcd_blit_rows_fn_t fn;
+    void *arg;
+    uint16_t h;
+} rows_job_t;
+
+typedef struct {
+    uint16_t *fb;
+    uint32_t fb_stride;
+    const lcd_blit_desc_t *desc;
+    uint16_t dst_w;
+    uint16_t dst_h;
+    const lcd_color_lut_table_t *lut;
+} scale_job_t;
+
+typedef struct {
+    uint16_t *dst;
+    uint32_t dst_stride;
+    const uint16_t *src;
+    uint32_t src_stride;
+    uint16_t w;
+    const lcd_color_lut_table_t *table;
+} correct_job_t;
+
+static inline bool rect_overlap(const lcd_blit_desc_t *r, uint16_t x, uint16_t y)
+{
+    return r->x < x + r->w && x < r->x + r->w && r->y < y + r->h && y < r->y + r->h;
+}
+
+lcd_blit::lcd_blit()
+{
+#if SOC_PPA_SUPPORTED
+    _srm = NULL;
+    _blend = NULL;
+    _fill = NULL;
+#endif
+    _events = NULL;
+    _fb = NULL;
+    _h_res = 0;
+    _v_res = 0;
+    _done_sem = NULL;
+    _stats = NULL;
+    _lut = NULL;
+    _pipeline = NULL;
+    _batch = 0;
+}
+
+lcd_blit::~lcd_blit()
+{
+    end();
+}
+
+esp_err_t lcd_blit::begin(esp_lcd_panel_handle_t panel, lcd_events *events, uint16_t h_res, uint16_t v_res,
+                          lcd_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(panel && events && h_res && v_res, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(!_fb, ESP_ERR_INVALID_STATE, TAG, "already started");
+
+    void *fb = NULL;
+    ESP_RETURN_ON_ERROR(esp_lcd_dpi_panel_get_frame_buffer(panel, 1, &fb), TAG, "get frame buffer failed");
+
+    _done_sem = xSemaphoreCreateCounting(LCD_BLIT_MAX_BATCH, 0);
+    ESP_RETURN_ON_FALSE(_done_sem, ESP_ERR_NO_MEM, TAG, "no mem for semaphore");
+
+#if SOC_PPA_SUPPORTED
+    // 某个客户端注册失败时，对应的操作退回到 CPU 完成
+    _srm = register_client(PPA_OPERATION_SRM);
+    _blend = register_client(PPA_OPERATION_BLEND);
+    _fill = register_client(PPA_OPERATION_FILL);
+#endif
+
+    // 帧缓冲在 PSRAM，按 L2 缓存行记录脏范围
+    size_t line = 0;
+    if (esp_cache_get_alignment(MALLOC_CAP_SPIRAM, &line) != ESP_OK || !line) {
+        line = 64;
+    }
+    _dirty.begin((size_t)h_res * v_res * sizeof(uint16_t), line);
+    _batch = 0;
+    _stats = stats;
+
+    _events = events;
+    _fb = (uint16_t *)fb;
+    _h_res = h_res;
+    _v_res = v_res;
+    events->set_before_draw(before_draw, this);
+    return ESP_OK;
+}
+
+void lcd_blit::end()
+{
+    if (_fb) {
+        sync();
+        _events->set_before_draw(NULL, NULL);
+    }
+#if SOC_PPA_SUPPORTED
+    ppa_client_handle_t *clients[] = {&_srm, &_blend, &_fill};
+    for (size_t i = 0; i < sizeof(clients) / sizeof(clients[0]); i++) {
+        if (*clients[i]) {
+            ppa_unregister_client(*clients[i]);
+            *clients[i] = NULL;
+        }
+    }
+#endif
+    if (_done_sem) {
+        vSemaphoreDelete(_done_sem);
+        _done_sem = NULL;
+    }
+    _fb = NULL;
+}
+
+bool lcd_blit::started()
+{
+    return _fb != NULL;
+}
+
+uint16_t *lcd_blit::cpu_begin()
+{
+    // 给 CPU 直接写帧缓冲的调用方（如流式解码）使用：先等在途的 DMA 搬运结束
+    if (!_fb || _events->wait_idle() != ESP_OK) {
+        return NULL;
+    }
+    return _fb;
+}
+
+void lcd_blit::cpu_end(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool corrected)
+{
+    if (!_fb || !w || !h) {
+        return;
+    }
+    // 不透明写入统一在这里原地查表；混合类写入由调用方先校正源颜色，再传 corrected
+    const lcd_color_lut_table_t *table = (!corrected && _lut) ? _lut->acquire_table() : NULL;
+    if (table) {
+        uint16_t *p = _fb + (uint32_t)y * _h_res + x;
+        correct(p, p, _h_res, w, h, table);
+        _lut->release_table(table);
+    }
+    sync_rows(x, y, w, h);
+}
+
+void lcd_blit::set_color_lut(lcd_color_lut *lut)
+{
+    _lut = lut;
+}
+
+bool lcd_blit::color_lut_active()
+{
+    return _lut && _lut->active();
+}
+
+void lcd_blit::set_pipeline(lcd_pipeline *pipeline)
+{
+    _pipeline = pipeline;
+}
+
+void lcd_blit::parallel_rows(uint16_t h, lcd_blit_rows_fn_t fn, void *arg)
+{
+    // 只有流水线在跑时才有另一个核上的辅助任务；行数太少时分块的开销不值得
+    if (!_pipeline || !_pipeline->started() || h < 2 * LCD_BLIT_PARALLEL_ROWS) {
+        fn(0, h, arg);
+        return;
+    }
+    rows_job_t job = {fn, arg, h};
+    _pipeline->parallel_for((h + LCD_BLIT_PARALLEL_ROWS - 1) / LCD_BLIT_PARALLEL_ROWS, rows_tile, &job);
+}
+
+void lcd_blit::rows_tile(uint32_t tile, void *arg)
+{
+    rows_job_t *job = (rows_job_t *)arg;
+    uint32_t row = tile * LCD_BLIT_PARALLEL_ROWS;
+    uint32_t rows = job->h - row < LCD_BLIT_PARALLEL_ROWS ? job->h - row : LCD_BLIT_PARALLEL_ROWS;
+    job->fn(row, rows, job->arg);
+}
+
+void lcd_blit::correct_rows(uint16_t row, uint16_t rows, void *arg)
+{
+    correct_job_t *job = (correct_job_t *)arg;
+    for (uint16_t i = row; i < row + rows; i++) {
+        lcd_color_lut::convert(job->table, job->dst + (uint32_t)i * job->dst_stride,
+                               job->src + (uint32_t)i * job->src_stride, job->w);
+    }
+}
+
+void lcd_blit::correct(uint16_t *dst, const uint16_t *src, uint32_t src_stride, uint16_t w, uint16_t h,
+                       const lcd_color_lut_table_t *table)
+{
+    // 目标总在帧缓冲里；分块的任务不碰统计，统计在这里记一次
+    int64_t start = esp_timer_get_time();
+    correct_job_t job = {dst, _h_res, src, src_stride, w, table};
+    parallel_rows(h, correct_rows, &job);
+    if (_stats) {
+        _stats->color_lut_pixels += (uint32_t)w * h;
+        _stats->color_lut_us += esp_timer_get_time() - start;
+    }
+}
+
+esp_err_t lcd_blit::read_back(uint16_t *dst, size_t dst_size)
+{
+    size_t size = (size_t)_h_res * _v_res * sizeof(uint16_t);
+    ESP_RETURN_ON_FALSE(_fb, ESP_ERR_INVALID_STATE, TAG, "not started");
+    ESP_RETURN_ON_FALSE(dst && dst_size >= size, ESP_ERR_INVALID_ARG, TAG, "invalid destination");
+    ESP_RETURN_ON_ERROR(_events->wait_idle(), TAG, "wait for pending draws failed");
+    sync();
+
+#if SOC_PPA_SUPPORTED
+    if (_srm) {
+        // 整帧 1:1 拷出，目标缓冲需按缓存行对齐，缓存维护由 PPA 驱动完成
+        ppa_srm_oper_config_t srm = {};
+        srm.in.buffer = _fb;
+        srm.in.pic_w = _h_res;
+        srm.in.pic_h = _v_res;
+        srm.in.block_w = _h_res;
+        srm.in.block_h = _v_res;
+        srm.in.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+        srm.out.buffer = dst;
+        srm.out.buffer_size = dst_size;
+        srm.out.pic_w = _h_res;
+        srm.out.pic_h = _v_res;
+        srm.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+        srm.rotation_angle = PPA_SRM_ROTATION_ANGLE_0;
+        srm.scale_x = 1.0f;
+        srm.scale_y = 1.0f;
+        srm.mode = PPA_TRANS_MODE_NON_BLOCKING;
+        srm.user_data = this;
+        ESP_RETURN_ON_ERROR(ppa_do_scale_rotate_mirror(_srm, &srm), TAG, "PPA read back failed");
+        return wait_done(1);
+    }
+#endif
+    memcpy(dst, _fb, size);
+    esp_cache_msync(dst, size, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+    return ESP_OK;
+}
+
+esp_err_t lcd_blit::blit(const lcd_blit_desc_t *desc)
+{
+    return blit_batch(desc, 1);
+}
+
+esp_err_t lcd_blit::blit_batch(const lcd_blit_desc_t *descs, size_t num)
+{
+    ESP_RETURN_ON_FALSE(descs || !num, ESP_ERR_INVALID_ARG, TAG, "invalid descriptors");
+
+    lcd_blit_op_t ops[LCD_BLIT_MAX_BATCH];
+    while (num) {
+        size_t n = num < LCD_BLIT_MAX_BATCH ? num : LCD_BLIT_MAX_BATCH;
+        for (size_t i = 0; i < n; i++) {
+            memset(&ops[i], 0, sizeof(ops[i]));
+            ops[i].rect = descs[i];
+            ops[i].type = LCD_BLIT_OP_BLIT;
+        }
+        ESP_RETURN_ON_ERROR(run(ops, n), TAG, "blit failed");
+        descs += n;
+        num -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t lcd_blit::run(const lcd_blit_op_t *ops, size_t num)
+{
+    ESP_RETURN_ON_FALSE(_fb, ESP_ERR_INVALID_STATE, TAG, "not started");
+    ESP_RETURN_ON_FALSE(ops || !num, ESP_ERR_INVALID_ARG, TAG, "invalid operations");
+
+    // 先等面板上排队的 DMA 搬运结束，保证写入顺序
+    ESP_RETURN_ON_ERROR(_events->wait_idle(), TAG, "wait for pending draws failed");
+
+    // 整批操作用同一张校正表，期间切换的新表从下一批生效
+    const lcd_color_lut_table_t *table = _lut ? _lut->acquire_table() : NULL;
+    esp_err_t ret = ESP_OK;
+    uint32_t queued = 0;
+    int engine = ENGINE_NONE;
+    for (size_t i = 0; i < num; i++) {
+        lcd_blit_op_t op;
+        if (!clip(&ops[i], &op)) {
+            continue;
+        }
+        const lcd_color_lut_table_t *lut = (op.flags & LCD_BLIT_FLAG_CORRECTED) ? NULL : table;
+        if (lut && op.type == LCD_BLIT_OP_FILL) {
+            op.color = lcd_color_lut_lookup(lut, op.color);
+        }
+#if SOC_PPA_SUPPORTED
+        // PPA 不能查表：要校正源颜色的拷贝、混合和缩放交给 CPU，查表与读写合成一遍
+        int next = (lut && op.type != LCD_BLIT_OP_FILL && op.type != LCD_BLIT_OP_COPY) ? ENGINE_NONE : ppa_engine(&op);
+        // 两个引擎并行执行，换引擎或换回 CPU 前必须等已排队的操作完成，否则重叠区域的先后顺序会乱
+        if (queued && (next != engine || queued == LCD_BLIT_MAX_BATCH)) {
+            ret = wait_done(queued);
+            queued = 0;
+            if (ret != ESP_OK) {
+                break;
+            }
+        }
+        if (next != ENGINE_NONE) {
+            // PPA 读写帧缓冲前，先写回 CPU 留下的脏行
+            sync();
+            switch (op.type) {
+            case LCD_BLIT_OP_FILL:
+                ret = fill_ppa(&op.rect, op.color);
+                break;
+            case LCD_BLIT_OP_BLEND:
+                ret = blend_ppa(&op.rect, op.alpha, op.bg);
+                break;
+            case LCD_BLIT_OP_SCALE:
+                ret = scale_ppa(&op.rect, op.dst_w, op.dst_h);
+                break;
+            default:
+                ret = blit_ppa(&op.rect, op.type == LCD_BLIT_OP_COPY);
+                break;
+            }
+            if (ret != ESP_OK) {
+                break;
+            }
+            queued++;
+            engine = next;
+            continue;
+        }
+#endif
+        // PPA 驱动在提交前已作废输出缓冲的缓存，这里 CPU 直接读写帧缓冲即可
+        switch (op.type) {
+        case LCD_BLIT_OP_FILL:
+            fill_sw(&op.rect, op.color);
+            break;
+        case LCD_BLIT_OP_BLEND:
+            blend_sw(&op.rect, op.alpha, op.bg, lut);
+            break;
+        case LCD_BLIT_OP_COPY:
+            copy_sw(&op.rect);
+            break;
+        case LCD_BLIT_OP_SCALE:
+            scale_sw(&op.rect, op.dst_w, op.dst_h, lut);
+            break;
+        default:
+            blit_sw(&op.rect, lut);
+            break;
+        }
+    }
+
+    esp_err_t wait_ret = wait_done(queued);
+    if (_lut) {
+        _lut->release_table(table);
+    }
+    return ret != ESP_OK ? ret : wait_ret;
+}
+
+bool lcd_blit::clip(const lcd_blit_op_t *op, lcd_blit_op_t *out)
+{
+    const lcd_blit_desc_t *desc = &op->rect;
+
+    *out = *op;
+    if (op->type >= LCD_BLIT_OP_NOP || desc->x >= _h_res || desc->y >= _v_res || !desc->w || !desc->h) {
+        return false;
+    }
+    if (op->type != LCD_BLIT_OP_SCALE && out->rect.x + out->rect.w > _h_res) {
+        out->rect.w = _h_res - out->rect.x;
+    }
+    if (op->type != LCD_BLIT_OP_SCALE && out->rect.y + out->rect.h > _v_res) {
+        out->rect.h = _v_res - out->rect.y;
+    }
+
+    switch (op->type) {
+    case LCD_BLIT_OP_FILL:
+        return true;
+    case LCD_BLIT_OP_SCALE:
+        // 缩放不做裁剪，目标矩形必须整个在屏幕内
+        return desc->src && desc->src_x + desc->w <= desc->src_stride && op->dst_w && op->dst_h &&
+               desc->x + op->dst_w <= _h_res && desc->y + op->dst_h <= _v_res;
+    case LCD_BLIT_OP_COPY:
+        return desc->src_x + out->rect.w <= _h_res && desc->src_y + out->rect.h <= _v_res;
+    default:
+        return desc->src && desc->src_x + out->rect.w <= desc->src_stride;
+    }
+}
+
+void lcd_blit::sync_rows(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    // 只记下脏范围；不在批处理里就立即写回，局部宽度的各行合并成少数几次同步
+    _dirty.add_rect(((size_t)y * _h_res + x) * sizeof(uint16_t), (size_t)w * sizeof(uint16_t),
+                    (size_t)_h_res * sizeof(uint16_t), h);
+    if (!_batch) {
+        sync();
+    }
+}
+
+void lcd_blit::batch_begin()
+{
+    _batch++;
+}
+
+void lcd_blit::batch_end()
+{
+    if (_batch && --_batch == 0) {
+        sync();
+    }
+}
+
+void lcd_blit::sync()
+{
+    if (!_fb || _dirty.empty()) {
+        return;
+    }
+    size_t calls = _dirty.flush(sync_range, this);
+    if (_stats) {
+        _stats->cache_syncs += calls;
+    }
+}
+
+void lcd_blit::sync_range(size_t offset, size_t size, void *ctx)
+{
+    lcd_blit *self = (lcd_blit *)ctx;
+
+    esp_cache_msync((uint8_t *)self->_fb + offset, size, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+    if (self->_stats) {
+        self->_stats->cache_sync_bytes += size;
+    }
+}
+
+bool lcd_blit::before_draw(void *user_ctx)
+{
+    ((lcd_blit *)user_ctx)->sync();
+    return false;
+}
+
+void lcd_blit::blit_sw(const lcd_blit_desc_t *desc, const lcd_color_lut_table_t *lut)
+{
+    size_t bytes = (size_t)desc->w * sizeof(uint16_t);
+
+    if (lut) {
+        correct(_fb + (uint32_t)desc->y * _h_res + desc->x,
+                desc->src + (uint32_t)desc->src_y * desc->src_stride + desc->src_x, desc->src_stride, desc->w,
+                desc->h, lut);
+        sync_rows(desc->x, desc->y, desc->w, desc->h);
+        return;
+    }
+    for (uint16_t row = 0; row < desc->h; row++) {
+        const uint16_t *src = desc->src + (uint32_t)(desc->src_y + row) * desc->src_stride + desc->src_x;
+        uint16_t *dst = _fb + (uint32_t)(desc->y + row) * _h_res + desc->x;
+        memcpy(dst, src, bytes);
+    }
+    sync_rows(desc->x, desc->y, desc->w, desc->h);
+}
+
+void lcd_blit::fill_sw(const lcd_blit_desc_t *desc, uint16_t color)
+{
+    size_t bytes = (size_t)desc->w * sizeof(uint16_t);
+    uint16_t *first = _fb + (uint32_t)desc->y * _h_res + desc->x;
+
+    // 只逐像素填第一行，其余行从第一行拷贝
+    for (uint16_t col = 0; col < desc->w; col++) {
+        first[col] = color;
+    }
+    for (uint16_t row = 1; row < desc->h; row++) {
+        memcpy(first + (uint32_t)row * _h_res, first, bytes);
+    }
+    sync_rows(desc->x, desc->y, desc->w, desc->h);
+}
+
+void lcd_blit::blend_sw(const lcd_blit_desc_t *desc, uint8_t alpha, const uint16_t *bg,
+                        const lcd_color_lut_table_t *lut)
+{
+    uint32_t a = (alpha + 4) >> 3;
+
+    for (uint16_t row = 0; row < desc->h; row++) {
+        uint32_t offset = (uint32_t)(desc->src_y + row) * desc->src_stride + desc->src_x;
+        const uint16_t *src = desc->src + offset;
+        uint16_t *dst = _fb + (uint32_t)(desc->y + row) * _h_res + desc->x;
+        // 背景画布给出时与源画布同布局，否则以屏幕内容为背景；屏幕内容已校正过，只查源和背景画布
+        const uint16_t *back = bg ? bg + offset : dst;
+        if (!lut) {
+            for (uint16_t col = 0; col < desc->w; col++) {
+                dst[col] = blend565(src[col], back[col], a);
+            }
+            continue;
+        }
+        for (uint16_t col = 0; col < desc->w; col++) {
+            uint16_t b = bg ? lcd_color_lut_lookup(lut, back[col]) : back[col];
+            dst[col] = blend565(lcd_color_lut_lookup(lut, src[col]), b, a);
+        }
+    }
+    sync_rows(desc->x, desc->y, desc->w, desc->h);
+}
+
+void lcd_blit::scale_sw(const lcd_blit_desc_t *desc, uint16_t dst_w, uint16_t dst_h,
+                        const lcd_color_lut_table_t *lut)
+{
+    scale_job_t job = {_fb, _h_res, desc, dst_w, dst_h, lut};
+    parallel_rows(dst_h, scale_rows, &job);
+    sync_rows(desc->x, desc->y, dst_w, dst_h);
+}
+
+void lcd_blit::scale_rows(uint16_t row, uint16_t rows, void *arg)
+{
+    scale_job_t *job = (scale_job_t *)arg;
+    const lcd_blit_desc_t *desc = job->desc;
+    const lcd_color_lut_table_t *lut = job->lut;
+
+    // 最近邻缩放，16.16 定点步进；每块从自己的第一行算起源坐标，和整块连续算的结果一致
+    uint32_t step_x = ((uint32_t)desc->w << 16) / job->dst_w;
+    uint32_t step_y = ((uint32_t)desc->h << 16) / job->dst_h;
+    uint32_t sy = (step_y >> 1) + step_y * row;
+
+    for (uint16_t r = row; r < row + rows; r++, sy += step_y) {
+        const uint16_t *src = desc->src + (uint32_t)(desc->src_y + (sy >> 16)) * desc->src_stride + desc->src_x;
+        uint16_t *dst = job->fb + (uint32_t)(desc->y + r) * job->fb_stride + desc->x;
+        uint32_t sx = step_x >> 1;
+        if (lut) {
+            for (uint16_t col = 0; col < job->dst_w; col++, sx += step_x) {
+                dst[col] = lcd_color_lut_lookup(lut, src[sx >> 16]);
+            }
+            continue;
+        }
+        for (uint16_t col = 0; col < job->dst_w; col++, sx += step_x) {
+            dst[col] = src[sx >> 16];
+        }
+    }
+}
+
+void lcd_blit::copy_sw(const lcd_blit_desc_t *desc)
+{
+    size_t bytes = (size_t)desc->w * sizeof(uint16_t);
+    bool bottom_up = desc->y > desc->src_y;
+
+    // 源和目标可能重叠（滚动），向下移动时从最后一行开始拷贝
+    for (uint16_t i = 0; i < desc->h; i++) {
+        uint16_t row = bottom_up ? desc->h - 1 - i : i;
+        const uint16_t *src = _fb + (uint32_t)(desc->src_y + row) * _h_res + desc->src_x;
+        uint16_t *dst = _fb + (uint32_t)(desc->y + row) * _h_res + desc->x;
+        memmove(dst, src, bytes);
+    }
+    sync_rows(desc->x, desc->y, desc->w, desc->h);
+}
+
+esp_err_t lcd_blit::wait_done(uint32_t num)
+{
+    for (uint32_t i = 0; i < num; i++) {
+        if (xSemaphoreTake(_done_sem, pdMS_TO_TICKS(1000)) != pdTRUE) {
+            ESP_LOGE(TAG, "blit timeout");
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    return ESP_OK;
+}
+
+#if SOC_PPA_SUPPORTED
+ppa_client_handle_t lcd_blit::register_client(ppa_operation_t oper)
+{
+    ppa_client_handle_t client = NULL;
+    ppa_client_config_t client_config = {};
+    client_config.oper_type = oper;
+    client_config.max_pending_trans_num = LCD_BLIT_MAX_BATCH;
+    if (ppa_register_client(&client_config, &client) != ESP_OK) {
+        ESP_LOGW(TAG, "register PPA client %d failed, fall back to CPU", (int)oper);
+        return NULL;
+    }
+
+    ppa_event_callbacks_t cbs = {};
+    cbs.on_trans_done = on_trans_done;
+    ppa_client_register_event_callbacks(client, &cbs);
+    return client;
+}
+
+int lcd_blit::ppa_engine(const lcd_blit_op_t *op)
+{
+    switch (op->type) {
+    case LCD_BLIT_OP_FILL:
+        // 填充由混合引擎完成
+        return _fill ? ENGINE_BLEND : ENGINE_NONE;
+    case LCD_BLIT_OP_BLEND:
+        return _blend ? ENGINE_BLEND : ENGINE_NONE;
+    case LCD_BLIT_OP_COPY:
+        // 源和目标重叠时 DMA 读写会互相踩踏，交给 CPU 按方向拷贝
+        if (rect_overlap(&op->rect, op->rect.src_x, op->rect.src_y)) {
+            return ENGINE_NONE;
+        }
+        return _srm ? ENGINE_SRM : ENGINE_NONE;
+    case LCD_BLIT_OP_SCALE:
+        // PPA 的比例精度为 1/16，不能整除的比例交给 CPU，否则输出会比目标矩形小
+        if ((op->dst_w * 16) % op->rect.w || (op->dst_h * 16) % op->rect.h) {
+            return ENGINE_NONE;
+        }
+        return _srm ? ENGINE_SRM : ENGINE_NONE;
+    default:
+        return _srm ? ENGINE_SRM : ENGINE_NONE;
+    }
+}
+
+esp_err_t lcd_blit::blit_ppa(const lcd_blit_desc_t *desc, bool from_fb)
+{
+    // 1:1 的 SRM 操作，输入图块带行跨度和起点，输出直接落在帧缓冲的目标位置
+    ppa_srm_oper_config_t srm = {};
+    srm.in.buffer = from_fb ? _fb : desc->src;
+    srm.in.pic_w = from_fb ? _h_res : desc->src_stride;
+    srm.in.pic_h = from_fb ? _v_res : desc->src_y + desc->h;
+    srm.in.block_w = desc->w;
+    srm.in.block_h = desc->h;
+    srm.in.block_offset_x = desc->src_x;
+    srm.in.block_offset_y = desc->src_y;
+    srm.in.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+    srm.out.buffer = _fb;
+    srm.out.buffer_size = (uint32_t)_h_res * _v_res * sizeof(uint16_t);
+    srm.out.pic_w = _h_res;
+    srm.out.pic_h = _v_res;
+    srm.out.block_offset_x = desc->x;
+    srm.out.block_offset_y = desc->y;
+    srm.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+    srm.rotation_angle = PPA_SRM_ROTATION_ANGLE_0;
+    srm.scale_x = 1.0f;
+    srm.scale_y = 1.0f;
+    srm.mode = PPA_TRANS_MODE_NON_BLOCKING;
+    srm.user_data = this;
+    return ppa_do_scale_rotate_mirror(_srm, &srm);
+}
+
+esp_err_t lcd_blit::scale_ppa(const lcd_blit_desc_t *desc, uint16_t dst_w, uint16_t dst_h)
+{
+    // 输出尺寸由比例决定，只有比例是 1/16 的整数倍时才会走到这里
+    ppa_srm_oper_config_t srm = {};
+    srm.in.buffer = desc->src;
+    srm.in.pic_w = desc->src_stride;
+    srm.in.pic_h = desc->src_y + desc->h;
+    srm.in.block_w = desc->w;
+    srm.in.block_h = desc->h;
+    srm.in.block_offset_x = desc->src_x;
+    srm.in.block_offset_y = desc->src_y;
+    srm.in.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+    srm.out.buffer = _fb;
+    srm.out.buffer_size = (uint32_t)_h_res * _v_res * sizeof(uint16_t);
+    srm.out.pic_w = _h_res;
+    srm.out.pic_h = _v_res;
+    srm.out.block_offset_x = desc->x;
+    srm.out.block_offset_y = desc->y;
+    srm.out.srm_cm = PPA_SRM_COLOR_MODE_RGB565;
+    srm.rotation_angle = PPA_SRM_ROTATION_ANGLE_0;
+    srm.scale_x = (float)dst_w / desc->w;
+    srm.scale_y = (float)dst_h / desc->h;
+    srm.mode = PPA_TRANS_MODE_NON_BLOCKING;
+    srm.user_data = this;
+    return ppa_do_scale_rotate_mirror(_srm, &srm);
+}
+
+esp_err_t lcd_blit::fill_ppa(const lcd_blit_desc_t *desc, uint16_t color)
+{
+    ppa_fill_oper_config_t fill = {};
+    fill.out.buffer = _fb;
+    fill.out.buffer_size = (uint32_t)_h_res * _v_res * sizeof(uint16_t);
+    fill.out.pic_w = _h_res;
+    fill.out.pic_h = _v_res;
+    fill.out.block_offset_x = desc->x;
+    fill.out.block_offset_y = desc->y;
+    fill.out.fill_cm = PPA_FILL_COLOR_MODE_RGB565;
+    fill.fill_block_w = desc->w;
+    fill.fill_block_h = desc->h;
+    // 填充颜色按 ARGB8888 给出，RGB565 各分量扩展到 8 位
+    fill.fill_argb_color.a = 0xFF;
+    fill.fill_argb_color.r = ((color >> 11) & 0x1F) * 255 / 31;
+    fill.fill_argb_color.g = ((color >> 5) & 0x3F) * 255 / 63;
+    fill.fill_argb_color.b = (color & 0x1F) * 255 / 31;
+    fill.mode = PPA_TRANS_MODE_NON_BLOCKING;
+    fill.user_data = this;
+    return ppa_do_fill(_fill, &fill);
+}
+
+esp_err_t lcd_blit::blend_ppa(const lcd_blit_desc_t *desc, uint8_t alpha, const uint16_t *bg)
+{
+    // 背景默认取自帧缓冲的目标位置，结果原地写回；给出背景画布时按源图块的布局读取
+    ppa_blend_oper_config_t blend = {};
+    blend.in_bg.buffer = bg ? bg : _fb;
+    blend.in_bg.pic_w = bg ? desc->src_stride : _h_res;
+    blend.in_bg.pic_h = bg ? desc->src_y + desc->h : _v_res;
+    blend.in_bg.block_w = desc->w;
+    blend.in_bg.block_h = desc->h;
+    blend.in_bg.block_offset_x = bg ? desc->src_x : desc->x;
+    blend.in_bg.block_offset_y = bg ? desc->src_y : desc->y;
+    blend.in_bg.blend_cm = PPA_BLEND_COLOR_MODE_RGB565;
+    blend.in_fg.buffer = desc->src;
+    blend.in_fg.pic_w = desc->src_stride;
+    blend.in_fg.pic_h = desc->src_y + desc->h;
+    blend.in_fg.block_w = desc->w;
+    blend.in_fg.block_h = desc->h;
+    blend.in_fg.block_offset_x = desc->src_x;
+    blend.in_fg.block_offset_y = desc->src_y;
+    blend.in_fg.blend_cm = PPA_BLEND_COLOR_MODE_RGB565;
+    blend.out.buffer = _fb;
+    blend.out.buffer_size = (uint32_t)_h_res * _v_res * sizeof(uint16_t);
+    blend.out.pic_w = _h_res;
+    blend.out.pic_h = _v_res;
+    blend.out.block_offset_x = desc->x;
+    blend.out.block_offset_y = desc->y;
+    blend.out.blend_cm = PPA_BLEND_COLOR_MODE_RGB565;
+    blend.bg_alpha_update_mode = PPA_ALPHA_NO_CHANGE;
+    blend.fg_alpha_update_mode = PPA_ALPHA_FIX_VALUE;
+    blend.fg_alpha_fix_val = alpha;
+    blend.mode = PPA_TRANS_MODE_NON_BLOCKING;
+    blend.user_data = this;
+    return ppa_do_blend(_blend, &blend);
+}
+
+bool lcd_blit::on_trans_done(ppa_client_handle_t client, ppa_event_data_t *edata, void *user_data)
+{
+    lcd_blit *self = (lcd_blit *)user_data;
+    BaseType_t need_yield = pdFALSE;
+
+    xSemaphoreGiveFromISR(self->_done_sem, &need_yield);
+    return need_yield == pdTRUE;
+}
+#endif
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <stdio.h>
+#include "soc/soc_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "lcd_events.h"
+#include "lcd_stats.h"
+#include "lcd_dirty_ranges.h"
+#include "lcd_color_lut.h"
+#include "lcd_pipeline.h"
+#if SOC_PPA_SUPPORTED
+#include "driver/ppa.h"
+#endif
+
+#define LCD_BLIT_MAX_BATCH 16
+#define LCD_BLIT_PARALLEL_ROWS 32 // 并行时每块的行数，两个核各取各的块，块之间不写同一行
+
+typedef void (*lcd_blit_rows_fn_t)(uint16_t row, uint16_t rows, void *arg);
+
+/**
+ * @brief One strided sub-rectangle copy: (src_x, src_y, w, h) of the source canvas to (x, y) on the screen
+ */
+typedef struct {
+    const uint16_t *src;  /*!< Source canvas, RGB565 */
+    uint16_t src_stride;  /*!< Source row length in pixels */
+    uint16_t src_x;       /*!< Left edge of the sub-rectangle in the source */
+    uint16_t src_y;       /*!< Top edge of the sub-rectangle in the source */
+    uint16_t x;           /*!< Destination left edge */
+    uint16_t y;           /*!< Destination top edge */
+    uint16_t w;           /*!< Width in pixels */
+    uint16_t h;           /*!< Height in pixels */
+} lcd_blit_desc_t;
+
+/**
+ * @brief Kind of framebuffer operation
+ */
+typedef enum {
+    LCD_BLIT_OP_BLIT = 0,  /*!< Copy a sub-rectangle of a source canvas */
+    LCD_BLIT_OP_FILL,      /*!< Solid fill with `color`, `rect.src` is unused */
+    LCD_BLIT_OP_BLEND,     /*!< Blend a sub-rectangle of a source canvas over the screen, or over `bg`, with constant `alpha` */
+    LCD_BLIT_OP_COPY,      /*!< Copy inside the framebuffer, `rect.src_x/src_y` are screen coordinates */
+    LCD_BLIT_OP_SCALE,     /*!< Scale a sub-rectangle of a source canvas to `dst_w` x `dst_h` at (x, y), must lie on screen */
+    LCD_BLIT_OP_NOP,       /*!< Skipped */
+} lcd_blit_op_type_t;
+
+/**
+ * @brief Per-operation flags
+ */
+typedef enum {
+    LCD_BLIT_FLAG_CORRECTED = 1 << 0,  /*!< Source is already colour corrected, e.g. read back from the screen */
+} lcd_blit_op_flag_t;
+
+/**
+ * @brief One framebuffer operation
+ */
+typedef struct {
+    lcd_blit_desc_t rect;  /*!< Destination (and source) rectangle */
+    uint16_t color;        /*!< Fill color, RGB565 */
+    uint8_t alpha;         /*!< Blend alpha, 255 is opaque */
+    uint8_t type;          /*!< lcd_blit_op_type_t */
+    uint16_t dst_w;        /*!< Scaled width, LCD_BLIT_OP_SCALE only */
+    uint16_t dst_h;        /*!< Scaled height, LCD_BLIT_OP_SCALE only */
+    const uint16_t *bg;    /*!< LCD_BLIT_OP_BLEND only: background canvas laid out like `rect.src`, NULL for the screen */
+    uint8_t flags;         /*!< lcd_blit_op_flag_t bits */
+} lcd_blit_op_t;
+
+/**
+ * @brief Copies sub-rectangles of a larger RGB565 canvas straight into the DPI framebuffer
+ *
+ * Uses the PPA scale-rotate-mirror engine (2D-DMA) at 1:1 when available, so the source does
+ * not have to be packed first; scaled copies use the same engine when the ratio is a multiple of
+ * 1/16, the PPA's precision, and the CPU otherwise. A batch is queued as back-to-back PPA
+ * transactions and waited for once. Without PPA the copy is done row by row on the CPU. Fills and
+ * blends go to the PPA blend engine the same way; the queue is drained only when the next
+ * operation needs the other engine or the CPU.
+ *
+ * CPU writes to the framebuffer (`cpu_end()` and the CPU fallbacks) are recorded as dirty cache-line
+ * ranges and written back coalesced: at the end of the write, or, between `batch_begin()` and
+ * `batch_end()`, once for the whole batch. Pending write-backs are always done before a PPA or panel
+ * DMA transfer touches the framebuffer.
+ *
+ * With a colour LUT set and active every write is corrected: fills map their colour, copies, blends
+ * and scales from a source canvas map the source on the CPU, and `cpu_end()` corrects the rectangle
+ * in place. Sources flagged LCD_BLIT_FLAG_CORRECTED, and copies inside the framebuffer, are taken
+ * as they are.
+ *
+ * With a started pipeline set, the CPU scale and colour correction of large rectangles are split into
+ * row bands and spread over both cores with `lcd_pipeline::parallel_for()`; `parallel_rows()` offers
+ * the same to callers' own kernels.
+ */
+class lcd_blit
+{
+public:
+    lcd_blit();
+    ~lcd_blit();
+
+    esp_err_t begin(esp_lcd_panel_handle_t panel, lcd_events *events, uint16_t h_res, uint16_t v_res,
+                    lcd_stats_t *stats = NULL);
+    void end();
+    bool started();
+    esp_err_t blit(const lcd_blit_desc_t *desc);
+    esp_err_t blit_batch(const lcd_blit_desc_t *descs, size_t num);
+    esp_err_t run(const lcd_blit_op_t *ops, size_t num);
+    uint16_t *cpu_begin();
+    void cpu_end(uint16_t x, uint16_t y, uint16_t w, uint16_t h, bool corrected = false);
+    void set_color_lut(lcd_color_lut *lut);
+    bool color_lut_active();
+    void set_pipeline(lcd_pipeline *pipeline);
+    void parallel_rows(uint16_t h, lcd_blit_rows_fn_t fn, void *arg);
+    esp_err_t read_back(uint16_t *dst, size_t dst_size);
+    void batch_begin();
+    void batch_end();
+    void sync();
+
+private:
+    enum {
+        ENGINE_NONE = 0,
+        ENGINE_SRM,
+        ENGINE_BLEND,
+    };
+
+    static void sync_range(size_t offset, size_t size, void *ctx);
+    static bool before_draw(void *user_ctx);
+    static void rows_tile(uint32_t tile, void *arg);
+    static void scale_rows(uint16_t row, uint16_t rows, void *arg);
+    static void correct_rows(uint16_t row, uint16_t rows, void *arg);
+    void correct(uint16_t *dst, const uint16_t *src, uint32_t src_stride, uint16_t w, uint16_t h,
+                 const lcd_color_lut_table_t *table);
+    bool clip(const lcd_blit_op_t *op, lcd_blit_op_t *out);
+    void sync_rows(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void blit_sw(const lcd_blit_desc_t *desc, const lcd_color_lut_table_t *lut);
+    void fill_sw(const lcd_blit_desc_t *desc, uint16_t color);
+    void blend_sw(const lcd_blit_desc_t *desc, uint8_t alpha, const uint16_t *bg, const lcd_color_lut_table_t *lut);
+    void copy_sw(const lcd_blit_desc_t *desc);
+    void scale_sw(const lcd_blit_desc_t *desc, uint16_t dst_w, uint16_t dst_h, const lcd_color_lut_table_t *lut);
+    esp_err_t wait_done(uint32_t num);
+#if SOC_PPA_SUPPORTED
+    static bool on_trans_done(ppa_client_handle_t client, ppa_event_data_t *edata, void *user_data);
+    ppa_client_handle_t register_client(ppa_operation_t oper);
+    int ppa_engine(const lcd_blit_op_t *op);
+    esp_err_t blit_ppa(const lcd_blit_desc_t *desc, bool from_fb);
+    esp_err_t fill_ppa(const lcd_blit_desc_t *desc, uint16_t color);
+    esp_err_t blend_ppa(const lcd_blit_desc_t *desc, uint8_t alpha, const uint16_t *bg);
+    esp_err_t scale_ppa(const lcd_blit_desc_t *desc, uint16_t dst_w, uint16_t dst_h);
+
+    ppa_client_handle_t _srm;
+    ppa_client_handle_t _blend;
+    ppa_client_handle_t _fill;
+#endif
+
+    lcd_events *_events;
+    uint16_t *_fb;
+    uint16_t _h_res;
+    uint16_t _v_res;
+    SemaphoreHandle_t _done_sem;
+    lcd_dirty_ranges _dirty;
+    lcd_stats_t *_stats;
+    lcd_color_lut *_lut;
+    lcd_pipeline *_pipeline;
+    uint8_t _batch;
+};
@@ -0,0 +1,173 @@
+#include <math.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_color_lut.h"
+
+static const char *TAG = "lcd_color_lut";
+
+lcd_color_lut::lcd_color_lut()
+{
+    memset(_banks, 0, sizeof(_banks));
+    memset(_users, 0, sizeof(_users));
+    _current = -1;
+    _spinlock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+int lcd_color_lut::acquire()
+{
+    // 绘制开始时取一次当前表，整次绘制都用它，期间切换的新表从下一次绘制生效
+    portENTER_CRITICAL_SAFE(&_spinlock);
+    int bank = _current;
+    if (bank >= 0) {
+        _users[bank]++;
+    }
+    portEXIT_CRITICAL_SAFE(&_spinlock);
+    return bank;
+}
+
+void lcd_color_lut::release(int bank)
+{
+    if (bank < 0) {
+        return;
+    }
+    portENTER_CRITICAL_SAFE(&_spinlock);
+    _users[bank]--;
+    portEXIT_CRITICAL_SAFE(&_spinlock);
+}
+
+esp_err_t lcd_color_lut::set(const uint8_t r[32], const uint8_t g[64], const uint8_t b[32])
+{
+    ESP_RETURN_ON_FALSE(r && g && b, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+
+    // 写不在用的那一组；只有上一次切换前开始的绘制还没结束时才需要等
+    int bank = _current == 0 ? 1 : 0;
+    for (;;) {
+        portENTER_CRITICAL(&_spinlock);
+        bool busy = _users[bank] != 0;
+        portEXIT_CRITICAL(&_spinlock);
+        if (!busy) {
+            break;
+        }
+        vTaskDelay(1);
+    }
+
+    lcd_color_lut_table_t *t = &_banks[bank];
+    for (int i = 0; i < 32; i++) {
+        t->r[i] = (uint16_t)(r[i] & 0x1F) << 11;
+        t->b[i] = b[i] & 0x1F;
+    }
+    for (int i = 0; i < 64; i++) {
+        t->g[i] = (uint16_t)(g[i] & 0x3F) << 5;
+    }
+
+    portENTER_CRITICAL(&_spinlock);
+    _current = bank;
+    portEXIT_CRITICAL(&_spinlock);
+    return ESP_OK;
+}
+
+esp_err_t lcd_color_lut::set_gamma(float r, float g, float b)
+{
+    ESP_RETURN_ON_FALSE(r > 0 && g > 0 && b > 0, ESP_ERR_INVALID_ARG, TAG, "gamma must be positive");
+
+    uint8_t lr[32], lg[64], lb[32];
+    for (int i = 0; i < 32; i++) {
+        lr[i] = (uint8_t)lroundf(powf(i / 31.0f, r) * 31);
+        lb[i] = (uint8_t)lroundf(powf(i / 31.0f, b) * 31);
+    }
+    for (int i = 0; i < 64; i++) {
+        lg[i] = (uint8_t)lroundf(powf(i / 63.0f, g) * 63);
+    }
+    return set(lr, lg, lb);
+}
+
+void lcd_color_lut::clear()
+{
+    portENTER_CRITICAL(&_spinlock);
+    _current = -1;
+    portEXIT_CRITICAL(&_spinlock);
+}
+
+bool lcd_color_lut::active()
+{
+    return _current >= 0;
+}
+
+uint16_t lcd_color_lut::map(uint16_t color)
+{
+    int bank = acquire();
+    if (bank < 0) {
+        return color;
+    }
+    color = lcd_color_lut_lookup(&_banks[bank], color);
+    release(bank);
+    return color;
+}
+
+const lcd_color_lut_table_t *lcd_color_lut::acquire_table()
+{
+    int bank = acquire();
+    return bank < 0 ? NULL : &_banks[bank];
+}
+
+void lcd_color_lut::release_table(const lcd_color_lut_table_t *table)
+{
+    if (table) {
+        release(table - _banks);
+    }
+}
+
+void lcd_color_lut::convert(const lcd_color_lut_table_t *t, uint16_t *d, const uint16_t *s, uint16_t w)
+{
+    uint16_t col = 0;
+    // 源和目标同为 4 字节对齐时一次读写两个像素，三张表各查两次；读写用 memcpy，
+    // 不违反严格别名，编译器在地址对齐时生成单条 32 位访问
+    if (((uintptr_t)s & 3) == ((uintptr_t)d & 3)) {
+        if (((uintptr_t)s & 3) && w) {
+            d[0] = lcd_color_lut_lookup(t, s[0]);
+            col = 1;
+        }
+        for (; col + 2 <= w; col += 2) {
+            uint32_t c;
+            memcpy(&c, &s[col], sizeof(c));
+            uint32_t lo = t->r[(c >> 11) & 0x1F] | t->g[(c >> 5) & 0x3F] | t->b[c & 0x1F];
+            uint32_t hi = t->r[c >> 27] | t->g[(c >> 21) & 0x3F] | t->b[(c >> 16) & 0x1F];
+            c = lo | (hi << 16);
+            memcpy(&d[col], &c, sizeof(c));
+        }
+    }
+    for (; col < w; col++) {
+        d[col] = lcd_color_lut_lookup(t, s[col]);
+    }
+}
+
+void lcd_color_lut::apply(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint16_t w,
+                          uint16_t h, lcd_stats_t *stats)
+{
+    int bank = acquire();
+    int64_t start = esp_timer_get_time();
+
+    for (uint16_t row = 0; row < h; row++) {
+        const uint16_t *s = src + (uint32_t)row * src_stride;
+        uint16_t *d = dst + (uint32_t)row * dst_stride;
+        if (bank < 0) {
+            if (d != s) {
+                memcpy(d, s, (size_t)w * sizeof(uint16_t));
+            }
+            continue;
+        }
+        convert(&_banks[bank], d, s, w);
+    }
+
+    release(bank);
+    if (stats && bank >= 0) {
+        stats->color_lut_pixels += (uint32_t)w * h;
+        stats->color_lut_us += esp_timer_get_time() - start;
+    }
+}
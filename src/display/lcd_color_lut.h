@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "lcd_stats.h"
+
+/**
+ * @brief One bank of correction tables, each entry already shifted into place
+ */
+typedef struct {
+    uint16_t r[32];
+    uint16_t g[64];
+    uint16_t b[32];
+} lcd_color_lut_table_t;
+
+static inline uint16_t lcd_color_lut_lookup(const lcd_color_lut_table_t *t, uint16_t c)
+{
+    return t->r[c >> 11] | t->g[(c >> 5) & 0x3F] | t->b[c & 0x1F];
+}
+
+/**
+ * @brief Per-channel colour correction for RGB565, applied while pixels are written
+ *
+ * Tables map each 5/6/5-bit channel to a corrected value, e.g. to match panels from different
+ * glass batches without touching the driver IC's gamma registers. Two table banks are kept: `set()`
+ * fills the one not in use and then publishes it, so a draw running on another core keeps using a
+ * consistent table and never waits for the update. Only a second `set()` racing a draw that still
+ * uses the older bank waits for that draw to finish. Call `set()` and `clear()` from one task.
+ *
+ * Writers that cannot correct in one pass over a rectangle, such as blends, hold a bank with
+ * `acquire_table()` for the whole draw and map their source pixels with `lcd_color_lut_lookup()`.
+ */
+class lcd_color_lut
+{
+public:
+    lcd_color_lut();
+
+    esp_err_t set(const uint8_t r[32], const uint8_t g[64], const uint8_t b[32]);
+    esp_err_t set_gamma(float r, float g, float b);
+    void clear();
+    bool active();
+    uint16_t map(uint16_t color);
+    void apply(uint16_t *dst, uint32_t dst_stride, const uint16_t *src, uint32_t src_stride, uint16_t w, uint16_t h,
+               lcd_stats_t *stats);
+    const lcd_color_lut_table_t *acquire_table();
+    void release_table(const lcd_color_lut_table_t *table);
+    static void convert(const lcd_color_lut_table_t *table, uint16_t *dst, const uint16_t *src, uint16_t w);
+
+private:
+    int acquire();
+    void release(int bank);
+
+    lcd_color_lut_table_t _banks[2];
+    uint8_t _users[2];
+    int8_t _current;     /*!< Bank in use, -1 when correction is off */
+    portMUX_TYPE _spinlock;
+};
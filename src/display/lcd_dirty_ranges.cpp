@@ -0,0 +1,147 @@
+#include <string.h>
+
+#include "lcd_dirty_ranges.h"
+
+lcd_dirty_ranges::lcd_dirty_ranges()
+{
+    _num = 0;
+    _size = 0;
+    _line = 1;
+    _gap = 0;
+    _dirty = 0;
+    _full_percent = LCD_DIRTY_FULL_PERCENT;
+    _full = false;
+}
+
+void lcd_dirty_ranges::begin(size_t size, size_t line_size, size_t merge_gap, uint8_t full_percent)
+{
+    _size = size;
+    _line = line_size ? line_size : 1;
+    _gap = merge_gap;
+    _full_percent = full_percent;
+    clear();
+}
+
+void lcd_dirty_ranges::add(size_t offset, size_t len)
+{
+    if (_full || !len || offset >= _size) {
+        return;
+    }
+
+    // 扩到整行：写回以缓存行为单位，同一行的两段本来就是一次写回
+    size_t start = offset / _line * _line;
+    size_t end = offset + len < _size ? offset + len : _size;
+    end = (end + _line - 1) / _line * _line;
+    if (end > _size) {
+        end = _size;
+    }
+
+    // 从尾部往前找：按行递增写入时新范围总是落在最后，查找是 O(1)
+    size_t i = _num;
+    while (i > 0 && _ranges[i - 1].end + _gap >= start) {
+        i--;
+    }
+    // [i, j) 是与新范围相交或足够近、要并进来的那些
+    size_t j = i;
+    while (j < _num && _ranges[j].start <= end + _gap) {
+        start = _ranges[j].start < start ? _ranges[j].start : start;
+        end = _ranges[j].end > end ? _ranges[j].end : end;
+        _dirty -= _ranges[j].end - _ranges[j].start;
+        j++;
+    }
+
+    if (j == i) {
+        memmove(&_ranges[i + 1], &_ranges[i], (_num - i) * sizeof(range_t));
+        _num++;
+    } else if (j > i + 1) {
+        memmove(&_ranges[i + 1], &_ranges[j], (_num - j) * sizeof(range_t));
+        _num -= j - i - 1;
+    }
+    _ranges[i].start = start;
+    _ranges[i].end = end;
+    _dirty += end - start;
+
+    if (_num > LCD_DIRTY_MAX_RANGES) {
+        merge_closest();
+    }
+    if (_dirty * 100 >= _size * _full_percent) {
+        _full = true;
+        _num = 0;
+        _dirty = _size;
+    }
+}
+
+void lcd_dirty_ranges::add_rect(size_t offset, size_t row_bytes, size_t stride_bytes, uint32_t rows)
+{
+    if (!rows) {
+        return;
+    }
+    if (row_bytes >= stride_bytes) {
+        // 整行宽度：各行首尾相接，一段即可
+        add(offset, (rows - 1) * stride_bytes + row_bytes);
+        return;
+    }
+    for (uint32_t row = 0; row < rows && !_full; row++) {
+        add(offset + row * stride_bytes, row_bytes);
+    }
+}
+
+void lcd_dirty_ranges::merge_closest()
+{
+    size_t best = 0;
+    size_t best_gap = (size_t)-1;
+
+    for (size_t i = 0; i + 1 < _num; i++) {
+        size_t gap = _ranges[i + 1].start - _ranges[i].end;
+        if (gap < best_gap) {
+            best_gap = gap;
+            best = i;
+        }
+    }
+    _dirty += best_gap;
+    _ranges[best].end = _ranges[best + 1].end;
+    memmove(&_ranges[best + 1], &_ranges[best + 2], (_num - best - 2) * sizeof(range_t));
+    _num--;
+}
+
+bool lcd_dirty_ranges::empty() const
+{
+    return !_full && !_num;
+}
+
+bool lcd_dirty_ranges::full() const
+{
+    return _full;
+}
+
+size_t lcd_dirty_ranges::count() const
+{
+    return _full ? 1 : _num;
+}
+
+size_t lcd_dirty_ranges::dirty_bytes() const
+{
+    return _dirty;
+}
+
+size_t lcd_dirty_ranges::flush(lcd_dirty_sync_fn_t fn, void *ctx)
+{
+    size_t calls = count();
+
+    if (_full) {
+        fn(0, _size, ctx);
+    } else {
+        for (size_t i = 0; i < _num; i++) {
+            fn(_ranges[i].start, _ranges[i].end - _ranges[i].start, ctx);
+        }
+    }
+    clear();
+    return calls;
+}
+
+void lcd_dirty_ranges::clear()
+{
+    _num = 0;
+    _dirty = 0;
+    _full = false;
+}
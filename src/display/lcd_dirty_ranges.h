@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * 帧缓冲里被 CPU 写过、还没写回的缓存行范围。只依赖标准头文件，可以直接在主机上编译测试。
+ */
+
+#define LCD_DIRTY_MAX_RANGES 32
+#define LCD_DIRTY_MERGE_GAP 2048     // 间隔不超过这么多字节的两段合并：每次同步的固定开销大致抵得上写回这么多干净行
+#define LCD_DIRTY_FULL_PERCENT 50    // 要同步的字节数超过缓冲区的这个比例时整块同步
+
+/**
+ * @brief Called once per range to write back, `offset` and `size` in bytes from the buffer start
+ */
+typedef void (*lcd_dirty_sync_fn_t)(size_t offset, size_t size, void *ctx);
+
+/**
+ * @brief Sorted, disjoint, cache-line aligned byte ranges of a buffer waiting to be written back
+ *
+ * Ranges closer than `merge_gap` bytes are merged, so a partial-width rectangle becomes one range
+ * instead of one per row. When more than LCD_DIRTY_MAX_RANGES are needed, the two closest ranges are
+ * merged. Once the ranges cover `full_percent` of the buffer, tracking stops and `flush()` syncs the
+ * whole buffer in one call.
+ */
+class lcd_dirty_ranges
+{
+public:
+    lcd_dirty_ranges();
+
+    void begin(size_t size, size_t line_size, size_t merge_gap = LCD_DIRTY_MERGE_GAP,
+               uint8_t full_percent = LCD_DIRTY_FULL_PERCENT);
+    void add(size_t offset, size_t len);
+    void add_rect(size_t offset, size_t row_bytes, size_t stride_bytes, uint32_t rows);
+    bool empty() const;
+    bool full() const;
+    size_t count() const;
+    size_t dirty_bytes() const;
+    size_t flush(lcd_dirty_sync_fn_t fn, void *ctx);
+    void clear();
+
+private:
+    typedef struct {
+        size_t start;
+        size_t end;
+    } range_t;
+
+    void merge_closest();
+
+    range_t _ranges[LCD_DIRTY_MAX_RANGES + 1];  // 多一格，插入后再合并回上限
+    size_t _num;
+    size_t _size;
+    size_t _line;
+    size_t _gap;
+    size_t _dirty;
+    uint8_t _full_percent;
+    bool _full;
+};
@@ -0,0 +1,241 @@
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_display_list.h"
+
+static const char *TAG = "lcd_display_list";
+
+static inline bool overlap(uint16_t ax, uint16_t ay, uint16_t bx, uint16_t by, uint16_t w0, uint16_t h0, uint16_t w1, uint16_t h1)
+{
+    return ax < bx + w1 && bx < ax + w0 && ay < by + h1 && by < ay + h0;
+}
+
+static inline bool contains(const lcd_blit_desc_t *outer, const lcd_blit_desc_t *inner)
+{
+    return inner->x >= outer->x && inner->y >= outer->y &&
+           inner->x + inner->w <= outer->x + outer->w && inner->y + inner->h <= outer->y + outer->h;
+}
+
+lcd_display_list::lcd_display_list()
+{
+    _blit = NULL;
+    _stats = NULL;
+    _ops = NULL;
+    _capacity = 0;
+    _num = 0;
+}
+
+lcd_display_list::~lcd_display_list()
+{
+    end();
+}
+
+esp_err_t lcd_display_list::begin(lcd_blit *blit, lcd_stats_t *stats, size_t capacity)
+{
+    ESP_RETURN_ON_FALSE(blit && capacity, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(!_ops, ESP_ERR_INVALID_STATE, TAG, "already started");
+
+    _ops = (lcd_blit_op_t *)heap_caps_malloc(capacity * sizeof(lcd_blit_op_t), MALLOC_CAP_INTERNAL);
+    ESP_RETURN_ON_FALSE(_ops, ESP_ERR_NO_MEM, TAG, "no mem for %u operations", (unsigned)capacity);
+
+    _blit = blit;
+    _stats = stats;
+    _capacity = capacity;
+    _num = 0;
+    return ESP_OK;
+}
+
+void lcd_display_list::end()
+{
+    if (_ops) {
+        heap_caps_free(_ops);
+        _ops = NULL;
+    }
+    _capacity = 0;
+    _num = 0;
+}
+
+void lcd_display_list::clear()
+{
+    _num = 0;
+}
+
+size_t lcd_display_list::size()
+{
+    return _num;
+}
+
+bool lcd_display_list::fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
+{
+    if (!push(LCD_BLIT_OP_FILL, NULL, 0, 0, 0, x, y, w, h)) {
+        return false;
+    }
+    _ops[_num - 1].color = color;
+    return true;
+}
+
+bool lcd_display_list::blit(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                            uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    return src && push(LCD_BLIT_OP_BLIT, src, src_stride, src_x, src_y, x, y, w, h);
+}
+
+bool lcd_display_list::blend(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                             uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t alpha)
+{
+    // 全透明不用画，不透明就是普通拷贝
+    if (!alpha) {
+        return true;
+    }
+    if (!src || !push(alpha == 0xFF ? LCD_BLIT_OP_BLIT : LCD_BLIT_OP_BLEND, src, src_stride, src_x, src_y, x, y, w, h)) {
+        return false;
+    }
+    _ops[_num - 1].alpha = alpha;
+    return true;
+}
+
+bool lcd_display_list::copy(uint16_t src_x, uint16_t src_y, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    if (src_x == x && src_y == y) {
+        return true;
+    }
+    return push(LCD_BLIT_OP_COPY, NULL, 0, src_x, src_y, x, y, w, h);
+}
+
+bool lcd_display_list::push(uint8_t type, const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+                            uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    if (!_ops || _num >= _capacity) {
+        ESP_LOGW(TAG, "display list full");
+        return false;
+    }
+    if (!w || !h) {
+        return true;
+    }
+
+    lcd_blit_op_t *op = &_ops[_num++];
+    memset(op, 0, sizeof(*op));
+    op->type = type;
+    op->rect.src = src;
+    op->rect.src_stride = src_stride;
+    op->rect.src_x = src_x;
+    op->rect.src_y = src_y;
+    op->rect.x = x;
+    op->rect.y = y;
+    op->rect.w = w;
+    op->rect.h = h;
+    return true;
+}
+
+bool lcd_display_list::depends(const lcd_blit_op_t *a, const lcd_blit_op_t *b)
+{
+    const lcd_blit_desc_t *ra = &a->rect;
+    const lcd_blit_desc_t *rb = &b->rect;
+
+    if (a->type == LCD_BLIT_OP_NOP || b->type == LCD_BLIT_OP_NOP) {
+        return false;
+    }
+    // 写写重叠，或者一方从帧缓冲读取的区域被另一方写入（混合读目标区域本身，已包含在写写重叠里）
+    if (overlap(ra->x, ra->y, rb->x, rb->y, ra->w, ra->h, rb->w, rb->h)) {
+        return true;
+    }
+    if (a->type == LCD_BLIT_OP_COPY && overlap(ra->src_x, ra->src_y, rb->x, rb->y, ra->w, ra->h, rb->w, rb->h)) {
+        return true;
+    }
+    if (b->type == LCD_BLIT_OP_COPY && overlap(ra->x, ra->y, rb->src_x, rb->src_y, ra->w, ra->h, rb->w, rb->h)) {
+        return true;
+    }
+    return false;
+}
+
+void lcd_display_list::sort_by_row()
+{
+    // 稳定的插入排序：操作只能越过与它互不相关的操作向前移动，画家顺序保持不变
+    for (size_t i = 1; i < _num; i++) {
+        lcd_blit_op_t op = _ops[i];
+        size_t j = i;
+        while (j > 0 && _ops[j - 1].rect.y > op.rect.y && !depends(&_ops[j - 1], &op)) {
+            _ops[j] = _ops[j - 1];
+            j--;
+        }
+        _ops[j] = op;
+    }
+}
+
+void lcd_display_list::merge_fills()
+{
+    for (size_t i = 0; i < _num; i++) {
+        lcd_blit_op_t *a = &_ops[i];
+        if (a->type != LCD_BLIT_OP_FILL) {
+            continue;
+        }
+
+        for (size_t j = i + 1; j < _num && j <= i + LCD_DLIST_MERGE_WINDOW; j++) {
+            lcd_blit_op_t *b = &_ops[j];
+            if (b->type != LCD_BLIT_OP_FILL) {
+                continue;
+            }
+
+            // 中间的操作与 a、b 是否相关，决定 b 能否提前到 a 的位置、a 能否被 b 覆盖
+            bool a_free = true;
+            bool b_free = true;
+            for (size_t k = i + 1; k < j; k++) {
+                a_free = a_free && !depends(&_ops[k], a);
+                b_free = b_free && !depends(&_ops[k], b);
+            }
+
+            lcd_blit_desc_t *ra = &a->rect;
+            lcd_blit_desc_t *rb = &b->rect;
+            if (a_free && contains(rb, ra)) {
+                // a 被后面的填充完全盖住
+                a->type = LCD_BLIT_OP_NOP;
+                break;
+            }
+            if (!b_free || a->color != b->color) {
+                continue;
+            }
+            if (contains(ra, rb)) {
+                b->type = LCD_BLIT_OP_NOP;
+            } else if (ra->x == rb->x && ra->w == rb->w && ra->y <= rb->y + rb->h && rb->y <= ra->y + ra->h) {
+                // 同一列上下相接或重叠，合并成一个更高的矩形
+                uint16_t y1 = ra->y + ra->h > rb->y + rb->h ? ra->y + ra->h : rb->y + rb->h;
+                ra->y = ra->y < rb->y ? ra->y : rb->y;
+                ra->h = y1 - ra->y;
+                b->type = LCD_BLIT_OP_NOP;
+            } else if (ra->y == rb->y && ra->h == rb->h && ra->x <= rb->x + rb->w && rb->x <= ra->x + ra->w) {
+                // 同一行左右相接或重叠，合并成一个更宽的矩形
+                uint16_t x1 = ra->x + ra->w > rb->x + rb->w ? ra->x + ra->w : rb->x + rb->w;
+                ra->x = ra->x < rb->x ? ra->x : rb->x;
+                ra->w = x1 - ra->x;
+                b->type = LCD_BLIT_OP_NOP;
+            }
+        }
+    }
+}
+
+esp_err_t lcd_display_list::execute()
+{
+    ESP_RETURN_ON_FALSE(_ops, ESP_ERR_INVALID_STATE, TAG, "not started");
+    if (!_num) {
+        return ESP_OK;
+    }
+
+    sort_by_row();
+    merge_fills();
+
+    if (_stats) {
+        for (size_t i = 0; i < _num; i++) {
+            if (_ops[i].type != LCD_BLIT_OP_NOP) {
+                _stats->draw_calls++;
+                _stats->draw_pixels += (uint32_t)_ops[i].rect.w * _ops[i].rect.h;
+            }
+        }
+    }
+
+    esp_err_t ret = _blit->run(_ops, _num);
+    _num = 0;
+    return ret;
+}
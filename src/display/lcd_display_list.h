@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdio.h>
+#include "lcd_blit.h"
+#include "lcd_stats.h"
+
+#define LCD_DLIST_MERGE_WINDOW 8 // 合并填充时向后查看的操作数
+
+/**
+ * @brief Recorded list of framebuffer operations executed in one pass
+ *
+ * Fills, blits, blends and in-framebuffer copies are recorded into a fixed-size array. `execute()`
+ * reorders independent operations by destination row, merges fills that form a single rectangle
+ * and drops fills hidden by a later fill, then hands the whole list to `lcd_blit`, which queues
+ * it as back-to-back PPA transactions (or runs it on the CPU). Operations that touch the same
+ * pixels never change their relative order.
+ */
+class lcd_display_list
+{
+public:
+    lcd_display_list();
+    ~lcd_display_list();
+
+    esp_err_t begin(lcd_blit *blit, lcd_stats_t *stats, size_t capacity);
+    void end();
+    void clear();
+    size_t size();
+    bool fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color);
+    bool blit(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+              uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    bool blend(const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+               uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t alpha);
+    bool copy(uint16_t src_x, uint16_t src_y, uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    esp_err_t execute();
+
+private:
+    bool push(uint8_t type, const uint16_t *src, uint16_t src_stride, uint16_t src_x, uint16_t src_y,
+              uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    static bool depends(const lcd_blit_op_t *a, const lcd_blit_op_t *b);
+    void sort_by_row();
+    void merge_fills();
+
+    lcd_blit *_blit;
+    lcd_stats_t *_stats;
+    lcd_blit_op_t *_ops;
+    size_t _capacity;
+    size_t _num;
+};
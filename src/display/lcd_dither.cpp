@@ -0,0 +1,75 @@
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_dither.h"
+
+static const char *TAG = "lcd_dither";
+
+// 三个通道各占 11 位宽的一段，一次加法同时给三个通道加上阈值
+#define DITHER_R_SHIFT 0
+#define DITHER_G_SHIFT 11
+#define DITHER_B_SHIFT 22
+
+static const uint8_t s_bayer[8][8] = {
+    { 0, 32,  8, 40,  2, 34, 10, 42},
+    {48, 16, 56, 24, 50, 18, 58, 26},
+    {12, 44,  4, 36, 14, 46,  6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22},
+    { 3, 35, 11, 43,  1, 33,  9, 41},
+    {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47,  7, 39, 13, 45,  5, 37},
+    {63, 31, 55, 23, 61, 29, 53, 21},
+};
+
+// 8 位分量按面板的展开方式（q * 255 / 31）换算到 1/8 个 5 位台阶为单位，最大 248，加上阈值 0~7 不会溢出；G 同理
+struct dither_tables {
+    uint8_t to5[256];
+    uint8_t to6[256];
+
+    constexpr dither_tables() : to5(), to6()
+    {
+        for (int c = 0; c < 256; c++) {
+            to5[c] = (c * 31 * 8 + 127) / 255;
+            to6[c] = (c * 63 * 4 + 127) / 255;
+        }
+    }
+};
+
+static constexpr dither_tables s_tables;
+
+esp_err_t lcd_dither_rgb888(uint16_t *dst, uint32_t dst_stride, const uint8_t *src, uint32_t src_stride,
+                            uint16_t w, uint16_t h, uint16_t x, uint16_t y, lcd_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(dst && src && dst_stride >= w && src_stride >= (uint32_t)w * 3, ESP_ERR_INVALID_ARG, TAG,
+                        "invalid arguments");
+
+    int64_t start = esp_timer_get_time();
+    for (uint16_t row = 0; row < h; row++) {
+        // 本行 8 列的阈值打包好：R/B 截掉 3 位，阈值 0~7；G 截掉 2 位，阈值 0~3
+        uint32_t dither[8];
+        const uint8_t *m = s_bayer[(y + row) & 7];
+        for (int i = 0; i < 8; i++) {
+            uint32_t t = m[(x + i) & 7];
+            dither[i] = ((t >> 3) << DITHER_R_SHIFT) | ((t >> 4) << DITHER_G_SHIFT) | ((t >> 3) << DITHER_B_SHIFT);
+        }
+
+        const uint8_t *s = src + (uint32_t)row * src_stride;
+        uint16_t *d = dst + (uint32_t)row * dst_stride;
+        for (uint16_t col = 0; col < w; col++, s += 3) {
+            uint32_t c = ((uint32_t)s_tables.to5[s[2]] << DITHER_R_SHIFT) |
+                         ((uint32_t)s_tables.to6[s[1]] << DITHER_G_SHIFT) |
+                         ((uint32_t)s_tables.to5[s[0]] << DITHER_B_SHIFT);
+            c += dither[col & 7];
+            d[col] = ((c >> (DITHER_R_SHIFT + 3)) & 0x1F) << 11 | ((c >> (DITHER_G_SHIFT + 2)) & 0x3F) << 5 |
+                     ((c >> (DITHER_B_SHIFT + 3)) & 0x1F);
+        }
+    }
+
+    if (stats) {
+        stats->dither_pixels += (uint32_t)w * h;
+        stats->dither_us += esp_timer_get_time() - start;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lcd_stats.h"
+
+/**
+ * @brief Convert an RGB888 rectangle to RGB565 with 8x8 ordered (Bayer) dithering
+ *
+ * The source is 3 bytes per pixel, B first, the same layout as the RGB888 font surface. The
+ * threshold matrix is indexed by screen position, given as (`x`, `y`) of the top-left pixel, so
+ * partial updates of a gradient line up with what is already on screen. All three channels are
+ * dithered and rounded with one 32-bit add per pixel.
+ *
+ * @param dst_stride Destination row length in pixels
+ * @param src_stride Source row length in bytes
+ * @param stats Optional, receives the pixel count and conversion time
+ */
+esp_err_t lcd_dither_rgb888(uint16_t *dst, uint32_t dst_stride, const uint8_t *src, uint32_t src_stride,
+                            uint16_t w, uint16_t h, uint16_t x, uint16_t y, lcd_stats_t *stats);
@@ -0,0 +1,204 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_mipi_dsi.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_events.h"
+#include "lcd_trace.h"
+
+static const char *TAG = "lcd_events";
+
+lcd_events::lcd_events()
+{
+    _panel = NULL;
+    _draw_lock = NULL;
+    _idle = NULL;
+    _spinlock = portMUX_INITIALIZER_UNLOCKED;
+    _pending_head = 0;
+    _pending_tail = 0;
+    _trans_done_num = 0;
+    _refresh_done_num = 0;
+    _before_draw.cb = NULL;
+    _before_draw.user_ctx = NULL;
+}
+
+esp_err_t lcd_events::begin(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid panel");
+
+    _draw_lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(_draw_lock, ESP_ERR_NO_MEM, TAG, "no mem for draw lock");
+    _idle = xEventGroupCreate();
+    ESP_RETURN_ON_FALSE(_idle, ESP_ERR_NO_MEM, TAG, "no mem for idle event group");
+    xEventGroupSetBits(_idle, LCD_EVENTS_IDLE_BIT);
+    _panel = panel;
+
+    esp_lcd_dpi_panel_event_callbacks_t cbs = {
+        .on_color_trans_done = on_color_trans_done,
+        .on_refresh_done = on_refresh_done,
+    };
+    return esp_lcd_dpi_panel_register_event_callbacks(panel, &cbs, this);
+}
+
+esp_err_t lcd_events::draw(int x_start, int y_start, int x_end, int y_end, const void *color_data,
+                           lcd_event_cb_t done_cb, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(_panel, ESP_ERR_INVALID_STATE, TAG, "not started");
+
+    xSemaphoreTake(_draw_lock, portMAX_DELAY);
+
+    // DMA 写帧缓冲前先让 CPU 写过的缓存行落到内存，否则之后的写回会盖掉 DMA 的结果
+    if (_before_draw.cb) {
+        _before_draw.cb(_before_draw.user_ctx);
+    }
+
+    // 先登记完成回调再提交，面板在颜色数据位于帧缓冲时会同步触发回调
+    portENTER_CRITICAL(&_spinlock);
+    uint8_t slot = _pending_tail;
+    uint8_t next = (_pending_tail + 1) % LCD_EVENTS_MAX_PENDING;
+    bool full = (next == _pending_head);
+    if (!full) {
+        _pending[_pending_tail].cb = done_cb;
+        _pending[_pending_tail].user_ctx = user_ctx;
+        _pending_tail = next;
+    }
+    portEXIT_CRITICAL(&_spinlock);
+
+    if (full) {
+        xSemaphoreGive(_draw_lock);
+        ESP_LOGE(TAG, "too many pending draws");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // 是否空闲以队列为准，空闲位只负责唤醒 wait_idle()。中断里的置位由定时器任务延后执行，可能在这里清位之后
+    // 才生效，留下队列非空时的置位；等待者醒来会按队列重新判断，这一笔完成、队列排空时也会再次置位，不会漏掉唤醒
+    xEventGroupClearBits(_idle, LCD_EVENTS_IDLE_BIT);
+
+    // 队列槽位号即异步跨度的 id，同一时刻在途的搬运不会重号
+    LCD_TRACE_ASYNC_BEGIN("dma", slot);
+    esp_err_t ret = esp_lcd_panel_draw_bitmap(_panel, x_start, y_start, x_end, y_end, color_data);
+    if (ret != ESP_OK) {
+        LCD_TRACE_ASYNC_END("dma", slot);
+        // 提交失败不会有完成事件，撤销刚才登记的回调
+        portENTER_CRITICAL(&_spinlock);
+        _pending_tail = (_pending_tail + LCD_EVENTS_MAX_PENDING - 1) % LCD_EVENTS_MAX_PENDING;
+        bool idle = (_pending_head == _pending_tail);
+        portEXIT_CRITICAL(&_spinlock);
+        if (idle) {
+            xEventGroupSetBits(_idle, LCD_EVENTS_IDLE_BIT);
+        }
+    }
+
+    xSemaphoreGive(_draw_lock);
+    return ret;
+}
+
+esp_err_t lcd_events::wait_idle(TickType_t timeout)
+{
+    ESP_RETURN_ON_FALSE(_panel, ESP_ERR_INVALID_STATE, TAG, "not started");
+
+    TimeOut_t start;
+    vTaskSetTimeOutState(&start);
+    for (;;) {
+        // 以队列为准，在锁内判断；事件位只负责唤醒，等待时不清除，置位时所有等待者都会醒来
+        portENTER_CRITICAL(&_spinlock);
+        bool idle = (_pending_head == _pending_tail);
+        portEXIT_CRITICAL(&_spinlock);
+        if (idle) {
+            return ESP_OK;
+        }
+        // 中断置位和新提交清位之间有先后，位可能是刚排空时留下的；清掉后再查一次，不会漏掉之后的置位
+        xEventGroupClearBits(_idle, LCD_EVENTS_IDLE_BIT);
+        portENTER_CRITICAL(&_spinlock);
+        idle = (_pending_head == _pending_tail);
+        portEXIT_CRITICAL(&_spinlock);
+        if (idle) {
+            return ESP_OK;
+        }
+        if (xTaskCheckForTimeOut(&start, &timeout) == pdTRUE) {
+            return ESP_ERR_TIMEOUT;
+        }
+        xEventGroupWaitBits(_idle, LCD_EVENTS_IDLE_BIT, pdFALSE, pdTRUE, timeout);
+    }
+}
+
+esp_err_t lcd_events::add_trans_done_listener(lcd_event_cb_t cb, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(cb, ESP_ERR_INVALID_ARG, TAG, "invalid callback");
+    ESP_RETURN_ON_FALSE(_trans_done_num < LCD_EVENTS_MAX_LISTENERS, ESP_ERR_NO_MEM, TAG, "too many listeners");
+
+    _trans_done[_trans_done_num].cb = cb;
+    _trans_done[_trans_done_num].user_ctx = user_ctx;
+    _trans_done_num = _trans_done_num + 1;
+    return ESP_OK;
+}
+
+esp_err_t lcd_events::add_refresh_done_listener(lcd_event_cb_t cb, void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(cb, ESP_ERR_INVALID_ARG, TAG, "invalid callback");
+    ESP_RETURN_ON_FALSE(_refresh_done_num < LCD_EVENTS_MAX_LISTENERS, ESP_ERR_NO_MEM, TAG, "too many listeners");
+
+    _refresh_done[_refresh_done_num].cb = cb;
+    _refresh_done[_refresh_done_num].user_ctx = user_ctx;
+    _refresh_done_num = _refresh_done_num + 1;
+    return ESP_OK;
+}
+
+void lcd_events::set_before_draw(lcd_event_cb_t cb, void *user_ctx)
+{
+    _before_draw.user_ctx = user_ctx;
+    _before_draw.cb = cb;
+}
+
+bool lcd_events::on_color_trans_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *edata, void *user_ctx)
+{
+    lcd_events *self = (lcd_events *)user_ctx;
+    bool need_yield = false;
+    listener_t done = {NULL, NULL};
+    bool idle = false;
+
+    portENTER_CRITICAL_SAFE(&self->_spinlock);
+    if (self->_pending_head != self->_pending_tail) {
+        LCD_TRACE_ASYNC_END("dma", self->_pending_head);
+        done = self->_pending[self->_pending_head];
+        self->_pending_head = (self->_pending_head + 1) % LCD_EVENTS_MAX_PENDING;
+        idle = (self->_pending_head == self->_pending_tail);
+    }
+    portEXIT_CRITICAL_SAFE(&self->_spinlock);
+
+    if (idle) {
+        // 颜色数据已在帧缓冲里时，面板会在 draw() 的任务上下文里同步调用本回调，FromISR 版本只能在中断里用
+        if (xPortInIsrContext()) {
+            BaseType_t woken = pdFALSE;
+            xEventGroupSetBitsFromISR(self->_idle, LCD_EVENTS_IDLE_BIT, &woken);
+            need_yield |= (woken == pdTRUE);
+        } else {
+            xEventGroupSetBits(self->_idle, LCD_EVENTS_IDLE_BIT);
+        }
+    }
+
+    if (done.cb) {
+        need_yield |= done.cb(done.user_ctx);
+    }
+    for (uint8_t i = 0; i < self->_trans_done_num; i++) {
+        need_yield |= self->_trans_done[i].cb(self->_trans_done[i].user_ctx);
+    }
+    return need_yield;
+}
+
+bool lcd_events::on_refresh_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *edata, void *user_ctx)
+{
+    lcd_events *self = (lcd_events *)user_ctx;
+    bool need_yield = false;
+
+    LCD_TRACE_INSTANT("refresh_done", 0);
+    for (uint8_t i = 0; i < self->_refresh_done_num; i++) {
+        need_yield |= self->_refresh_done[i].cb(self->_refresh_done[i].user_ctx);
+    }
+    return need_yield;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "esp_bit_defs.h"
+#include "esp_lcd_mipi_dsi.h"
+
+#define LCD_EVENTS_MAX_LISTENERS 4
+#define LCD_EVENTS_MAX_PENDING 8
+#define LCD_EVENTS_IDLE_BIT BIT(0)
+
+/**
+ * @brief Event callback, called from the DPI/DMA2D ISR
+ *
+ * @return true if a higher priority task has been woken
+ */
+typedef bool (*lcd_event_cb_t)(void *user_ctx);
+
+/**
+ * @brief Owner of the DPI panel event callbacks
+ *
+ * The DPI panel accepts a single callback set and a single user context, so every component that
+ * needs "color transfer done" or "refresh done" registers here instead. Draws submitted through
+ * `draw()` complete in FIFO order, which lets each caller get its own completion callback.
+ */
+class lcd_events
+{
+public:
+    lcd_events();
+
+    esp_err_t begin(esp_lcd_panel_handle_t panel);
+    esp_err_t draw(int x_start, int y_start, int x_end, int y_end, const void *color_data,
+                   lcd_event_cb_t done_cb = NULL, void *user_ctx = NULL);
+    esp_err_t wait_idle(TickType_t timeout = portMAX_DELAY);
+    esp_err_t add_trans_done_listener(lcd_event_cb_t cb, void *user_ctx);
+    esp_err_t add_refresh_done_listener(lcd_event_cb_t cb, void *user_ctx);
+    void set_before_draw(lcd_event_cb_t cb, void *user_ctx);
+
+private:
+    typedef struct {
+        lcd_event_cb_t cb;
+        void *user_ctx;
+    } listener_t;
+
+    static bool on_color_trans_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *edata, void *user_ctx);
+    static bool on_refresh_done(esp_lcd_panel_handle_t panel, esp_lcd_dpi_panel_event_data_t *edata, void *user_ctx);
+
+    esp_lcd_panel_handle_t _panel;
+    SemaphoreHandle_t _draw_lock;
+    EventGroupHandle_t _idle;  /*!< LCD_EVENTS_IDLE_BIT wakes every `wait_idle()` caller; the pending queue decides idleness */
+    portMUX_TYPE _spinlock;
+
+    listener_t _pending[LCD_EVENTS_MAX_PENDING];
+    volatile uint8_t _pending_head;
+    volatile uint8_t _pending_tail;
+
+    listener_t _trans_done[LCD_EVENTS_MAX_LISTENERS];
+    volatile uint8_t _trans_done_num;
+    listener_t _refresh_done[LCD_EVENTS_MAX_LISTENERS];
+    volatile uint8_t _refresh_done_num;
+    listener_t _before_draw;
+};
@@ -0,0 +1,403 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_font.h"
+
+static const char *TAG = "lcd_font";
+
+#define RGB565_SPREAD_MASK 0x07E0F81F     // G 移到高半字，R、B 留在低半字，各通道之间留出乘法进位空间
+
+lcd_font::lcd_font()
+{
+    _data = NULL;
+    _header = NULL;
+    _glyphs = NULL;
+    _kerns = NULL;
+    _atlas = NULL;
+    memset(_ascii, 0xFF, sizeof(_ascii));
+    memset(_glyph_cache, 0xFF, sizeof(_glyph_cache));
+    memset(_kern_cache, 0xFF, sizeof(_kern_cache));
+}
+
+esp_err_t lcd_font::begin(const void *data, size_t size)
+{
+    const lcd_font_header_t *header = (const lcd_font_header_t *)data;
+    ESP_RETURN_ON_FALSE(data && size >= sizeof(lcd_font_header_t), ESP_ERR_INVALID_ARG, TAG, "invalid font data");
+    ESP_RETURN_ON_FALSE(header->magic == LCD_FONT_MAGIC, ESP_ERR_INVALID_VERSION, TAG, "bad magic 0x%08lx",
+                        (unsigned long)header->magic);
+    ESP_RETURN_ON_FALSE(header->bpp == 4 || header->bpp == 8, ESP_ERR_NOT_SUPPORTED, TAG, "%d bpp not supported",
+                        header->bpp);
+    ESP_RETURN_ON_FALSE(header->size <= size && header->atlas_offset <= header->size &&
+                        header->glyphs_offset + (uint64_t)header->glyph_count * sizeof(lcd_font_glyph_t) <= header->size &&
+                        header->kern_offset + (uint64_t)header->kern_count * sizeof(lcd_font_kern_t) <= header->size,
+                        ESP_ERR_INVALID_SIZE, TAG, "truncated font");
+
+    // 一次性检查所有字形位图都在数据范围内，绘制时不再逐个检查
+    const lcd_font_glyph_t *glyphs = (const lcd_font_glyph_t *)((const uint8_t *)data + header->glyphs_offset);
+    uint32_t atlas_size = header->size - header->atlas_offset;
+    for (uint32_t i = 0; i < header->glyph_count; i++) {
+        uint32_t row_bytes = header->bpp == 4 ? (glyphs[i].width + 1) / 2 : glyphs[i].width;
+        if (glyphs[i].offset + (uint64_t)row_bytes * glyphs[i].height > atlas_size) {
+            ESP_LOGE(TAG, "glyph U+%04lX out of bounds", (unsigned long)glyphs[i].codepoint);
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    _data = (const uint8_t *)data;
+    _header = header;
+    _glyphs = glyphs;
+    _kerns = (const lcd_font_kern_t *)(_data + header->kern_offset);
+    _atlas = _data + header->atlas_offset;
+    memset(_glyph_cache, 0xFF, sizeof(_glyph_cache));
+    memset(_kern_cache, 0xFF, sizeof(_kern_cache));
+    for (uint32_t cp = 0; cp < 128; cp++) {
+        _ascii[cp] = find_glyph(cp);
+    }
+    ESP_LOGI(TAG, "%lu glyphs, %lu kerning pairs, %d bpp, line height %d", (unsigned long)header->glyph_count,
+             (unsigned long)header->kern_count, header->bpp, header->line_height);
+    return ESP_OK;
+}
+
+void lcd_font::end()
+{
+    _data = NULL;
+    _header = NULL;
+    _glyphs = NULL;
+    _kerns = NULL;
+    _atlas = NULL;
+}
+
+bool lcd_font::started()
+{
+    return _header != NULL;
+}
+
+uint8_t lcd_font::bpp()
+{
+    return _header ? _header->bpp : 0;
+}
+
+uint16_t lcd_font::line_height()
+{
+    return _header ? _header->line_height : 0;
+}
+
+int16_t lcd_font::ascent()
+{
+    return _header ? _header->ascent : 0;
+}
+
+int32_t lcd_font::find_glyph(uint32_t codepoint)
+{
+    int32_t lo = 0;
+    int32_t hi = (int32_t)_header->glyph_count - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (_glyphs[mid].codepoint == codepoint) {
+            return mid;
+        }
+        if (_glyphs[mid].codepoint < codepoint) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+int16_t lcd_font::find_kerning(uint32_t pair)
+{
+    int32_t lo = 0;
+    int32_t hi = (int32_t)_header->kern_count - 1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (_kerns[mid].pair == pair) {
+            return _kerns[mid].adjust;
+        }
+        if (_kerns[mid].pair < pair) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return 0;
+}
+
+const lcd_font_glyph_t *lcd_font::glyph(uint32_t codepoint)
+{
+    if (!_header) {
+        return NULL;
+    }
+
+    int32_t index;
+    if (codepoint < 128) {
+        index = _ascii[codepoint];
+    } else {
+        // 直接映射缓存，缺失的字形也缓存下来，避免反复二分查找
+        cache_entry_t *entry = &_glyph_cache[codepoint & (LCD_FONT_GLYPH_CACHE_SIZE - 1)];
+        if (entry->key != codepoint) {
+            entry->key = codepoint;
+            entry->value = find_glyph(codepoint);
+        }
+        index = entry->value;
+    }
+    return index >= 0 ? &_glyphs[index] : NULL;
+}
+
+int16_t lcd_font::kerning(const lcd_font_glyph_t *left, const lcd_font_glyph_t *right)
+{
+    if (!_header || !_header->kern_count || !left || !right) {
+        return 0;
+    }
+
+    uint32_t pair = (uint32_t)(left - _glyphs) << 16 | (uint32_t)(right - _glyphs);
+    cache_entry_t *entry = &_kern_cache[(pair ^ (pair >> 13)) & (LCD_FONT_KERN_CACHE_SIZE - 1)];
+    if (entry->key != pair) {
+        entry->key = pair;
+        entry->value = find_kerning(pair);
+    }
+    return entry->value;
+}
+
+const uint8_t *lcd_font::bitmap(const lcd_font_glyph_t *glyph)
+{
+    return glyph && _atlas ? _atlas + glyph->offset : NULL;
+}
+
+uint32_t lcd_font::next_codepoint(const char **utf8)
+{
+    const uint8_t *p = (const uint8_t *)*utf8;
+    uint32_t cp = p[0];
+    int extra = 0;
+
+    if (cp == 0) {
+        return 0;
+    }
+    if (cp >= 0xF0 && cp < 0xF8) {
+        cp &= 0x07;
+        extra = 3;
+    } else if (cp >= 0xE0) {
+        cp &= 0x0F;
+        extra = 2;
+    } else if (cp >= 0xC0) {
+        cp &= 0x1F;
+        extra = 1;
+    } else if (cp >= 0x80) {
+        // 孤立的续字节，按替换字符处理并跳过一个字节
+        *utf8 += 1;
+        return 0xFFFD;
+    }
+    for (int i = 1; i <= extra; i++) {
+        if ((p[i] & 0xC0) != 0x80) {
+            *utf8 += i;
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (p[i] & 0x3F);
+    }
+    *utf8 += 1 + extra;
+    return cp;
+}
+
+int32_t lcd_font::text_width(const char *utf8)
+{
+    int32_t width = 0;
+    int32_t pen = 0;
+    const lcd_font_glyph_t *prev = NULL;
+    uint32_t cp;
+
+    if (!_header || !utf8) {
+        return 0;
+    }
+    while ((cp = next_codepoint(&utf8)) != 0) {
+        if (cp == '\n') {
+            pen = 0;
+            prev = NULL;
+            continue;
+        }
+        const lcd_font_glyph_t *g = glyph(cp);
+        if (!g) {
+            g = glyph('?');
+            if (!g) {
+                prev = NULL;
+                continue;
+            }
+        }
+        pen += kerning(prev, g) + g->advance;
+        width = pen > width ? pen : width;
+        prev = g;
+    }
+    return width;
+}
+
+template <int BPP>
+static inline uint32_t alpha_at(const uint8_t *row, uint32_t col)
+{
+    if (BPP == 8) {
+        return row[col];
+    }
+    // 4 bpp 高半字节在前，扩展到 0~255
+    uint32_t a = (col & 1) ? (row[col >> 1] & 0x0F) : (row[col >> 1] >> 4);
+    return a * 17;
+}
+
+template <int BPP>
+static void blend_row_rgb565(uint16_t *dst, const uint8_t *row, uint32_t col, uint32_t w, uint16_t color,
+                             uint32_t fg)
+{
+    // SWAR：把 RGB565 的三个通道拆到一个 32 位字里，一次乘法同时混合三个通道
+    for (uint32_t i = 0; i < w; i++) {
+        uint32_t a = alpha_at<BPP>(row, col + i);
+        if (a == 0) {
+            continue;
+        }
+        if (a == 255) {
+            dst[i] = color;
+            continue;
+        }
+        a = (a + 4) >> 3;
+        uint32_t bg = dst[i];
+        bg = (bg | (bg << 16)) & RGB565_SPREAD_MASK;
+        uint32_t c = ((fg * a + bg * (32 - a)) >> 5) & RGB565_SPREAD_MASK;
+        dst[i] = (uint16_t)(c | (c >> 16));
+    }
+}
+
+template <int BPP>
+static void blend_row_rgb888(uint8_t *dst, const uint8_t *row, uint32_t col, uint32_t w, uint32_t color)
+{
+    // R、B 放在同一个字里一起混合，G 单独混合
+    uint32_t fg_rb = color & 0xFF00FF;
+    uint32_t fg_g = color & 0x00FF00;
+    for (uint32_t i = 0; i < w; i++, dst += 3) {
+        uint32_t a = alpha_at<BPP>(row, col + i);
+        if (a == 0) {
+            continue;
+        }
+        a += a >> 7;
+        uint32_t bg_rb = dst[0] | ((uint32_t)dst[2] << 16);
+        uint32_t bg_g = (uint32_t)dst[1] << 8;
+        uint32_t rb = ((fg_rb * a + bg_rb * (256 - a)) >> 8) & 0xFF00FF;
+        uint32_t g = ((fg_g * a + bg_g * (256 - a)) >> 8) & 0x00FF00;
+        dst[0] = rb;
+        dst[1] = g >> 8;
+        dst[2] = rb >> 16;
+    }
+}
+
+static void blend_glyph(const lcd_font_surface_t *dst, uint8_t bpp, const uint8_t *bitmap, uint32_t row_bytes,
+                        uint32_t src_x, uint32_t src_y, int32_t x, int32_t y, uint32_t w, uint32_t h, uint32_t color)
+{
+    const uint8_t *src = bitmap + src_y * row_bytes;
+
+    if (dst->format == LCD_FONT_SURFACE_RGB565) {
+        uint16_t *out = (uint16_t *)dst->pixels + (uint32_t)y * dst->stride + x;
+        uint32_t fg = (color | (color << 16)) & RGB565_SPREAD_MASK;
+        for (uint32_t row = 0; row < h; row++, src += row_bytes, out += dst->stride) {
+            if (bpp == 4) {
+                blend_row_rgb565<4>(out, src, src_x, w, (uint16_t)color, fg);
+            } else {
+                blend_row_rgb565<8>(out, src, src_x, w, (uint16_t)color, fg);
+            }
+        }
+    } else {
+        uint8_t *out = (uint8_t *)dst->pixels + ((uint32_t)y * dst->stride + x) * 3;
+        for (uint32_t row = 0; row < h; row++, src += row_bytes, out += dst->stride * 3) {
+            if (bpp == 4) {
+                blend_row_rgb888<4>(out, src, src_x, w, color);
+            } else {
+                blend_row_rgb888<8>(out, src, src_x, w, color);
+            }
+        }
+    }
+}
+
+esp_err_t lcd_font_draw(const lcd_font_surface_t *dst, lcd_font *font, const char *utf8, int32_t x, int32_t y,
+                        uint32_t color, uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h,
+                        uint16_t bounds[4], lcd_stats_t *stats)
+{
+    if (bounds) {
+        memset(bounds, 0, 4 * sizeof(uint16_t));
+    }
+    ESP_RETURN_ON_FALSE(dst && dst->pixels && utf8, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(dst->format <= LCD_FONT_SURFACE_RGB888, ESP_ERR_NOT_SUPPORTED, TAG, "unknown surface format");
+    ESP_RETURN_ON_FALSE(font && font->started(), ESP_ERR_INVALID_STATE, TAG, "font not loaded");
+
+    // 有效区域 = 裁剪矩形 ∩ 表面
+    int32_t cx0 = clip_x;
+    int32_t cy0 = clip_y;
+    int32_t cx1 = (int32_t)clip_x + clip_w < dst->width ? (int32_t)clip_x + clip_w : dst->width;
+    int32_t cy1 = (int32_t)clip_y + clip_h < dst->height ? (int32_t)clip_y + clip_h : dst->height;
+    int32_t bx0 = INT32_MAX, by0 = INT32_MAX, bx1 = INT32_MIN, by1 = INT32_MIN;
+
+    int64_t start = esp_timer_get_time();
+    uint8_t bpp = font->bpp();
+    int32_t pen = x;
+    int32_t baseline = y + font->ascent();
+    uint32_t glyphs = 0;
+    const lcd_font_glyph_t *prev = NULL;
+    const char *p = utf8;
+    uint32_t cp;
+
+    while ((cp = lcd_font::next_codepoint(&p)) != 0) {
+        if (cp == '\n') {
+            pen = x;
+            baseline += font->line_height();
+            prev = NULL;
+            if (baseline - font->ascent() >= cy1) {
+                break;
+            }
+            continue;
+        }
+        const lcd_font_glyph_t *g = font->glyph(cp);
+        if (!g) {
+            g = font->glyph('?');
+            if (!g) {
+                prev = NULL;
+                continue;
+            }
+        }
+        pen += font->kerning(prev, g);
+        prev = g;
+
+        int32_t gx = pen + g->x_off;
+        int32_t gy = baseline + g->y_off;
+        int32_t x0 = gx > cx0 ? gx : cx0;
+        int32_t y0 = gy > cy0 ? gy : cy0;
+        int32_t x1 = gx + g->width < cx1 ? gx + g->width : cx1;
+        int32_t y1 = gy + g->height < cy1 ? gy + g->height : cy1;
+        pen += g->advance;
+
+        if (x0 < x1 && y0 < y1) {
+            uint32_t row_bytes = bpp == 4 ? (g->width + 1) / 2 : g->width;
+            blend_glyph(dst, bpp, font->bitmap(g), row_bytes, x0 - gx, y0 - gy, x0, y0, x1 - x0, y1 - y0, color);
+            bx0 = x0 < bx0 ? x0 : bx0;
+            by0 = y0 < by0 ? y0 : by0;
+            bx1 = x1 > bx1 ? x1 : bx1;
+            by1 = y1 > by1 ? y1 : by1;
+            glyphs++;
+        }
+
+        // 字形左偏移不小于 -128，笔位超出裁剪区右侧 128 像素后这一行剩下的字都不可见，直接跳到下一行
+        if (pen >= cx1 + 128) {
+            p = strchr(p, '\n');
+            if (!p) {
+                break;
+            }
+        }
+    }
+
+    if (bounds && glyphs) {
+        bounds[0] = bx0;
+        bounds[1] = by0;
+        bounds[2] = bx1 - bx0;
+        bounds[3] = by1 - by0;
+    }
+    if (stats) {
+        stats->text_glyphs += glyphs;
+        stats->text_us += esp_timer_get_time() - start;
+    }
+    return ESP_OK;
+}
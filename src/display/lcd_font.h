@@ -0,0 +1,135 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "lcd_stats.h"
+
+#define LCD_FONT_MAGIC 0x31544E46         // "FNT1"，小端
+#define LCD_FONT_GLYPH_CACHE_SIZE 64      // 非 ASCII 字形查找缓存，必须是 2 的幂
+#define LCD_FONT_KERN_CACHE_SIZE 64       // 字偶距查找缓存，必须是 2 的幂
+
+/**
+ * @brief Font header at offset 0, written by `tools/font2bin.py`
+ *
+ * The header is followed by the glyph table, the kerning table and the glyph atlas; every offset
+ * is relative to the start of the font.
+ */
+typedef struct {
+    uint32_t magic;          /*!< LCD_FONT_MAGIC */
+    uint8_t bpp;             /*!< Alpha bits per pixel, 4 or 8 */
+    uint8_t reserved0;
+    uint16_t line_height;    /*!< Distance between baselines */
+    int16_t ascent;          /*!< Top of the line box to the baseline */
+    uint16_t reserved1;
+    uint32_t glyph_count;    /*!< Number of glyphs */
+    uint32_t glyphs_offset;  /*!< lcd_font_glyph_t per glyph, sorted by code point */
+    uint32_t kern_count;     /*!< Number of kerning pairs */
+    uint32_t kern_offset;    /*!< lcd_font_kern_t per pair, sorted by `pair` */
+    uint32_t atlas_offset;   /*!< Packed glyph bitmaps */
+    uint32_t size;           /*!< Total font size */
+} lcd_font_header_t;
+
+/**
+ * @brief One glyph; its bitmap rows start on a byte boundary, high nibble first at 4 bpp
+ */
+typedef struct {
+    uint32_t codepoint;      /*!< Unicode code point */
+    uint32_t offset;         /*!< Bitmap, relative to the atlas */
+    uint8_t width;           /*!< Bitmap width */
+    uint8_t height;          /*!< Bitmap height */
+    int8_t x_off;            /*!< Bitmap left edge relative to the pen */
+    int8_t y_off;            /*!< Bitmap top edge relative to the baseline, negative is up */
+    int16_t advance;         /*!< Pen advance in pixels */
+    uint16_t reserved;
+} lcd_font_glyph_t;
+
+/**
+ * @brief Kerning adjustment between two glyphs, by glyph index
+ */
+typedef struct {
+    uint32_t pair;           /*!< Left glyph index << 16 | right glyph index */
+    int16_t adjust;          /*!< Added to the left glyph's advance */
+    uint16_t reserved;
+} lcd_font_kern_t;
+
+static_assert(sizeof(lcd_font_header_t) == 36, "layout is shared with tools/font2bin.py");
+static_assert(sizeof(lcd_font_glyph_t) == 16, "layout is shared with tools/font2bin.py");
+static_assert(sizeof(lcd_font_kern_t) == 8, "layout is shared with tools/font2bin.py");
+
+/**
+ * @brief Pixel formats a string can be rendered into
+ */
+typedef enum {
+    LCD_FONT_SURFACE_RGB565 = 0,  /*!< Little-endian RGB565, same as the DPI frame buffer */
+    LCD_FONT_SURFACE_RGB888,      /*!< 3 bytes per pixel, B first */
+} lcd_font_surface_format_t;
+
+/**
+ * @brief Destination of `lcd_font_draw()`
+ */
+typedef struct {
+    void *pixels;            /*!< Top-left pixel */
+    uint32_t stride;         /*!< Row length in pixels */
+    uint16_t width;
+    uint16_t height;
+    uint8_t format;          /*!< lcd_font_surface_format_t */
+} lcd_font_surface_t;
+
+/**
+ * @brief Pre-rasterised anti-aliased bitmap font with 4 or 8 bit alpha
+ *
+ * The font is used in place, e.g. from a memory-mapped partition or an embedded array. Glyphs are
+ * found by binary search over the code points, with a direct table for ASCII and a small cache
+ * for the rest; kerning pairs go through a cache of their own, so a status line redrawn every
+ * frame does not search the tables again.
+ */
+class lcd_font
+{
+public:
+    lcd_font();
+
+    esp_err_t begin(const void *data, size_t size);
+    void end();
+    bool started();
+    uint8_t bpp();
+    uint16_t line_height();
+    int16_t ascent();
+    const lcd_font_glyph_t *glyph(uint32_t codepoint);
+    int16_t kerning(const lcd_font_glyph_t *left, const lcd_font_glyph_t *right);
+    const uint8_t *bitmap(const lcd_font_glyph_t *glyph);
+    int32_t text_width(const char *utf8);
+
+    static uint32_t next_codepoint(const char **utf8);
+
+private:
+    typedef struct {
+        uint32_t key;
+        int32_t value;
+    } cache_entry_t;
+
+    int32_t find_glyph(uint32_t codepoint);
+    int16_t find_kerning(uint32_t pair);
+
+    const uint8_t *_data;
+    const lcd_font_header_t *_header;
+    const lcd_font_glyph_t *_glyphs;
+    const lcd_font_kern_t *_kerns;
+    const uint8_t *_atlas;
+    int16_t _ascii[128];
+    cache_entry_t _glyph_cache[LCD_FONT_GLYPH_CACHE_SIZE];
+    cache_entry_t _kern_cache[LCD_FONT_KERN_CACHE_SIZE];
+};
+
+/**
+ * @brief Render a UTF-8 string in a single pass, clipped to the clip rectangle and the surface
+ *
+ * (x, y) is the top-left corner of the first line box; '\n' starts a new line. Each glyph is
+ * alpha-blended straight into the surface with `color` (RGB565, or 0xRRGGBB for RGB888).
+ *
+ * @param bounds Optional, receives the touched rectangle as x, y, w, h; w is 0 if nothing was drawn
+ * @param stats Optional, receives the glyph count and render time
+ */
+esp_err_t lcd_font_draw(const lcd_font_surface_t *dst, lcd_font *font, const char *utf8, int32_t x, int32_t y,
+                        uint32_t color, uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h,
+                        uint16_t bounds[4], lcd_stats_t *stats);
@@ -0,0 +1,383 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_cache.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_image_cache.h"
+
+static const char *TAG = "lcd_image_cache";
+
+lcd_image_cache::lcd_image_cache()
+{
+    _spinlock = portMUX_INITIALIZER_UNLOCKED;
+    _entries = NULL;
+    _buckets = NULL;
+    _max_entries = 0;
+    _bucket_mask = 0;
+    _free_head = -1;
+    _lru_head = -1;
+    _lru_tail = -1;
+    _budget = 0;
+    _used = 0;
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+lcd_image_cache::~lcd_image_cache()
+{
+    end();
+}
+
+esp_err_t lcd_image_cache::begin(size_t budget_bytes, uint16_t max_entries)
+{
+    ESP_RETURN_ON_FALSE(!_entries, ESP_ERR_INVALID_STATE, TAG, "already started");
+    ESP_RETURN_ON_FALSE(budget_bytes && max_entries && max_entries <= LCD_IMAGE_CACHE_MAX_ENTRIES, ESP_ERR_INVALID_ARG,
+                        TAG, "invalid budget or entry count");
+
+    // 桶数取不小于条目数的 2 的幂，平均链长不超过 1
+    uint16_t buckets = 1;
+    while (buckets < max_entries) {
+        buckets <<= 1;
+    }
+
+    // 簿记表放内部 SRAM，查找时不走 PSRAM
+    _entries = (entry_t *)heap_caps_calloc(max_entries, sizeof(entry_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    _buckets = (int16_t *)heap_caps_malloc(buckets * sizeof(int16_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!_entries || !_buckets) {
+        end();
+        ESP_LOGE(TAG, "no mem for %d entries", max_entries);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint16_t i = 0; i < buckets; i++) {
+        _buckets[i] = -1;
+    }
+    for (uint16_t i = 0; i < max_entries; i++) {
+        _entries[i].hash_next = (i + 1 < max_entries) ? i + 1 : -1;
+    }
+    _max_entries = max_entries;
+    _bucket_mask = buckets - 1;
+    _free_head = 0;
+    _lru_head = -1;
+    _lru_tail = -1;
+    _budget = budget_bytes;
+    _used = 0;
+    memset(&_stats, 0, sizeof(_stats));
+    ESP_LOGI(TAG, "%u bytes PSRAM budget, %d entries", (unsigned)budget_bytes, max_entries);
+    return ESP_OK;
+}
+
+void lcd_image_cache::end()
+{
+    if (_entries) {
+        for (int16_t i = _lru_head; i >= 0; i = _entries[i].lru_next) {
+            if (_entries[i].refs) {
+                ESP_LOGW(TAG, "image 0x%08lx still referenced", (unsigned long)_entries[i].image.key.id);
+            }
+            heap_caps_free(_entries[i].image.data);
+        }
+        heap_caps_free(_entries);
+        _entries = NULL;
+    }
+    if (_buckets) {
+        heap_caps_free(_buckets);
+        _buckets = NULL;
+    }
+    _max_entries = 0;
+    _free_head = -1;
+    _lru_head = -1;
+    _lru_tail = -1;
+    _budget = 0;
+    _used = 0;
+}
+
+uint32_t lcd_image_cache::key_hash(const lcd_image_key_t *key)
+{
+    // FNV-1a，按字段混入，不受结构体填充字节影响
+    uint32_t h = 2166136261u;
+    uint32_t words[3] = {key->id, ((uint32_t)key->width << 16) | key->height, key->format};
+    for (int w = 0; w < 3; w++) {
+        for (int b = 0; b < 32; b += 8) {
+            h = (h ^ ((words[w] >> b) & 0xFF)) * 16777619u;
+        }
+    }
+    return h;
+}
+
+bool lcd_image_cache::key_equal(const lcd_image_key_t *a, const lcd_image_key_t *b)
+{
+    return a->id == b->id && a->width == b->width && a->height == b->height && a->format == b->format;
+}
+
+int16_t lcd_image_cache::find(const lcd_image_key_t *key, uint32_t hash)
+{
+    for (int16_t i = _buckets[hash & _bucket_mask]; i >= 0; i = _entries[i].hash_next) {
+        if (_entries[i].hash == hash && key_equal(&_entries[i].image.key, key)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void lcd_image_cache::lru_unlink(int16_t i)
+{
+    entry_t *e = &_entries[i];
+    if (e->lru_prev >= 0) {
+        _entries[e->lru_prev].lru_next = e->lru_next;
+    } else {
+        _lru_head = e->lru_next;
+    }
+    if (e->lru_next >= 0) {
+        _entries[e->lru_next].lru_prev = e->lru_prev;
+    } else {
+        _lru_tail = e->lru_prev;
+    }
+}
+
+void lcd_image_cache::lru_push_front(int16_t i)
+{
+    entry_t *e = &_entries[i];
+    e->lru_prev = -1;
+    e->lru_next = _lru_head;
+    if (_lru_head >= 0) {
+        _entries[_lru_head].lru_prev = i;
+    } else {
+        _lru_tail = i;
+    }
+    _lru_head = i;
+}
+
+void lcd_image_cache::remove(int16_t i)
+{
+    // 调用者持有自旋锁
+    int16_t *link = &_buckets[_entries[i].hash & _bucket_mask];
+    while (*link != i) {
+        link = &_entries[*link].hash_next;
+    }
+    *link = _entries[i].hash_next;
+    lru_unlink(i);
+
+    _entries[i].image.data = NULL;
+    _entries[i].hash_next = _free_head;
+    _free_head = i;
+    _stats.entries--;
+}
+
+void *lcd_image_cache::evict_one()
+{
+    // 调用者持有自旋锁；从 LRU 尾部找第一个没被引用也没被钉住的
+    for (int16_t i = _lru_tail; i >= 0; i = _entries[i].lru_prev) {
+        entry_t *e = &_entries[i];
+        if (e->refs == 0 && !e->pinned) {
+            void *data = e->image.data;
+            _used -= e->image.size;
+            _stats.evictions++;
+            remove(i);
+            return data;
+        }
+    }
+    return NULL;
+}
+
+lcd_image_handle_t lcd_image_cache::acquire(const lcd_image_key_t *key)
+{
+    if (!_entries || !key) {
+        return NULL;
+    }
+
+    uint32_t hash = key_hash(key);
+    lcd_image_handle_t image = NULL;
+    portENTER_CRITICAL(&_spinlock);
+    int16_t i = find(key, hash);
+    if (i >= 0) {
+        _entries[i].refs++;
+        lru_unlink(i);
+        lru_push_front(i);
+        _stats.hits++;
+        image = &_entries[i].image;
+    } else {
+        _stats.misses++;
+    }
+    portEXIT_CRITICAL(&_spinlock);
+    return image;
+}
+
+lcd_image_handle_t lcd_image_cache::acquire(const lcd_image_key_t *key, size_t size, lcd_image_decode_cb_t decode,
+                                            void *user_ctx)
+{
+    if (!_entries || !key || !size || !decode) {
+        return NULL;
+    }
+
+    lcd_image_handle_t image = acquire(key);
+    if (image) {
+        return image;
+    }
+    if (size > _budget) {
+        ESP_LOGW(TAG, "image 0x%08lx (%u bytes) exceeds the budget", (unsigned long)key->id, (unsigned)size);
+        portENTER_CRITICAL(&_spinlock);
+        _stats.failures++;
+        portEXIT_CRITICAL(&_spinlock);
+        return NULL;
+    }
+
+    // 先淘汰并记账预留字节，并发插入也不会超出预算；释放内存放到锁外
+    for (;;) {
+        portENTER_CRITICAL(&_spinlock);
+        if (_used + size <= _budget) {
+            _used += size;
+            portEXIT_CRITICAL(&_spinlock);
+            break;
+        }
+        void *victim = evict_one();
+        if (!victim) {
+            _stats.failures++;
+        }
+        portEXIT_CRITICAL(&_spinlock);
+        if (!victim) {
+            ESP_LOGW(TAG, "no room for image 0x%08lx, everything left is in use or pinned", (unsigned long)key->id);
+            return NULL;
+        }
+        heap_caps_free(victim);
+    }
+
+    void *data = heap_caps_aligned_alloc(LCD_IMAGE_CACHE_ALIGN, size, MALLOC_CAP_SPIRAM);
+    esp_err_t ret = data ? decode(key, data, size, user_ctx) : ESP_ERR_NO_MEM;
+    if (ret == ESP_OK) {
+        // 写回 PSRAM，之后 DMA2D/PPA 直接读取
+        esp_cache_msync(data, size, ESP_CACHE_MSYNC_FLAG_DIR_C2M | ESP_CACHE_MSYNC_FLAG_UNALIGNED);
+    }
+
+    uint32_t hash = key_hash(key);
+    void *victim = NULL;
+    void *drop = NULL;
+    portENTER_CRITICAL(&_spinlock);
+    int16_t i = (ret == ESP_OK) ? find(key, hash) : -1;
+    if (i >= 0) {
+        // 别的任务抢先插入了同一张图，用它的，丢掉自己的
+        _entries[i].refs++;
+        lru_unlink(i);
+        lru_push_front(i);
+        _used -= size;
+        drop = data;
+        image = &_entries[i].image;
+    } else if (ret == ESP_OK) {
+        if (_free_head < 0) {
+            victim = evict_one();
+        }
+        if (_free_head >= 0) {
+            i = _free_head;
+            entry_t *e = &_entries[i];
+            _free_head = e->hash_next;
+            e->image.key = *key;
+            e->image.data = data;
+            e->image.size = size;
+            e->hash = hash;
+            e->hash_next = _buckets[hash & _bucket_mask];
+            _buckets[hash & _bucket_mask] = i;
+            e->refs = 1;
+            e->pinned = false;
+            lru_push_front(i);
+            _stats.entries++;
+            image = &e->image;
+        } else {
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+    if (!image) {
+        _used -= size;
+        _stats.failures++;
+        drop = data;
+    }
+    portEXIT_CRITICAL(&_spinlock);
+
+    if (victim) {
+        heap_caps_free(victim);
+    }
+    if (drop) {
+        heap_caps_free(drop);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "image 0x%08lx not cached: %s", (unsigned long)key->id, esp_err_to_name(ret));
+    }
+    return image;
+}
+
+void lcd_image_cache::retain(lcd_image_handle_t image)
+{
+    if (!image) {
+        return;
+    }
+    entry_t *e = (entry_t *)image;
+    portENTER_CRITICAL_SAFE(&_spinlock);
+    e->refs++;
+    portEXIT_CRITICAL_SAFE(&_spinlock);
+}
+
+void lcd_image_cache::release(lcd_image_handle_t image)
+{
+    if (!image) {
+        return;
+    }
+
+    // 可在 DMA 完成回调里调用；只减引用，内存等下次淘汰时再释放
+    entry_t *e = (entry_t *)image;
+    portENTER_CRITICAL_SAFE(&_spinlock);
+    if (e->refs) {
+        e->refs--;
+    }
+    portEXIT_CRITICAL_SAFE(&_spinlock);
+}
+
+void lcd_image_cache::set_pinned(lcd_image_handle_t image, bool pinned)
+{
+    if (!image) {
+        return;
+    }
+    entry_t *e = (entry_t *)image;
+    portENTER_CRITICAL(&_spinlock);
+    e->pinned = pinned;
+    portEXIT_CRITICAL(&_spinlock);
+}
+
+void lcd_image_cache::clear()
+{
+    if (!_entries) {
+        return;
+    }
+
+    // 只丢弃没被引用也没被钉住的图，每次释放一张，锁外释放内存
+    for (;;) {
+        portENTER_CRITICAL(&_spinlock);
+        void *victim = evict_one();
+        portEXIT_CRITICAL(&_spinlock);
+        if (!victim) {
+            break;
+        }
+        heap_caps_free(victim);
+    }
+}
+
+void lcd_image_cache::get_stats(lcd_image_cache_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+    portENTER_CRITICAL(&_spinlock);
+    *stats = _stats;
+    stats->bytes_used = _used;
+    stats->bytes_budget = _budget;
+    portEXIT_CRITICAL(&_spinlock);
+}
+
+void lcd_image_cache::reset_stats()
+{
+    portENTER_CRITICAL(&_spinlock);
+    _stats.hits = 0;
+    _stats.misses = 0;
+    _stats.evictions = 0;
+    _stats.failures = 0;
+    portEXIT_CRITICAL(&_spinlock);
+}
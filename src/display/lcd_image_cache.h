@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#define LCD_IMAGE_CACHE_ALIGN 64          // PSRAM 缓存行大小，解码结果可直接交给 DMA2D/PPA
+#define LCD_IMAGE_CACHE_MAX_ENTRIES 1024
+
+/**
+ * @brief Cache key; two images are the same only if every field matches
+ *
+ * `id` is up to the application, e.g. `lcd_asset_pack::hash(name, 0)` for pack assets or a glyph
+ * atlas number. `format` tells apart several decodings of one source, e.g. RGB565 and A8.
+ */
+typedef struct {
+    uint32_t id;
+    uint16_t width;
+    uint16_t height;
+    uint8_t format;
+} lcd_image_key_t;
+
+/**
+ * @brief Cached image, read-only once published; valid while the handle is held
+ */
+typedef struct {
+    lcd_image_key_t key;
+    void *data;     /*!< Decoded pixels in PSRAM, LCD_IMAGE_CACHE_ALIGN aligned */
+    size_t size;    /*!< Bytes at `data` */
+} lcd_image_t;
+
+typedef const lcd_image_t *lcd_image_handle_t;
+
+/**
+ * @brief Fill `data` with the decoded image on a cache miss
+ *
+ * Called from the acquiring task without any cache lock held.
+ */
+typedef esp_err_t (*lcd_image_decode_cb_t)(const lcd_image_key_t *key, void *data, size_t size, void *user_ctx);
+
+/**
+ * @brief Cache counters since `begin()` or the last `reset_stats()`
+ */
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+    uint32_t failures;      /*!< Misses that could not be filled: over budget, out of memory or decode error */
+    uint32_t entries;
+    size_t bytes_used;
+    size_t bytes_budget;
+} lcd_image_cache_stats_t;
+
+/**
+ * @brief Byte-budgeted LRU cache of decoded images and glyph atlases in PSRAM
+ *
+ * Handles are reference counted: an image is never freed while a handle is held, so the render
+ * task can acquire an image and hand it to the flush side, which releases it once the DMA is done,
+ * even from the completion ISR. Pinned images are never evicted. When an insert does not fit the
+ * budget the least recently used unreferenced, unpinned images are freed first.
+ *
+ * The table is guarded by a spinlock held only for the bookkeeping; allocation, decoding and
+ * freeing happen outside it. Two tasks missing the same key at once both decode, the second
+ * result is dropped.
+ */
+class lcd_image_cache
+{
+public:
+    lcd_image_cache();
+    ~lcd_image_cache();
+
+    esp_err_t begin(size_t budget_bytes, uint16_t max_entries = 128);
+    void end();
+    lcd_image_handle_t acquire(const lcd_image_key_t *key);
+    lcd_image_handle_t acquire(const lcd_image_key_t *key, size_t size, lcd_image_decode_cb_t decode, void *user_ctx);
+    void retain(lcd_image_handle_t image);
+    void release(lcd_image_handle_t image);
+    void set_pinned(lcd_image_handle_t image, bool pinned);
+    void clear();
+    void get_stats(lcd_image_cache_stats_t *stats);
+    void reset_stats();
+
+private:
+    typedef struct {
+        lcd_image_t image;      // 必须是第一个成员，句柄直接指向它
+        uint32_t hash;
+        int16_t hash_next;      // 同桶链表；空闲槽位也用它串成空闲链表
+        int16_t lru_prev;       // LRU 链表，表头是最近使用的
+        int16_t lru_next;
+        uint16_t refs;
+        bool pinned;
+    } entry_t;
+
+    static uint32_t key_hash(const lcd_image_key_t *key);
+    static bool key_equal(const lcd_image_key_t *a, const lcd_image_key_t *b);
+    int16_t find(const lcd_image_key_t *key, uint32_t hash);
+    void lru_unlink(int16_t i);
+    void lru_push_front(int16_t i);
+    void *evict_one();
+    void remove(int16_t i);
+
+    portMUX_TYPE _spinlock;
+    entry_t *_entries;
+    int16_t *_buckets;
+    uint16_t _max_entries;
+    uint16_t _bucket_mask;
+    int16_t _free_head;
+    int16_t _lru_head;
+    int16_t _lru_tail;
+    size_t _budget;
+    size_t _used;
+    lcd_image_cache_stats_t _stats;
+};
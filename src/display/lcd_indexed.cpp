@@ -0,0 +1,145 @@
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_indexed.h"
+
+static const char *TAG = "lcd_indexed";
+
+lcd_indexed::lcd_indexed()
+{
+    _pixels = NULL;
+    _stride = 0;
+    _width = 0;
+    _height = 0;
+    memset(_palette, 0, sizeof(_palette));
+}
+
+lcd_indexed::~lcd_indexed()
+{
+    end();
+}
+
+esp_err_t lcd_indexed::begin(uint16_t width, uint16_t height, uint32_t caps)
+{
+    ESP_RETURN_ON_FALSE(width && height, ESP_ERR_INVALID_ARG, TAG, "invalid size");
+    ESP_RETURN_ON_FALSE(!_pixels, ESP_ERR_INVALID_STATE, TAG, "surface already allocated");
+
+    uint32_t stride = (width + LCD_INDEXED_ALIGN - 1) & ~(uint32_t)(LCD_INDEXED_ALIGN - 1);
+    _pixels = (uint8_t *)heap_caps_aligned_alloc(LCD_INDEXED_ALIGN, (size_t)stride * height, caps);
+    ESP_RETURN_ON_FALSE(_pixels, ESP_ERR_NO_MEM, TAG, "no mem for %ux%u surface", width, height);
+    memset(_pixels, 0, (size_t)stride * height);
+    _stride = stride;
+    _width = width;
+    _height = height;
+    return ESP_OK;
+}
+
+void lcd_indexed::end()
+{
+    if (_pixels) {
+        heap_caps_free(_pixels);
+    }
+    _pixels = NULL;
+    _stride = 0;
+    _width = 0;
+    _height = 0;
+}
+
+uint8_t *lcd_indexed::pixels()
+{
+    return _pixels;
+}
+
+uint32_t lcd_indexed::stride()
+{
+    return _stride;
+}
+
+uint16_t lcd_indexed::width()
+{
+    return _width;
+}
+
+uint16_t lcd_indexed::height()
+{
+    return _height;
+}
+
+void lcd_indexed::set_color(uint8_t index, uint16_t color)
+{
+    _palette[index] = color;
+}
+
+void lcd_indexed::set_palette(const uint16_t *colors, uint16_t first, uint16_t num)
+{
+    if (!colors || first >= LCD_INDEXED_COLORS) {
+        return;
+    }
+    if (first + num > LCD_INDEXED_COLORS) {
+        num = LCD_INDEXED_COLORS - first;
+    }
+    memcpy(&_palette[first], colors, num * sizeof(uint16_t));
+}
+
+const uint16_t *lcd_indexed::palette()
+{
+    return _palette;
+}
+
+void lcd_indexed::fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t index)
+{
+    if (!_pixels || x >= _width || y >= _height) {
+        return;
+    }
+    w = x + w > _width ? _width - x : w;
+    h = y + h > _height ? _height - y : h;
+    for (uint16_t row = 0; row < h; row++) {
+        memset(_pixels + (uint32_t)(y + row) * _stride + x, index, w);
+    }
+}
+
+esp_err_t lcd_indexed::expand(uint16_t *dst, uint32_t dst_stride, uint16_t src_x, uint16_t src_y, uint16_t w,
+                              uint16_t h, const uint16_t *palette, lcd_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(_pixels, ESP_ERR_INVALID_STATE, TAG, "surface not allocated");
+    ESP_RETURN_ON_FALSE(dst && dst_stride >= w && src_x + w <= _width && src_y + h <= _height, ESP_ERR_INVALID_ARG,
+                        TAG, "invalid rectangle");
+
+    const uint16_t *pal = palette ? palette : _palette;
+    int64_t start = esp_timer_get_time();
+    for (uint16_t row = 0; row < h; row++) {
+        const uint8_t *s = _pixels + (uint32_t)(src_y + row) * _stride + src_x;
+        uint16_t *d = dst + (uint32_t)row * dst_stride;
+        uint16_t col = 0;
+
+        // 目标对齐到 4 字节后，每次读 4 个索引、写两个 32 位字；源行首对齐，src_x 为 4 的倍数时读也是对齐的
+        if (((uintptr_t)d & 3) && w) {
+            d[0] = pal[s[0]];
+            col = 1;
+        }
+        if ((((uintptr_t)(s + col)) & 3) == 0) {
+            for (; col + 4 <= w; col += 4) {
+                uint32_t i4 = *(const uint32_t *)(s + col);
+                *(uint32_t *)&d[col] = pal[i4 & 0xFF] | ((uint32_t)pal[(i4 >> 8) & 0xFF] << 16);
+                *(uint32_t *)&d[col + 2] = pal[(i4 >> 16) & 0xFF] | ((uint32_t)pal[i4 >> 24] << 16);
+            }
+        } else {
+            for (; col + 2 <= w; col += 2) {
+                *(uint32_t *)&d[col] = pal[s[col]] | ((uint32_t)pal[s[col + 1]] << 16);
+            }
+        }
+        for (; col < w; col++) {
+            d[col] = pal[s[col]];
+        }
+    }
+
+    if (stats) {
+        stats->indexed_pixels += (uint32_t)w * h;
+        stats->indexed_us += esp_timer_get_time() - start;
+    }
+    return ESP_OK;
+}
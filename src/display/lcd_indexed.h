@@ -0,0 +1,44 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+#include "lcd_stats.h"
+
+#define LCD_INDEXED_COLORS 256
+#define LCD_INDEXED_ALIGN 4 // 行首按 4 字节对齐，展开时一次读 4 个索引
+
+/**
+ * @brief 8-bit indexed render surface with a 256-entry RGB565 palette
+ *
+ * Screens with few colours render into this at 1 byte per pixel, half of an RGB565 buffer, and
+ * let the display class expand any sub-rectangle to RGB565 straight into the frame buffer. Palette
+ * changes take effect on the next expansion. Not thread-safe.
+ */
+class lcd_indexed
+{
+public:
+    lcd_indexed();
+    ~lcd_indexed();
+
+    esp_err_t begin(uint16_t width, uint16_t height, uint32_t caps = MALLOC_CAP_SPIRAM);
+    void end();
+    uint8_t *pixels();
+    uint32_t stride();
+    uint16_t width();
+    uint16_t height();
+    void set_color(uint8_t index, uint16_t color);
+    void set_palette(const uint16_t *colors, uint16_t first, uint16_t num);
+    const uint16_t *palette();
+    void fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t index);
+    esp_err_t expand(uint16_t *dst, uint32_t dst_stride, uint16_t src_x, uint16_t src_y, uint16_t w, uint16_t h,
+                     const uint16_t *palette, lcd_stats_t *stats);
+
+private:
+    uint8_t *_pixels;
+    uint32_t _stride;
+    uint16_t _width;
+    uint16_t _height;
+    uint16_t _palette[LCD_INDEXED_COLORS];
+};
@@ -0,0 +1,260 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_pipeline.h"
+
+static const char *TAG = "lcd_pipeline";
+
+static inline uint32_t range_pack(uint32_t begin, uint32_t end)
+{
+    return (begin << 16) | end;
+}
+
+lcd_pipeline::lcd_pipeline()
+{
+    _flush_cb = NULL;
+    _flush_ctx = NULL;
+    _post_cb = NULL;
+    _post_ctx = NULL;
+    _done_cb = NULL;
+    _done_ctx = NULL;
+    _flush_task = NULL;
+    _tile_task = NULL;
+    _waiting_producer = NULL;
+    _running = false;
+    _head = 0;
+    _tail = 0;
+    _ranges[0] = 0;
+    _ranges[1] = 0;
+    _tile_fn = NULL;
+    _tile_arg = NULL;
+    _tile_done = NULL;
+    _tile_busy = false;
+    _tile_claimed = false;
+}
+
+lcd_pipeline::~lcd_pipeline()
+{
+    end();
+}
+
+esp_err_t lcd_pipeline::begin(lcd_frame_cb_t flush_cb, void *flush_ctx, BaseType_t flush_core, UBaseType_t priority)
+{
+    ESP_RETURN_ON_FALSE(flush_cb, ESP_ERR_INVALID_ARG, TAG, "invalid flush callback");
+    ESP_RETURN_ON_FALSE(!_running, ESP_ERR_INVALID_STATE, TAG, "already started");
+
+    _flush_cb = flush_cb;
+    _flush_ctx = flush_ctx;
+    _head = 0;
+    _tail = 0;
+    _running = true;
+
+    // 刷新任务固定在刷新核上，渲染任务留在另一个核；瓦片辅助任务不绑核，渲染任务调用时它在刷新核上帮忙，
+    // 刷新任务里的 CPU 运算调用时它在渲染核上帮忙
+    if (xTaskCreatePinnedToCore(flush_task, "lcd_flush", LCD_PIPELINE_STACK_SIZE, this, priority, &_flush_task, flush_core) != pdPASS) {
+        _running = false;
+        return ESP_ERR_NO_MEM;
+    }
+    _tile_done = xSemaphoreCreateBinary();
+    if (!_tile_done ||
+        xTaskCreatePinnedToCore(tile_task, "lcd_tile", LCD_PIPELINE_STACK_SIZE, this, priority > 1 ? priority - 1 : 1, &_tile_task, tskNO_AFFINITY) != pdPASS) {
+        ESP_LOGW(TAG, "no tile worker, parallel_for runs on the calling core only");
+        _tile_task = NULL;
+    }
+    return ESP_OK;
+}
+
+void lcd_pipeline::end()
+{
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    // 两个任务醒来后看到 _running 为 false 会自行退出并清空句柄
+    while (_flush_task || _tile_task) {
+        if (_flush_task) {
+            xTaskNotifyGive(_flush_task);
+        }
+        if (_tile_task) {
+            xTaskNotifyGive(_tile_task);
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    if (_tile_done) {
+        vSemaphoreDelete(_tile_done);
+        _tile_done = NULL;
+    }
+}
+
+bool lcd_pipeline::started()
+{
+    return _running;
+}
+
+bool lcd_pipeline::in_flush_task()
+{
+    return _flush_task && xTaskGetCurrentTaskHandle() == _flush_task;
+}
+
+void lcd_pipeline::set_post_process(lcd_frame_cb_t cb, void *user_ctx)
+{
+    _post_ctx = user_ctx;
+    _post_cb = cb;
+}
+
+void lcd_pipeline::set_done_callback(lcd_frame_cb_t cb, void *user_ctx)
+{
+    _done_ctx = user_ctx;
+    _done_cb = cb;
+}
+
+bool lcd_pipeline::submit(const lcd_frame_t *frame, TickType_t timeout)
+{
+    if (!_running || !frame) {
+        return false;
+    }
+
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    while (tail - _head.load(std::memory_order_acquire) >= LCD_PIPELINE_QUEUE_LEN) {
+        // 队列已满：登记等待后再检查一次，避免错过刷新任务的唤醒
+        _waiting_producer.store(xTaskGetCurrentTaskHandle());
+        if (tail - _head.load(std::memory_order_acquire) < LCD_PIPELINE_QUEUE_LEN) {
+            _waiting_producer.store(NULL);
+            break;
+        }
+        if (ulTaskNotifyTake(pdTRUE, timeout) == 0) {
+            _waiting_producer.store(NULL);
+            return false;
+        }
+    }
+
+    _ring[tail % LCD_PIPELINE_QUEUE_LEN] = *frame;
+    _tail.store(tail + 1, std::memory_order_release);
+    xTaskNotifyGive(_flush_task);
+    return true;
+}
+
+void lcd_pipeline::flush_task(void *arg)
+{
+    lcd_pipeline *self = (lcd_pipeline *)arg;
+
+    while (self->_running) {
+        uint32_t head = self->_head.load(std::memory_order_relaxed);
+        if (head == self->_tail.load(std::memory_order_acquire)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        lcd_frame_t frame = self->_ring[head % LCD_PIPELINE_QUEUE_LEN];
+        if (self->_post_cb) {
+            self->_post_cb(&frame, self->_post_ctx);
+        }
+        self->_flush_cb(&frame, self->_flush_ctx);
+        if (self->_done_cb) {
+            self->_done_cb(&frame, self->_done_ctx);
+        }
+
+        // 刷新完成后才释放槽位，队列长度即为在途帧数上限
+        self->_head.store(head + 1, std::memory_order_release);
+        TaskHandle_t producer = self->_waiting_producer.exchange(NULL);
+        if (producer) {
+            xTaskNotifyGive(producer);
+        }
+    }
+
+    self->_flush_task = NULL;
+    vTaskDelete(NULL);
+}
+
+bool lcd_pipeline::take_own(std::atomic<uint32_t> *range, uint32_t *tile)
+{
+    uint32_t v = range->load();
+    while ((v >> 16) < (v & 0xFFFF)) {
+        if (range->compare_exchange_weak(v, range_pack((v >> 16) + 1, v & 0xFFFF))) {
+            *tile = v >> 16;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool lcd_pipeline::steal(std::atomic<uint32_t> *range, uint32_t *tile)
+{
+    uint32_t v = range->load();
+    while ((v >> 16) < (v & 0xFFFF)) {
+        if (range->compare_exchange_weak(v, range_pack(v >> 16, (v & 0xFFFF) - 1))) {
+            *tile = (v & 0xFFFF) - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+void lcd_pipeline::run_tiles(int self)
+{
+    uint32_t tile;
+
+    // 先从自己那一段的头部取，取完后从另一段的尾部偷
+    while (take_own(&_ranges[self], &tile)) {
+        _tile_fn(tile, _tile_arg);
+    }
+    while (steal(&_ranges[1 - self], &tile)) {
+        _tile_fn(tile, _tile_arg);
+    }
+}
+
+void lcd_pipeline::parallel_for(uint32_t tiles, lcd_tile_fn_t fn, void *arg)
+{
+    if (!fn || !tiles) {
+        return;
+    }
+    // 辅助任务正被另一个调用方占用（例如渲染任务和刷新任务同时调用）时，在本核上顺序执行
+    bool idle = false;
+    if (!_tile_task || tiles < 2 || tiles > 0xFFFF || !_tile_claimed.compare_exchange_strong(idle, true)) {
+        for (uint32_t i = 0; i < tiles; i++) {
+            fn(i, arg);
+        }
+        return;
+    }
+
+    uint32_t half = tiles / 2;
+    _tile_fn = fn;
+    _tile_arg = arg;
+    _ranges[0].store(range_pack(0, half));
+    _ranges[1].store(range_pack(half, tiles));
+
+    _tile_busy = true;
+    xTaskNotifyGive(_tile_task);
+    run_tiles(0);
+
+    // 等辅助任务处理完它手上的最后一个瓦片；每次调用辅助任务只给一次，不会和 submit() 的通知混在一起
+    xSemaphoreTake(_tile_done, portMAX_DELAY);
+    // 取到汇合信号后才放开，下一个调用方给出的信号不会被这一次取走
+    _tile_claimed = false;
+}
+
+void lcd_pipeline::tile_task(void *arg)
+{
+    lcd_pipeline *self = (lcd_pipeline *)arg;
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!self->_running) {
+            break;
+        }
+        if (!self->_tile_busy.load()) {
+            continue;
+        }
+        self->run_tiles(1);
+        self->_tile_busy = false;
+        xSemaphoreGive(self->_tile_done);
+    }
+
+    self->_tile_task = NULL;
+    vTaskDelete(NULL);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdio.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define LCD_PIPELINE_QUEUE_LEN 4
+#define LCD_PIPELINE_STACK_SIZE 4096
+
+/**
+ * @brief A rendered frame (or part of one) handed from the render core to the flush core
+ */
+typedef struct {
+    uint16_t x_start;
+    uint16_t y_start;
+    uint16_t x_end;
+    uint16_t y_end;
+    uint16_t *color_data;
+    void *user_data;
+} lcd_frame_t;
+
+typedef void (*lcd_frame_cb_t)(lcd_frame_t *frame, void *user_ctx);
+typedef void (*lcd_tile_fn_t)(uint32_t tile, void *arg);
+
+/**
+ * @brief Split render/flush pipeline across the two cores
+ *
+ * The render task calls `submit()`; frames go through a bounded single-producer single-consumer
+ * lock-free ring to a flush task pinned to the other core, which runs the optional post-process
+ * stage (convert, rotate, ...) and the flush itself. `parallel_for()` spreads the tiles of a heavy
+ * software operation over both cores; each core works through its own half and steals from the
+ * other half once it runs dry. It may be called from the render task or from the flush task (the
+ * CPU kernels of lcd_blit do so while the pipeline runs); a call made while another one is in
+ * progress runs its tiles on the calling core alone.
+ */
+class lcd_pipeline
+{
+public:
+    lcd_pipeline();
+    ~lcd_pipeline();
+
+    esp_err_t begin(lcd_frame_cb_t flush_cb, void *flush_ctx, BaseType_t flush_core = 1, UBaseType_t priority = 5);
+    void end();
+    bool started();
+    bool in_flush_task();
+    void set_post_process(lcd_frame_cb_t cb, void *user_ctx);
+    void set_done_callback(lcd_frame_cb_t cb, void *user_ctx);
+    bool submit(const lcd_frame_t *frame, TickType_t timeout = portMAX_DELAY);
+    void parallel_for(uint32_t tiles, lcd_tile_fn_t fn, void *arg);
+
+private:
+    static void flush_task(void *arg);
+    static void tile_task(void *arg);
+    static bool take_own(std::atomic<uint32_t> *range, uint32_t *tile);
+    static bool steal(std::atomic<uint32_t> *range, uint32_t *tile);
+    void run_tiles(int self);
+
+    lcd_frame_cb_t _flush_cb;
+    void *_flush_ctx;
+    lcd_frame_cb_t _post_cb;
+    void *_post_ctx;
+    lcd_frame_cb_t _done_cb;
+    void *_done_ctx;
+
+    TaskHandle_t _flush_task;
+    TaskHandle_t _tile_task;
+    std::atomic<TaskHandle_t> _waiting_producer;
+    std::atomic<bool> _running;
+
+    lcd_frame_t _ring[LCD_PIPELINE_QUEUE_LEN];
+    std::atomic<uint32_t> _head;
+    std::atomic<uint32_t> _tail;
+
+    // 每个核一段 [begin, end)，打包为 16 位 + 16 位，用 CAS 在头部取、在尾部偷
+    std::atomic<uint32_t> _ranges[2];
+    lcd_tile_fn_t _tile_fn;
+    void *_tile_arg;
+    SemaphoreHandle_t _tile_done;  // 汇合单独用一个信号量，不占调用方的任务通知
+    std::atomic<bool> _tile_busy;
+    std::atomic<bool> _tile_claimed;  // 一次只有一个调用方用辅助任务
+};
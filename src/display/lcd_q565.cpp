@@ -0,0 +1,205 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_q565.h"
+
+static const char *TAG = "lcd_q565";
+
+// 操作码，与 tools/q565.py 保持一致
+#define Q565_OP_INDEX 0x00 // 00iiiiii
+#define Q565_OP_DIFF 0x40  // 01rrggbb，各通道差值 -2..1
+#define Q565_OP_LUMA 0x80  // 10gggggg rrrrbbbb，绿色差值 -32..31，红/蓝相对绿色一半的差值 -8..7
+#define Q565_OP_RUN 0xC0   // 11nnnnnn，重复上一个像素 1..62 次
+#define Q565_OP_RGB 0xFE   // 后跟 2 字节小端 RGB565
+
+static inline uint8_t q565_hash(uint16_t px)
+{
+    return ((px >> 11) * 3 + ((px >> 5) & 0x3F) * 5 + (px & 0x1F) * 7) & 0x3F;
+}
+
+lcd_q565_decoder::lcd_q565_decoder()
+{
+    _p = NULL;
+    _end = NULL;
+    _width = 0;
+    _height = 0;
+    _row = 0;
+    _prev = 0;
+    _run = 0;
+    memset(_index, 0, sizeof(_index));
+}
+
+esp_err_t lcd_q565_decoder::begin(const void *data, size_t size)
+{
+    ESP_RETURN_ON_FALSE(data && size >= sizeof(lcd_q565_header_t), ESP_ERR_INVALID_ARG, TAG, "invalid stream");
+
+    lcd_q565_header_t header;
+    memcpy(&header, data, sizeof(header));
+    ESP_RETURN_ON_FALSE(header.magic == LCD_Q565_MAGIC, ESP_ERR_NOT_SUPPORTED, TAG, "not a Q565 stream");
+    ESP_RETURN_ON_FALSE(header.size <= size - sizeof(header), ESP_ERR_INVALID_SIZE, TAG, "truncated stream");
+
+    _p = (const uint8_t *)data + sizeof(header);
+    _end = _p + header.size;
+    _width = header.width;
+    _height = header.height;
+    _row = 0;
+    _prev = 0;
+    _run = 0;
+    memset(_index, 0, sizeof(_index));
+    return ESP_OK;
+}
+
+uint16_t lcd_q565_decoder::width()
+{
+    return _width;
+}
+
+uint16_t lcd_q565_decoder::height()
+{
+    return _height;
+}
+
+uint16_t lcd_q565_decoder::row()
+{
+    return _row;
+}
+
+esp_err_t lcd_q565_decoder::skip_rows(uint16_t rows)
+{
+    return decode_rows(NULL, 0, rows, 0, 0);
+}
+
+esp_err_t lcd_q565_decoder::decode_rows(uint16_t *dst, uint32_t dst_stride, uint16_t rows, uint16_t x, uint16_t w)
+{
+    ESP_RETURN_ON_FALSE(_p, ESP_ERR_INVALID_STATE, TAG, "not started");
+    ESP_RETURN_ON_FALSE(rows <= _height - _row, ESP_ERR_INVALID_ARG, TAG, "past the last row");
+
+    // 行内分三段：裁剪区左侧只解码不写，中间写入 dst，右侧只解码不写
+    uint16_t x0 = x < _width ? x : _width;
+    uint16_t x1 = (w < _width - x0) ? x0 + w : _width;
+    for (uint16_t i = 0; i < rows; i++) {
+        ESP_RETURN_ON_ERROR(decode_span(NULL, x0), TAG, "corrupt stream at row %u", _row);
+        ESP_RETURN_ON_ERROR(decode_span(dst, x1 - x0), TAG, "corrupt stream at row %u", _row);
+        ESP_RETURN_ON_ERROR(decode_span(NULL, _width - x1), TAG, "corrupt stream at row %u", _row);
+        if (dst) {
+            dst += dst_stride;
+        }
+        _row++;
+    }
+    return ESP_OK;
+}
+
+esp_err_t lcd_q565_decoder::decode_span(uint16_t *dst, uint32_t num)
+{
+    // 状态放进局部变量，热循环里不回写成员
+    const uint8_t *p = _p;
+    const uint8_t *end = _end;
+    uint16_t px = _prev;
+    uint32_t run = _run;
+    esp_err_t ret = ESP_OK;
+
+    while (num) {
+        if (run) {
+            uint32_t n = run < num ? run : num;
+            if (dst) {
+                for (uint32_t i = 0; i < n; i++) {
+                    dst[i] = px;
+                }
+                dst += n;
+            }
+            run -= n;
+            num -= n;
+            continue;
+        }
+        if (p >= end) {
+            ret = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+
+        uint8_t op = *p++;
+        if (op < Q565_OP_DIFF) {
+            px = _index[op];
+        } else if (op < Q565_OP_LUMA) {
+            uint16_t r = ((px >> 11) + ((op >> 4) & 0x03) - 2) & 0x1F;
+            uint16_t g = (((px >> 5) & 0x3F) + ((op >> 2) & 0x03) - 2) & 0x3F;
+            uint16_t b = ((px & 0x1F) + (op & 0x03) - 2) & 0x1F;
+            px = (r << 11) | (g << 5) | b;
+        } else if (op < Q565_OP_RUN) {
+            if (p >= end) {
+                ret = ESP_ERR_INVALID_SIZE;
+                break;
+            }
+            int dg = (int)(op & 0x3F) - 32;
+            int half = dg >> 1;
+            uint8_t rb = *p++;
+            uint16_t r = ((px >> 11) + half + (rb >> 4) - 8) & 0x1F;
+            uint16_t g = (((px >> 5) & 0x3F) + dg) & 0x3F;
+            uint16_t b = ((px & 0x1F) + half + (rb & 0x0F) - 8) & 0x1F;
+            px = (r << 11) | (g << 5) | b;
+        } else if (op < Q565_OP_RGB) {
+            run = op - Q565_OP_RUN + 1;
+            continue;
+        } else if (op == Q565_OP_RGB && end - p >= 2) {
+            px = p[0] | (p[1] << 8);
+            p += 2;
+        } else {
+            ret = ESP_ERR_INVALID_SIZE;
+            break;
+        }
+
+        _index[q565_hash(px)] = px;
+        if (dst) {
+            *dst++ = px;
+        }
+        num--;
+    }
+
+    _p = p;
+    _prev = px;
+    _run = run;
+    return ret;
+}
+
+esp_err_t lcd_q565_draw(lcd_blit *blit, lcd_stats_t *stats, const void *data, size_t size, int32_t x, int32_t y,
+                        uint16_t h_res, uint16_t v_res, uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h)
+{
+    ESP_RETURN_ON_FALSE(blit, ESP_ERR_INVALID_ARG, TAG, "invalid blitter");
+
+    lcd_q565_decoder dec;
+    ESP_RETURN_ON_ERROR(dec.begin(data, size), TAG, "invalid stream");
+
+    // 可见区域 = 图像 ∩ 裁剪矩形 ∩ 屏幕
+    int32_t vx0 = x > clip_x ? x : clip_x;
+    int32_t vy0 = y > clip_y ? y : clip_y;
+    int32_t vx1 = x + dec.width();
+    int32_t vy1 = y + dec.height();
+    int32_t cx1 = (int32_t)clip_x + clip_w < h_res ? (int32_t)clip_x + clip_w : h_res;
+    int32_t cy1 = (int32_t)clip_y + clip_h < v_res ? (int32_t)clip_y + clip_h : v_res;
+    vx1 = vx1 < cx1 ? vx1 : cx1;
+    vy1 = vy1 < cy1 ? vy1 : cy1;
+    if (vx0 >= vx1 || vy0 >= vy1) {
+        return ESP_OK;
+    }
+
+    uint16_t *fb = blit->cpu_begin();
+    ESP_RETURN_ON_FALSE(fb, ESP_ERR_INVALID_STATE, TAG, "frame buffer not available");
+
+    int64_t start = esp_timer_get_time();
+    uint16_t src_x = vx0 - x;
+    uint16_t w = vx1 - vx0;
+    esp_err_t ret = dec.skip_rows(vy0 - y);
+    for (int32_t row = vy0; row < vy1 && ret == ESP_OK; row += LCD_Q565_CHUNK_ROWS) {
+        uint16_t rows = (vy1 - row) < LCD_Q565_CHUNK_ROWS ? (vy1 - row) : LCD_Q565_CHUNK_ROWS;
+        ret = dec.decode_rows(fb + (uint32_t)row * h_res + vx0, h_res, rows, src_x, w);
+        blit->cpu_end(vx0, row, w, rows);
+    }
+
+    if (stats) {
+        stats->decode_pixels += (uint32_t)dec.row() * dec.width();
+        stats->decode_us += esp_timer_get_time() - start;
+    }
+    return ret;
+}
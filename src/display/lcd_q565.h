@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "lcd_blit.h"
+#include "lcd_stats.h"
+
+#define LCD_Q565_MAGIC 0x35363551    // "Q565"，小端
+#define LCD_Q565_CHUNK_ROWS 16       // 直接解码到帧缓冲时，每解码这么多行写回一次缓存
+
+/**
+ * @brief Stream header, written by `tools/q565.py`; the op bytes follow
+ */
+typedef struct {
+    uint32_t magic;   /*!< LCD_Q565_MAGIC */
+    uint16_t width;   /*!< Image width in pixels */
+    uint16_t height;  /*!< Image height in pixels */
+    uint32_t size;    /*!< Op bytes after the header */
+} lcd_q565_header_t;
+
+static_assert(sizeof(lcd_q565_header_t) == 12, "layout is shared with tools/q565.py");
+
+/**
+ * @brief Row-streaming decoder for Q565, a QOI-style codec over RGB565
+ *
+ * Every op is one to three bytes: an index into the 64 most recently hashed colors, a small
+ * per-channel delta, a green-relative delta, a run of the previous pixel or a literal pixel.
+ * The decoder keeps only that state (about 140 bytes), so rows can be decoded straight into a
+ * band buffer or the frame buffer in any number of calls, each clipped to a column range.
+ */
+class lcd_q565_decoder
+{
+public:
+    lcd_q565_decoder();
+
+    esp_err_t begin(const void *data, size_t size);
+    uint16_t width();
+    uint16_t height();
+    uint16_t row();
+    esp_err_t skip_rows(uint16_t rows);
+    esp_err_t decode_rows(uint16_t *dst, uint32_t dst_stride, uint16_t rows, uint16_t x = 0, uint16_t w = 0xFFFF);
+
+private:
+    esp_err_t decode_span(uint16_t *dst, uint32_t num);
+
+    const uint8_t *_p;
+    const uint8_t *_end;
+    uint16_t _width;
+    uint16_t _height;
+    uint16_t _row;
+    uint16_t _prev;
+    uint32_t _run;
+    uint16_t _index[64];
+};
+
+/**
+ * @brief Decode a Q565 stream straight into the frame buffer, no staging buffer
+ *
+ * The image is placed at (x, y) and clipped to the clip rectangle and the screen; rows above the
+ * visible part are decoded without being stored and decoding stops after the last visible row.
+ *
+ * @param stats Optional, receives the decoded pixel count and decode time
+ */
+esp_err_t lcd_q565_draw(lcd_blit *blit, lcd_stats_t *stats, const void *data, size_t size, int32_t x, int32_t y,
+                        uint16_t h_res, uint16_t v_res, uint16_t clip_x, uint16_t clip_y, uint16_t clip_w, uint16_t clip_h);
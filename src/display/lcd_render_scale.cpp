@@ -0,0 +1,207 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_affine.h"
+#include "lcd_render_scale.h"
+
+static const char *TAG = "lcd_render_scale";
+
+// 各档渲染分辨率相对面板的比例
+static const uint8_t s_num[LCD_RENDER_SCALE_LEVELS] = {1, 3, 2, 1};
+static const uint8_t s_den[LCD_RENDER_SCALE_LEVELS] = {1, 4, 3, 2};
+
+lcd_render_scale::lcd_render_scale()
+{
+    _blit = NULL;
+    _stats = NULL;
+    _h_res = 0;
+    _v_res = 0;
+    _level = 0;
+    _filter = LCD_RENDER_SCALE_NEAREST;
+    _budget_us = 0;
+    _avg_us = 0;
+    _hold = 0;
+}
+
+esp_err_t lcd_render_scale::begin(lcd_blit *blit, lcd_stats_t *stats, uint16_t h_res, uint16_t v_res)
+{
+    ESP_RETURN_ON_FALSE(blit && h_res && v_res, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+
+    _blit = blit;
+    _stats = stats;
+    _h_res = h_res;
+    _v_res = v_res;
+    _level = 0;
+    _avg_us = 0;
+    _hold = 0;
+    return ESP_OK;
+}
+
+bool lcd_render_scale::started()
+{
+    return _blit != NULL;
+}
+
+esp_err_t lcd_render_scale::set_level(uint8_t level)
+{
+    ESP_RETURN_ON_FALSE(_blit, ESP_ERR_INVALID_STATE, TAG, "not started");
+    ESP_RETURN_ON_FALSE(level < LCD_RENDER_SCALE_LEVELS, ESP_ERR_INVALID_ARG, TAG, "level must be 0~%d",
+                        LCD_RENDER_SCALE_LEVELS - 1);
+
+    if (level != _level) {
+        change_level(level);
+    }
+    return ESP_OK;
+}
+
+uint8_t lcd_render_scale::level()
+{
+    return _level;
+}
+
+bool lcd_render_scale::active()
+{
+    return _level != 0;
+}
+
+void lcd_render_scale::set_filter(lcd_render_scale_filter_t filter)
+{
+    _filter = filter;
+}
+
+void lcd_render_scale::set_budget(uint32_t budget_us)
+{
+    _budget_us = budget_us;
+    // 先攒够一段帧时间再开始调整
+    _avg_us = 0;
+    _hold = LCD_RENDER_SCALE_HOLD_FRAMES;
+}
+
+void lcd_render_scale::change_level(uint8_t level)
+{
+    ESP_LOGD(TAG, "render scale %d/%d -> %d/%d", s_num[_level], s_den[_level], s_num[level], s_den[level]);
+    _level = level;
+    // 新分辨率下的帧时间重新统计
+    _avg_us = 0;
+    _hold = LCD_RENDER_SCALE_HOLD_FRAMES;
+    if (_stats) {
+        _stats->scale_changes++;
+    }
+}
+
+bool lcd_render_scale::update(uint32_t frame_us)
+{
+    if (!_blit || !_budget_us) {
+        return false;
+    }
+
+    // 指数滑动平均，权重 1/8，单帧尖峰不会直接触发换档
+    _avg_us = _avg_us ? _avg_us + (int32_t)(frame_us - _avg_us) / 8 : frame_us;
+    if (_hold) {
+        _hold--;
+        return false;
+    }
+
+    if (_avg_us > _budget_us && _level + 1 < LCD_RENDER_SCALE_LEVELS) {
+        change_level(_level + 1);
+        return true;
+    }
+    if (_level > 0) {
+        // 渲染耗时按像素数估算：升一档后的预计帧时间 = 当前 × 面积比
+        uint64_t up = (uint64_t)s_num[_level - 1] * s_den[_level];
+        uint64_t cur = (uint64_t)s_num[_level] * s_den[_level - 1];
+        uint64_t expected = (uint64_t)_avg_us * up * up / (cur * cur);
+        if (expected * 100 < (uint64_t)_budget_us * LCD_RENDER_SCALE_HEADROOM) {
+            change_level(_level - 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t lcd_render_scale::width()
+{
+    return (uint32_t)_h_res * s_num[_level] / s_den[_level];
+}
+
+uint16_t lcd_render_scale::height()
+{
+    return (uint32_t)_v_res * s_num[_level] / s_den[_level];
+}
+
+uint16_t lcd_render_scale::to_panel(uint16_t v, uint16_t res)
+{
+    // 相邻矩形的公共边映射到同一位置，整帧的右下边正好落在面板边上
+    uint16_t render = res == _h_res ? width() : height();
+    return (uint32_t)v * res / render;
+}
+
+esp_err_t lcd_render_scale::draw(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end,
+                                 const uint16_t *color_data, uint16_t bounds[4])
+{
+    memset(bounds, 0, 4 * sizeof(uint16_t));
+    ESP_RETURN_ON_FALSE(_blit, ESP_ERR_INVALID_STATE, TAG, "not started");
+    ESP_RETURN_ON_FALSE(color_data && x_start < x_end && y_start < y_end && x_end <= width() && y_end <= height(),
+                        ESP_ERR_INVALID_ARG, TAG, "invalid rectangle");
+
+    int64_t start = esp_timer_get_time();
+    uint16_t w = x_end - x_start;
+    uint16_t h = y_end - y_start;
+    uint16_t x0 = to_panel(x_start, _h_res);
+    uint16_t y0 = to_panel(y_start, _v_res);
+    uint16_t dst_w = to_panel(x_end, _h_res) - x0;
+    uint16_t dst_h = to_panel(y_end, _v_res) - y0;
+    esp_err_t ret;
+
+    if (_filter == LCD_RENDER_SCALE_BILINEAR) {
+        // 放大即不旋转的仿射变换，借用仿射绘制的双线性内层循环
+        uint16_t *fb = _blit->cpu_begin();
+        ESP_RETURN_ON_FALSE(fb, ESP_ERR_INVALID_STATE, TAG, "frame buffer busy");
+        lcd_affine_image_t img = {
+            .pixels = color_data,
+            .stride = w,
+            .width = w,
+            .height = h,
+            .format = LCD_AFFINE_RGB565,
+        };
+        lcd_affine_xform_t xf = {
+            .angle = 0,
+            .scale_x = (float)dst_w / w,
+            .scale_y = (float)dst_h / h,
+            .pivot_x = 0,
+            .pivot_y = 0,
+            .x = x0,
+            .y = y0,
+            .bilinear = true,
+        };
+        ret = lcd_affine_draw(fb, _h_res, _h_res, _v_res, &img, &xf, x0, y0, dst_w, dst_h, bounds, NULL);
+        _blit->cpu_end(bounds[0], bounds[1], bounds[2], bounds[3]);
+    } else {
+        lcd_blit_op_t op = {};
+        op.type = LCD_BLIT_OP_SCALE;
+        op.rect.src = color_data;
+        op.rect.src_stride = w;
+        op.rect.x = x0;
+        op.rect.y = y0;
+        op.rect.w = w;
+        op.rect.h = h;
+        op.dst_w = dst_w;
+        op.dst_h = dst_h;
+        ret = _blit->run(&op, 1);
+        if (ret == ESP_OK) {
+            bounds[0] = x0;
+            bounds[1] = y0;
+            bounds[2] = dst_w;
+            bounds[3] = dst_h;
+        }
+    }
+
+    if (_stats) {
+        _stats->scale_pixels += (uint32_t)dst_w * dst_h;
+        _stats->scale_us += esp_timer_get_time() - start;
+    }
+    return ret;
+}
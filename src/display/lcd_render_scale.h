@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "lcd_blit.h"
+#include "lcd_stats.h"
+
+#define LCD_RENDER_SCALE_LEVELS 4          // 1, 3/4, 2/3, 1/2
+#define LCD_RENDER_SCALE_HOLD_FRAMES 30    // 换档后至少保持的帧数，避免来回跳
+#define LCD_RENDER_SCALE_HEADROOM 85       // 升档后预计帧时间不超过预算的百分比才升
+
+/**
+ * @brief Filter used to upscale rendered rectangles to the panel
+ */
+typedef enum {
+    LCD_RENDER_SCALE_NEAREST = 0,  /*!< PPA scale when the ratio is exact in 1/16 steps, CPU otherwise */
+    LCD_RENDER_SCALE_BILINEAR,     /*!< CPU bilinear, edges clamp to the rectangle being drawn */
+} lcd_render_scale_filter_t;
+
+/**
+ * @brief Renders at a reduced internal resolution and upscales to the panel on draw
+ *
+ * Level 0 is native resolution; levels 1~3 render at 3/4, 2/3 and 1/2 of it in both directions.
+ * Rectangles given in render coordinates are mapped to panel coordinates so that adjacent
+ * rectangles meet without gaps. With a frame-time budget set, `update()` drops a level when the
+ * averaged frame time exceeds the budget and raises it again once the higher level is expected
+ * to fit with headroom. Not thread-safe, call from the task that draws.
+ */
+class lcd_render_scale
+{
+public:
+    lcd_render_scale();
+
+    esp_err_t begin(lcd_blit *blit, lcd_stats_t *stats, uint16_t h_res, uint16_t v_res);
+    bool started();
+    esp_err_t set_level(uint8_t level);
+    uint8_t level();
+    bool active();
+    void set_filter(lcd_render_scale_filter_t filter);
+    void set_budget(uint32_t budget_us);
+    bool update(uint32_t frame_us);
+    uint16_t width();
+    uint16_t height();
+    esp_err_t draw(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, const uint16_t *color_data,
+                   uint16_t bounds[4]);
+
+private:
+    uint16_t to_panel(uint16_t v, uint16_t res);
+    void change_level(uint8_t level);
+
+    lcd_blit *_blit;
+    lcd_stats_t *_stats;
+    uint16_t _h_res;
+    uint16_t _v_res;
+    uint8_t _level;
+    uint8_t _filter;
+    uint32_t _budget_us;
+    uint32_t _avg_us;
+    uint32_t _hold;
+};
@@ -0,0 +1,184 @@
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_screen_cache.h"
+
+static const char *TAG = "lcd_screen_cache";
+
+lcd_screen_cache::lcd_screen_cache()
+{
+    _blit = NULL;
+    _events = NULL;
+    _stats = NULL;
+    _h_res = 0;
+    _v_res = 0;
+    _size = 0;
+    _max_slots = 0;
+    _clock = 0;
+    memset(_slots, 0, sizeof(_slots));
+}
+
+lcd_screen_cache::~lcd_screen_cache()
+{
+    end();
+}
+
+esp_err_t lcd_screen_cache::begin(lcd_blit *blit, lcd_events *events, lcd_stats_t *stats, uint16_t h_res,
+                                  uint16_t v_res, uint8_t max_slots)
+{
+    ESP_RETURN_ON_FALSE(blit && events && h_res && v_res, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(max_slots >= 1 && max_slots <= LCD_SCREEN_CACHE_MAX_SLOTS, ESP_ERR_INVALID_ARG, TAG,
+                        "slot number must be 1~%d", LCD_SCREEN_CACHE_MAX_SLOTS);
+    ESP_RETURN_ON_FALSE(!_max_slots, ESP_ERR_INVALID_STATE, TAG, "screen cache already started");
+
+    _blit = blit;
+    _events = events;
+    _stats = stats;
+    _h_res = h_res;
+    _v_res = v_res;
+    // 按缓存行取整，PPA 要求输出缓冲大小也对齐
+    _size = ((size_t)h_res * v_res * sizeof(uint16_t) + LCD_SCREEN_CACHE_ALIGN - 1) & ~(size_t)(LCD_SCREEN_CACHE_ALIGN - 1);
+    _max_slots = max_slots;
+    _clock = 0;
+    ESP_LOGI(TAG, "up to %d screens, %u bytes PSRAM each", max_slots, (unsigned)_size);
+    return ESP_OK;
+}
+
+void lcd_screen_cache::end()
+{
+    // 恢复用的 DMA 可能还在读槽位
+    if (_events) {
+        _events->wait_idle();
+    }
+    for (uint8_t i = 0; i < LCD_SCREEN_CACHE_MAX_SLOTS; i++) {
+        if (_slots[i].buf) {
+            heap_caps_free(_slots[i].buf);
+        }
+    }
+    memset(_slots, 0, sizeof(_slots));
+    _max_slots = 0;
+    _events = NULL;
+    _blit = NULL;
+}
+
+bool lcd_screen_cache::started()
+{
+    return _max_slots != 0;
+}
+
+int lcd_screen_cache::find(uint32_t id)
+{
+    for (uint8_t i = 0; i < _max_slots; i++) {
+        if (_slots[i].valid && _slots[i].id == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int lcd_screen_cache::pick_slot()
+{
+    // 优先用已分配的空槽位，其次新分配，都不行再淘汰最久没用过的屏幕
+    for (uint8_t i = 0; i < _max_slots; i++) {
+        if (_slots[i].buf && !_slots[i].valid) {
+            return i;
+        }
+    }
+    for (uint8_t i = 0; i < _max_slots; i++) {
+        if (!_slots[i].buf) {
+            _slots[i].buf = (uint16_t *)heap_caps_aligned_alloc(LCD_SCREEN_CACHE_ALIGN, _size, MALLOC_CAP_SPIRAM);
+            if (_slots[i].buf) {
+                return i;
+            }
+            ESP_LOGW(TAG, "no PSRAM for slot %d, reusing the oldest screen", i);
+            break;
+        }
+    }
+
+    int lru = -1;
+    for (uint8_t i = 0; i < _max_slots; i++) {
+        if (_slots[i].valid && (lru < 0 || (int32_t)(_slots[i].last_use - _slots[lru].last_use) < 0)) {
+            lru = i;
+        }
+    }
+    if (lru >= 0) {
+        _slots[lru].valid = false;
+        if (_stats) {
+            _stats->screen_evictions++;
+        }
+    }
+    return lru;
+}
+
+esp_err_t lcd_screen_cache::store(uint32_t id)
+{
+    ESP_RETURN_ON_FALSE(_max_slots, ESP_ERR_INVALID_STATE, TAG, "screen cache not started");
+
+    int i = find(id);
+    if (i < 0) {
+        i = pick_slot();
+        ESP_RETURN_ON_FALSE(i >= 0, ESP_ERR_NO_MEM, TAG, "no slot for screen 0x%08lx", (unsigned long)id);
+    }
+
+    // 拷贝过程中槽位无效，失败时不会留下半张画面
+    _slots[i].valid = false;
+    ESP_RETURN_ON_ERROR(_blit->read_back(_slots[i].buf, _size), TAG, "snapshot failed");
+    _slots[i].id = id;
+    _slots[i].last_use = ++_clock;
+    _slots[i].valid = true;
+    return ESP_OK;
+}
+
+esp_err_t lcd_screen_cache::restore(uint32_t id)
+{
+    ESP_RETURN_ON_FALSE(_max_slots, ESP_ERR_INVALID_STATE, TAG, "screen cache not started");
+
+    int i = find(id);
+    if (i < 0) {
+        if (_stats) {
+            _stats->screen_misses++;
+        }
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (_stats) {
+        _stats->screen_hits++;
+    }
+    _slots[i].last_use = ++_clock;
+
+    // 整帧交给面板，由 DMA2D 一次搬进帧缓冲，不经过 CPU
+    return _events->draw(0, 0, _h_res, _v_res, _slots[i].buf);
+}
+
+bool lcd_screen_cache::contains(uint32_t id)
+{
+    return find(id) >= 0;
+}
+
+const uint16_t *lcd_screen_cache::pixels(uint32_t id)
+{
+    // 给转场等直接读取快照的调用方使用，同样算一次使用
+    int i = find(id);
+    if (i < 0) {
+        return NULL;
+    }
+    _slots[i].last_use = ++_clock;
+    return _slots[i].buf;
+}
+
+void lcd_screen_cache::invalidate(uint32_t id)
+{
+    int i = find(id);
+    if (i >= 0) {
+        _slots[i].valid = false;
+    }
+}
+
+void lcd_screen_cache::invalidate_all()
+{
+    for (uint8_t i = 0; i < LCD_SCREEN_CACHE_MAX_SLOTS; i++) {
+        _slots[i].valid = false;
+    }
+}
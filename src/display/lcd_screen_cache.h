@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "lcd_events.h"
+#include "lcd_blit.h"
+#include "lcd_stats.h"
+
+#define LCD_SCREEN_CACHE_MAX_SLOTS 8
+#define LCD_SCREEN_CACHE_ALIGN 64 // 缓存行对齐，PPA 可直接写入
+
+/**
+ * @brief Full-screen snapshots of rendered screens in PSRAM, for switching without re-rendering
+ *
+ * `store()` copies the frame buffer into a slot tagged with an application screen id; `restore()`
+ * hands the slot to the panel, which copies it back into the frame buffer with one 2D-DMA
+ * transfer. Slots are allocated on first use, up to `max_slots`; when all are taken the least
+ * recently stored or restored screen is dropped. Not thread-safe, call from the UI task.
+ */
+class lcd_screen_cache
+{
+public:
+    lcd_screen_cache();
+    ~lcd_screen_cache();
+
+    esp_err_t begin(lcd_blit *blit, lcd_events *events, lcd_stats_t *stats, uint16_t h_res, uint16_t v_res,
+                    uint8_t max_slots);
+    void end();
+    bool started();
+    esp_err_t store(uint32_t id);
+    esp_err_t restore(uint32_t id);
+    bool contains(uint32_t id);
+    const uint16_t *pixels(uint32_t id);
+    void invalidate(uint32_t id);
+    void invalidate_all();
+
+private:
+    typedef struct {
+        uint16_t *buf;
+        uint32_t id;
+        uint32_t last_use;
+        bool valid;
+    } slot_t;
+
+    int find(uint32_t id);
+    int pick_slot();
+
+    lcd_blit *_blit;
+    lcd_events *_events;
+    lcd_stats_t *_stats;
+    uint16_t _h_res;
+    uint16_t _v_res;
+    size_t _size;
+    uint8_t _max_slots;
+    uint32_t _clock;
+    slot_t _slots[LCD_SCREEN_CACHE_MAX_SLOTS];
+};
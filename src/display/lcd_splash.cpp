@@ -0,0 +1,55 @@
+#include "esp_partition.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_splash.h"
+
+static const char *TAG = "lcd_splash";
+
+esp_err_t lcd_splash_show(lcd_events *events, lcd_blit *blit, const char *partition_label, uint16_t h_res,
+                          uint16_t v_res)
+{
+    ESP_RETURN_ON_FALSE(events && blit && partition_label, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, partition_label);
+    ESP_RETURN_ON_FALSE(part, ESP_ERR_NOT_FOUND, TAG, "no partition \"%s\"", partition_label);
+
+    // 先单独读出头部做校验，只映射真正用到的长度
+    lcd_splash_header_t header;
+    ESP_RETURN_ON_ERROR(esp_partition_read(part, 0, &header, sizeof(header)), TAG, "read header failed");
+    ESP_RETURN_ON_FALSE(header.magic == LCD_SPLASH_MAGIC && header.format == LCD_SPLASH_FORMAT_RGB565,
+                        ESP_ERR_NOT_SUPPORTED, TAG, "not a RGB565 splash image");
+    ESP_RETURN_ON_FALSE(header.width && header.height && header.x + header.width <= h_res && header.y + header.height <= v_res,
+                        ESP_ERR_INVALID_SIZE, TAG, "image %ux%u at (%u, %u) does not fit the screen",
+                        header.width, header.height, header.x, header.y);
+    size_t size = sizeof(header) + (size_t)header.width * header.height * sizeof(uint16_t);
+    ESP_RETURN_ON_FALSE(size <= part->size, ESP_ERR_INVALID_SIZE, TAG, "image larger than the partition");
+
+    const void *mapped = NULL;
+    esp_partition_mmap_handle_t mmap_handle;
+    ESP_RETURN_ON_ERROR(esp_partition_mmap(part, 0, size, ESP_PARTITION_MMAP_DATA, &mapped, &mmap_handle), TAG, "mmap failed");
+
+    // DMA2D 直接从映射的 flash 地址读取，搬运完成前不能解除映射
+    const uint16_t *pixels = (const uint16_t *)((const uint8_t *)mapped + sizeof(header));
+    esp_err_t ret;
+    if (blit->color_lut_active()) {
+        // DMA2D 不能查表，开了颜色校正时由 lcd_blit 在 CPU 上边拷贝边校正
+        lcd_blit_op_t op = {};
+        op.type = LCD_BLIT_OP_BLIT;
+        op.rect.src = pixels;
+        op.rect.src_stride = header.width;
+        op.rect.x = header.x;
+        op.rect.y = header.y;
+        op.rect.w = header.width;
+        op.rect.h = header.height;
+        ret = blit->run(&op, 1);
+    } else {
+        ret = events->draw(header.x, header.y, header.x + header.width, header.y + header.height, pixels);
+        if (ret == ESP_OK) {
+            ret = events->wait_idle();
+        }
+    }
+    esp_partition_munmap(mmap_handle);
+    return ret;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "lcd_events.h"
+#include "lcd_blit.h"
+
+#define LCD_SPLASH_MAGIC 0x314C5053 // "SPL1"，小端
+#define LCD_SPLASH_FORMAT_RGB565 0  // 小端 RGB565，与 DPI 帧缓冲格式一致
+
+/**
+ * @brief Header at offset 0 of the splash partition, pixel rows follow without padding
+ *
+ * Written by `tools/png2splash.py`. The image is placed at (x, y) and may be smaller than the screen.
+ */
+typedef struct {
+    uint32_t magic;      /*!< LCD_SPLASH_MAGIC */
+    uint16_t width;      /*!< Image width in pixels */
+    uint16_t height;     /*!< Image height in pixels */
+    uint16_t x;          /*!< Left edge on screen */
+    uint16_t y;          /*!< Top edge on screen */
+    uint8_t format;      /*!< LCD_SPLASH_FORMAT_* */
+    uint8_t reserved[3];
+} lcd_splash_header_t;
+
+static_assert(sizeof(lcd_splash_header_t) == 16, "splash header layout is shared with tools/png2splash.py");
+
+/**
+ * @brief Copy the splash image stored in a data partition into the frame buffer
+ *
+ * The partition is memory-mapped and handed to the panel's DMA2D copy as is: nothing is allocated
+ * or decoded. With a colour LUT active on `blit` the image is copied and corrected by the CPU
+ * instead. Returns once the copy is done and the mapping is released.
+ *
+ * @param events Started event owner of the panel
+ * @param blit Started blitter of the panel, selects the corrected copy
+ * @param partition_label Label of the data partition holding the image
+ * @param h_res Horizontal resolution, for bounds checking
+ * @param v_res Vertical resolution, for bounds checking
+ * @return
+ *      - ESP_ERR_NOT_FOUND     if there is no such partition
+ *      - ESP_ERR_INVALID_SIZE  if the image does not fit the partition or the screen
+ *      - ESP_ERR_NOT_SUPPORTED if the header magic or pixel format is unknown
+ *      - ESP_OK                on success
+ */
+esp_err_t lcd_splash_show(lcd_events *events, lcd_blit *blit, const char *partition_label, uint16_t h_res,
+                          uint16_t v_res);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Per-display counters, filled in by the display class and its components
+ */
+typedef struct {
+    uint32_t draw_calls;     /*!< Number of bitmaps submitted to the panel */
+    uint64_t draw_pixels;    /*!< Number of pixels submitted to the panel */
+    uint32_t band_flushes;   /*!< Number of bands flushed in band-rendering mode */
+    uint32_t band_stalls;    /*!< Number of times the renderer had to wait for a free band */
+    uint64_t band_stall_us;  /*!< Total time spent waiting for a free band */
+    uint32_t tiles_checked;  /*!< Number of tiles hashed by the tile-diff stage */
+    uint32_t tiles_skipped;  /*!< Number of tiles left untouched because their hash did not change */
+    uint64_t decode_pixels;  /*!< Number of compressed-image pixels decoded, including clipped ones */
+    uint64_t decode_us;      /*!< Total time spent decoding compressed images */
+    uint32_t text_glyphs;    /*!< Number of glyphs rendered, excluding fully clipped ones */
+    uint64_t text_us;        /*!< Total time spent rendering text */
+    uint32_t screen_hits;    /*!< Number of screens restored from the screen cache */
+    uint32_t screen_misses;  /*!< Number of restores of screens not in the screen cache */
+    uint32_t screen_evictions; /*!< Number of cached screens dropped to make room */
+    uint32_t transition_frames; /*!< Number of transition frames drawn */
+    uint32_t transition_missed; /*!< Number of panel refreshes a transition frame overran */
+    uint32_t affine_pixels;  /*!< Number of pixels written by affine draws */
+    uint64_t affine_us;      /*!< Total time spent in affine draws */
+    uint64_t scale_pixels;   /*!< Number of panel pixels produced by render-scale upscaling */
+    uint64_t scale_us;       /*!< Total time spent upscaling */
+    uint32_t scale_changes;  /*!< Number of render-scale level changes */
+    uint64_t dither_pixels;  /*!< Number of RGB888 pixels dithered to RGB565 */
+    uint64_t dither_us;      /*!< Total time spent dithering */
+    uint64_t color_lut_pixels; /*!< Number of pixels passed through the colour-correction tables */
+    uint64_t color_lut_us;   /*!< Total time spent in colour correction */
+    uint64_t indexed_pixels; /*!< Number of indexed-surface pixels expanded to RGB565 */
+    uint64_t indexed_us;     /*!< Total time spent expanding indexed surfaces */
+    uint32_t submit_frames;  /*!< Number of rectangles drawn from the multi-producer submission queue */
+    uint32_t submit_stalls;  /*!< Number of times a producer waited for room in its submission queue */
+    uint32_t cache_syncs;    /*!< Number of cache write-backs issued for CPU-written framebuffer ranges */
+    uint64_t cache_sync_bytes; /*!< Number of framebuffer bytes written back from the cache */
+} lcd_stats_t;
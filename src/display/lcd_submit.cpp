@@ -0,0 +1,233 @@
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_submit.h"
+
+static const char *TAG = "lcd_submit";
+
+lcd_submit::lcd_submit()
+{
+    _flush_cb = NULL;
+    _flush_ctx = NULL;
+    _stats = NULL;
+    _flush_task = NULL;
+    _running = false;
+    _submitting = 0;
+    for (int i = 0; i < LCD_SUBMIT_MAX_PRODUCERS; i++) {
+        _producers[i].head = 0;
+        _producers[i].tail = 0;
+        _producers[i].waiting = NULL;
+        _producers[i].active = false;
+        _producers[i].done_cb = NULL;
+        _producers[i].done_ctx = NULL;
+        _producers[i].z = 0;
+    }
+    _num = 0;
+}
+
+lcd_submit::~lcd_submit()
+{
+    end();
+}
+
+esp_err_t lcd_submit::begin(lcd_frame_cb_t flush_cb, void *flush_ctx, lcd_stats_t *stats, BaseType_t flush_core,
+                            UBaseType_t priority)
+{
+    ESP_RETURN_ON_FALSE(flush_cb, ESP_ERR_INVALID_ARG, TAG, "invalid flush callback");
+    ESP_RETURN_ON_FALSE(!_running, ESP_ERR_INVALID_STATE, TAG, "already started");
+
+    _flush_cb = flush_cb;
+    _flush_ctx = flush_ctx;
+    _stats = stats;
+    _running = true;
+
+    TaskHandle_t task = NULL;
+    if (xTaskCreatePinnedToCore(flush_task, "lcd_submit", LCD_SUBMIT_STACK_SIZE, this, priority, &task,
+                                flush_core) != pdPASS) {
+        _running = false;
+        return ESP_ERR_NO_MEM;
+    }
+    _flush_task = task;
+    return ESP_OK;
+}
+
+void lcd_submit::end()
+{
+    if (!_running) {
+        return;
+    }
+    _running = false;
+    // 队列满而阻塞的生产者不会再等到刷新任务腾出槽位，全部叫醒，它们看到 _running 为 false 后返回失败
+    uint8_t num = _num.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < num; i++) {
+        TaskHandle_t waiting = _producers[i].waiting.exchange(NULL);
+        if (waiting) {
+            xTaskNotifyGive(waiting);
+        }
+    }
+    // 刷新任务醒来后看到 _running 为 false 会自行退出并清空句柄；队列里剩下的不再绘制
+    TaskHandle_t task;
+    while ((task = _flush_task.load()) != NULL) {
+        xTaskNotifyGive(task);
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    // 还在 submit() 里的生产者要么已看到 _running 为 false，要么正要返回，等它们都离开再交还对象
+    while (_submitting.load()) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+}
+
+bool lcd_submit::started()
+{
+    return _running;
+}
+
+bool lcd_submit::in_flush_task()
+{
+    TaskHandle_t task = _flush_task.load();
+    return task && xTaskGetCurrentTaskHandle() == task;
+}
+
+int lcd_submit::add_producer(uint8_t z, lcd_frame_cb_t done_cb, void *done_ctx)
+{
+    // 用 CAS 占一个槽位，填好后再置 active，刷新任务不会读到半初始化的生产者
+    uint8_t id = _num.load();
+    do {
+        if (id >= LCD_SUBMIT_MAX_PRODUCERS) {
+            ESP_LOGE(TAG, "too many producers");
+            return -1;
+        }
+    } while (!_num.compare_exchange_weak(id, id + 1));
+
+    producer_t *p = &_producers[id];
+    p->done_cb = done_cb;
+    p->done_ctx = done_ctx;
+    p->z = z;
+    p->active.store(true, std::memory_order_release);
+    return id;
+}
+
+bool lcd_submit::submit(int producer, const lcd_frame_t *frame, TickType_t timeout)
+{
+    // 先计数再看 _running：end() 清掉 _running 后只需等计数归零，不会有生产者还在读写本对象
+    _submitting.fetch_add(1);
+    bool ret = push(producer, frame, timeout);
+    _submitting.fetch_sub(1);
+    return ret;
+}
+
+bool lcd_submit::push(int producer, const lcd_frame_t *frame, TickType_t timeout)
+{
+    if (!_running || !frame || producer < 0 || producer >= _num.load(std::memory_order_acquire) ||
+        !_producers[producer].active.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // 每个生产者只写自己的队列，生产者之间没有共享的写位置
+    producer_t *p = &_producers[producer];
+    uint32_t tail = p->tail.load(std::memory_order_relaxed);
+    TimeOut_t start;
+    vTaskSetTimeOutState(&start);
+    while (tail - p->head.load(std::memory_order_acquire) >= LCD_SUBMIT_QUEUE_LEN) {
+        // 队列已满：登记等待后再检查一次，避免错过刷新任务或 end() 的唤醒
+        p->waiting.store(xTaskGetCurrentTaskHandle());
+        if (!_running) {
+            p->waiting.store(NULL);
+            return false;
+        }
+        if (tail - p->head.load(std::memory_order_acquire) < LCD_SUBMIT_QUEUE_LEN) {
+            p->waiting.store(NULL);
+            break;
+        }
+        // 醒来时可能还没有空位（例如残留的通知），只等剩下的时间，总的等待不超过 timeout
+        if (xTaskCheckForTimeOut(&start, &timeout) == pdTRUE) {
+            p->waiting.store(NULL);
+            return false;
+        }
+        ulTaskNotifyTake(pdTRUE, timeout);
+    }
+    if (!_running) {
+        return false;
+    }
+
+    p->ring[tail % LCD_SUBMIT_QUEUE_LEN] = *frame;
+    p->tail.store(tail + 1, std::memory_order_release);
+    // 句柄只读一次：刷新任务退出时会清空它，空句柄不能拿去通知
+    TaskHandle_t task = _flush_task.load();
+    if (task) {
+        xTaskNotifyGive(task);
+    }
+    return true;
+}
+
+size_t lcd_submit::drain()
+{
+    uint8_t order[LCD_SUBMIT_MAX_PRODUCERS];
+    uint32_t tails[LCD_SUBMIT_MAX_PRODUCERS];
+    uint8_t num = _num.load(std::memory_order_acquire);
+    uint8_t n = 0;
+
+    // 按 z 从小到大排好本轮的生产者，z 相同保持注册顺序
+    for (uint8_t i = 0; i < num; i++) {
+        if (!_producers[i].active.load(std::memory_order_acquire)) {
+            continue;
+        }
+        uint8_t j = n++;
+        while (j > 0 && _producers[order[j - 1]].z > _producers[i].z) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    // 先给所有队列拍快照，本轮之后才提交的留到下一轮，不会插到高层前面
+    for (uint8_t k = 0; k < n; k++) {
+        tails[k] = _producers[order[k]].tail.load(std::memory_order_acquire);
+    }
+
+    size_t drawn = 0;
+    for (uint8_t k = 0; k < n; k++) {
+        producer_t *p = &_producers[order[k]];
+        for (uint32_t head = p->head.load(std::memory_order_relaxed); head != tails[k]; head++) {
+            lcd_frame_t frame = p->ring[head % LCD_SUBMIT_QUEUE_LEN];
+            _flush_cb(&frame, _flush_ctx);
+            if (p->done_cb) {
+                p->done_cb(&frame, p->done_ctx);
+            }
+
+            // 刷新完成后才释放槽位，生产者拿回的缓冲区不会还在被 DMA 读
+            p->head.store(head + 1, std::memory_order_release);
+            TaskHandle_t waiting = p->waiting.exchange(NULL);
+            if (waiting) {
+                xTaskNotifyGive(waiting);
+                if (_stats) {
+                    _stats->submit_stalls++;
+                }
+            }
+            drawn++;
+        }
+    }
+    if (_stats) {
+        _stats->submit_frames += drawn;
+    }
+    return drawn;
+}
+
+void lcd_submit::flush_task(void *arg)
+{
+    lcd_submit *self = (lcd_submit *)arg;
+
+    // begin() 拿到句柄前就可能有帧入队；先登记句柄再 drain()，这样的帧要么被本轮取走，要么生产者能看到句柄来通知
+    self->_flush_task = xTaskGetCurrentTaskHandle();
+    while (self->_running) {
+        if (!self->drain()) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+
+    self->_flush_task = NULL;
+    vTaskDelete(NULL);
+}
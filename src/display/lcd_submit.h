@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdio.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lcd_pipeline.h"
+#include "lcd_stats.h"
+
+#define LCD_SUBMIT_MAX_PRODUCERS 4
+#define LCD_SUBMIT_QUEUE_LEN 4       // 每个生产者的队列深度
+#define LCD_SUBMIT_STACK_SIZE 4096
+
+/**
+ * @brief Multi-producer draw submission in front of the panel, drained by a single flush task
+ *
+ * Each producer (status bar, overlay, UI, ...) registers once with `add_producer()` and gets its
+ * own bounded single-producer single-consumer lock-free ring, so producers never contend with each
+ * other and nobody holds a lock while the flush task waits for DMA. Only the flush task touches the
+ * panel. A full ring blocks only its own producer, up to `timeout`, until the flush task frees a
+ * slot. On each pass the flush task takes everything queued so far and draws it in ascending
+ * `z` (registration order for equal `z`), so within a pass higher layers land on top. A producer
+ * id must only be used by one task at a time.
+ */
+class lcd_submit
+{
+public:
+    lcd_submit();
+    ~lcd_submit();
+
+    esp_err_t begin(lcd_frame_cb_t flush_cb, void *flush_ctx, lcd_stats_t *stats, BaseType_t flush_core = 1,
+                    UBaseType_t priority = 5);
+    void end();
+    bool started();
+    bool in_flush_task();
+    int add_producer(uint8_t z, lcd_frame_cb_t done_cb = NULL, void *done_ctx = NULL);
+    bool submit(int producer, const lcd_frame_t *frame, TickType_t timeout = portMAX_DELAY);
+
+private:
+    typedef struct {
+        lcd_frame_t ring[LCD_SUBMIT_QUEUE_LEN];
+        std::atomic<uint32_t> head;
+        std::atomic<uint32_t> tail;
+        std::atomic<TaskHandle_t> waiting;  /*!< Producer blocked on a full ring */
+        std::atomic<bool> active;           /*!< Set once the fields below are filled in */
+        lcd_frame_cb_t done_cb;
+        void *done_ctx;
+        uint8_t z;
+    } producer_t;
+
+    static void flush_task(void *arg);
+    bool push(int producer, const lcd_frame_t *frame, TickType_t timeout);
+    size_t drain();
+
+    lcd_frame_cb_t _flush_cb;
+    void *_flush_ctx;
+    lcd_stats_t *_stats;
+    std::atomic<TaskHandle_t> _flush_task;
+    std::atomic<bool> _running;
+    std::atomic<uint32_t> _submitting;  /*!< Calls still inside `submit()`, drained by `end()` */
+
+    producer_t _producers[LCD_SUBMIT_MAX_PRODUCERS];
+    std::atomic<uint8_t> _num;
+};
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+/*
+ * 带格式的像素表面：格式是模板参数，拷贝、填充、转换、旋转在编译期选好内层循环，循环里不再判断格式。
+ * 只依赖标准头文件，可以直接在主机上编译测试。
+ */
+
+/**
+ * @brief Pixel formats known to lcd_surface
+ */
+typedef enum {
+    LCD_PIXEL_RGB565 = 0,  /*!< Little-endian RGB565, the DPI frame buffer format */
+    LCD_PIXEL_RGB888,      /*!< 3 bytes per pixel, B first */
+    LCD_PIXEL_ARGB8888,    /*!< 0xAARRGGBB per pixel */
+} lcd_pixel_format_t;
+
+/**
+ * @brief Format traits: storage type, storage units per pixel, and conversion through 0xAARRGGBB
+ */
+struct lcd_format_rgb565 {
+    typedef uint16_t storage_t;
+    typedef uint16_t pixel_t;
+    static constexpr lcd_pixel_format_t id = LCD_PIXEL_RGB565;
+    static constexpr uint32_t units = 1;
+
+    static constexpr uint32_t to_argb(const storage_t *p)
+    {
+        return 0xFF000000 | ((uint32_t)(p[0] & 0xF800) << 8) | ((uint32_t)(p[0] & 0x07E0) << 5) |
+               ((uint32_t)(p[0] & 0x001F) << 3);
+    }
+    static constexpr pixel_t from_argb(uint32_t c)
+    {
+        return ((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F);
+    }
+    static inline void store(storage_t *p, pixel_t v)
+    {
+        p[0] = v;
+    }
+};
+
+struct lcd_format_rgb888 {
+    typedef uint8_t storage_t;
+    typedef uint32_t pixel_t;  /*!< 0xRRGGBB */
+    static constexpr lcd_pixel_format_t id = LCD_PIXEL_RGB888;
+    static constexpr uint32_t units = 3;
+
+    static constexpr uint32_t to_argb(const storage_t *p)
+    {
+        return 0xFF000000 | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+    }
+    static constexpr pixel_t from_argb(uint32_t c)
+    {
+        return c & 0xFFFFFF;
+    }
+    static inline void store(storage_t *p, pixel_t v)
+    {
+        p[0] = v;
+        p[1] = v >> 8;
+        p[2] = v >> 16;
+    }
+};
+
+struct lcd_format_argb8888 {
+    typedef uint32_t storage_t;
+    typedef uint32_t pixel_t;
+    static constexpr lcd_pixel_format_t id = LCD_PIXEL_ARGB8888;
+    static constexpr uint32_t units = 1;
+
+    static constexpr uint32_t to_argb(const storage_t *p)
+    {
+        return p[0];
+    }
+    static constexpr pixel_t from_argb(uint32_t c)
+    {
+        return c;
+    }
+    static inline void store(storage_t *p, pixel_t v)
+    {
+        p[0] = v;
+    }
+};
+
+/**
+ * @brief Non-owning typed view of pixels: data, size and stride (in pixels)
+ *
+ * Views are cheap to copy. `sub()` returns a clipped sub-rectangle sharing the same memory, and
+ * `rows()` iterates the start of each row, e.g. `for (auto *row : view.rows())`.
+ */
+template <class F>
+class lcd_surface
+{
+public:
+    typedef F format;
+    typedef typename F::storage_t storage_t;
+    typedef typename F::pixel_t pixel_t;
+
+    // 按行号迭代：子表面的最后一行之后可能已经超出底层缓冲区，不能先算出越界的行指针再比较
+    class row_iterator
+    {
+    public:
+        constexpr row_iterator(storage_t *data, size_t step, uint16_t y) : _data(data), _step(step), _y(y) {}
+        constexpr storage_t *operator*() const
+        {
+            return _data + (size_t)_y * _step;
+        }
+        row_iterator &operator++()
+        {
+            _y++;
+            return *this;
+        }
+        constexpr bool operator!=(const row_iterator &other) const
+        {
+            return _y != other._y;
+        }
+
+    private:
+        storage_t *_data;
+        size_t _step;
+        uint16_t _y;
+    };
+
+    class row_range
+    {
+    public:
+        constexpr row_range(row_iterator first, row_iterator last) : _first(first), _last(last) {}
+        constexpr row_iterator begin() const
+        {
+            return _first;
+        }
+        constexpr row_iterator end() const
+        {
+            return _last;
+        }
+
+    private:
+        row_iterator _first;
+        row_iterator _last;
+    };
+
+    constexpr lcd_surface() : _data(nullptr), _width(0), _height(0), _stride(0) {}
+    constexpr lcd_surface(storage_t *data, uint16_t width, uint16_t height, uint32_t stride = 0)
+        : _data(data), _width(width), _height(height), _stride(stride ? stride : width) {}
+
+    constexpr storage_t *data() const
+    {
+        return _data;
+    }
+    constexpr uint16_t width() const
+    {
+        return _width;
+    }
+    constexpr uint16_t height() const
+    {
+        return _height;
+    }
+    constexpr uint32_t stride() const
+    {
+        return _stride;
+    }
+    constexpr bool empty() const
+    {
+        return !_data || !_width || !_height;
+    }
+    constexpr storage_t *row(uint16_t y) const
+    {
+        return _data + (size_t)y * _stride * F::units;
+    }
+    constexpr storage_t *at(uint16_t x, uint16_t y) const
+    {
+        return row(y) + (size_t)x * F::units;
+    }
+    constexpr row_range rows() const
+    {
+        return row_range(row_iterator(_data, (size_t)_stride * F::units, 0),
+                         row_iterator(_data, (size_t)_stride * F::units, _height));
+    }
+
+    lcd_surface sub(uint16_t x, uint16_t y, uint16_t w, uint16_t h) const
+    {
+        if (x >= _width || y >= _height) {
+            return lcd_surface();
+        }
+        w = x + w > _width ? _width - x : w;
+        h = y + h > _height ? _height - y : h;
+        return lcd_surface(at(x, y), w, h, _stride);
+    }
+
+private:
+    storage_t *_data;
+    uint16_t _width;
+    uint16_t _height;
+    uint32_t _stride;
+};
+
+/**
+ * @brief Format-erased view, for passing surfaces through non-template code
+ *
+ * `as<F>()` gives back the typed view, or an empty one if the format does not match.
+ */
+class lcd_surface_view
+{
+public:
+    constexpr lcd_surface_view() : _data(nullptr), _width(0), _height(0), _stride(0), _format(LCD_PIXEL_RGB565) {}
+    template <class F>
+    constexpr lcd_surface_view(const lcd_surface<F> &s)
+        : _data(s.data()), _width(s.width()), _height(s.height()), _stride(s.stride()), _format(F::id) {}
+
+    constexpr lcd_pixel_format_t format() const
+    {
+        return _format;
+    }
+    constexpr uint16_t width() const
+    {
+        return _width;
+    }
+    constexpr uint16_t height() const
+    {
+        return _height;
+    }
+
+    template <class F>
+    lcd_surface<F> as() const
+    {
+        if (_format != F::id) {
+            return lcd_surface<F>();
+        }
+        return lcd_surface<F>((typename F::storage_t *)_data, _width, _height, _stride);
+    }
+
+private:
+    void *_data;
+    uint16_t _width;
+    uint16_t _height;
+    uint32_t _stride;
+    lcd_pixel_format_t _format;
+};
+
+/**
+ * @brief Fill a surface with one pixel value
+ */
+template <class F>
+void lcd_surface_fill(const lcd_surface<F> &dst, typename F::pixel_t value)
+{
+    for (auto *row : dst.rows()) {
+        if constexpr (F::units == 1) {
+            for (uint16_t x = 0; x < dst.width(); x++) {
+                row[x] = value;
+            }
+        } else {
+            for (uint16_t x = 0; x < dst.width(); x++) {
+                F::store(row + x * F::units, value);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Copy or convert `src` into `dst`; the overlapping top-left part of the two is copied
+ *
+ * Same format compiles to a row memcpy; RGB888 to RGB565 has its own loop; other pairs go
+ * through 0xAARRGGBB. Alpha is dropped, not blended.
+ */
+template <class D, class S>
+void lcd_surface_convert(const lcd_surface<D> &dst, const lcd_surface<S> &src)
+{
+    uint16_t w = dst.width() < src.width() ? dst.width() : src.width();
+    uint16_t h = dst.height() < src.height() ? dst.height() : src.height();
+
+    for (uint16_t y = 0; y < h; y++) {
+        typename D::storage_t *d = dst.row(y);
+        const typename S::storage_t *s = src.row(y);
+        if constexpr (std::is_same<D, S>::value) {
+            memmove(d, s, (size_t)w * D::units * sizeof(typename D::storage_t));
+        } else if constexpr (std::is_same<D, lcd_format_rgb565>::value && std::is_same<S, lcd_format_rgb888>::value) {
+            for (uint16_t x = 0; x < w; x++, s += 3) {
+                d[x] = ((s[2] & 0xF8) << 8) | ((s[1] & 0xFC) << 3) | (s[0] >> 3);
+            }
+        } else {
+            for (uint16_t x = 0; x < w; x++) {
+                D::store(d + x * D::units, D::from_argb(S::to_argb(s + x * S::units)));
+            }
+        }
+    }
+}
+
+/**
+ * @brief Same-format copy; a compile error if the formats differ
+ */
+template <class F>
+void lcd_surface_blit(const lcd_surface<F> &dst, const lcd_surface<F> &src)
+{
+    lcd_surface_convert(dst, src);
+}
+
+/**
+ * @brief Clockwise rotation for lcd_surface_rotate
+ */
+typedef enum {
+    LCD_SURFACE_ROTATE_90 = 90,
+    LCD_SURFACE_ROTATE_180 = 180,
+    LCD_SURFACE_ROTATE_270 = 270,
+} lcd_surface_rotation_t;
+
+#define LCD_SURFACE_ROTATE_BLOCK 16 // 按 16x16 分块转置，读写两边都留在少数几条缓存行里
+
+/**
+ * @brief Rotate `src` clockwise into `dst`; for 90/270 `dst` must be at least `src` with sides swapped
+ */
+template <lcd_surface_rotation_t R, class F>
+void lcd_surface_rotate(const lcd_surface<F> &dst, const lcd_surface<F> &src)
+{
+    uint16_t w = src.width();
+    uint16_t h = src.height();
+
+    if constexpr (R == LCD_SURFACE_ROTATE_180) {
+        if (dst.width() < w || dst.height() < h) {
+            return;
+        }
+    } else if (dst.width() < h || dst.height() < w) {
+        return;
+    }
+
+    for (uint16_t by = 0; by < h; by += LCD_SURFACE_ROTATE_BLOCK) {
+        uint16_t bh = h - by < LCD_SURFACE_ROTATE_BLOCK ? h - by : LCD_SURFACE_ROTATE_BLOCK;
+        for (uint16_t bx = 0; bx < w; bx += LCD_SURFACE_ROTATE_BLOCK) {
+            uint16_t bw = w - bx < LCD_SURFACE_ROTATE_BLOCK ? w - bx : LCD_SURFACE_ROTATE_BLOCK;
+            for (uint16_t y = by; y < by + bh; y++) {
+                const typename F::storage_t *s = src.row(y);
+                for (uint16_t x = bx; x < bx + bw; x++) {
+                    typename F::storage_t *d;
+                    if constexpr (R == LCD_SURFACE_ROTATE_90) {
+                        d = dst.at(h - 1 - y, x);
+                    } else if constexpr (R == LCD_SURFACE_ROTATE_180) {
+                        d = dst.at(w - 1 - x, h - 1 - y);
+                    } else {
+                        d = dst.at(y, w - 1 - x);
+                    }
+                    for (uint32_t i = 0; i < F::units; i++) {
+                        d[i] = s[x * F::units + i];
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,224 @@
+#include <string.h>
+#include "esp_lcd_mipi_dsi.h"
+#include "esp_heap_caps.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_tile_diff.h"
+
+static const char *TAG = "lcd_tile_diff";
+
+static inline uint32_t load32(const uint16_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t rotl32(uint32_t v, int r)
+{
+    return (v << r) | (v >> (32 - r));
+}
+
+// 四路交错的乘法哈希：每路处理一个 32 位字（两个像素），四条乘法链互不依赖，可以流水并行
+static uint32_t tile_hash(const uint16_t *src, uint32_t stride, uint16_t w, uint16_t h)
+{
+    uint32_t h0 = 0x811C9DC5, h1 = 0x01000193, h2 = 0x9E3779B9, h3 = 0x85EBCA6B;
+
+    for (uint16_t y = 0; y < h; y++) {
+        const uint16_t *p = src + (uint32_t)y * stride;
+        uint16_t x = 0;
+        for (; x + 8 <= w; x += 8) {
+            h0 = (h0 ^ load32(p + x)) * 0x9E3779B1u;
+            h1 = (h1 ^ load32(p + x + 2)) * 0x85EBCA77u;
+            h2 = (h2 ^ load32(p + x + 4)) * 0xC2B2AE3Du;
+            h3 = (h3 ^ load32(p + x + 6)) * 0x27D4EB2Fu;
+        }
+        for (; x < w; x++) {
+            h0 = (h0 ^ p[x]) * 0x9E3779B1u;
+        }
+    }
+
+    uint32_t hash = h0 ^ rotl32(h1, 7) ^ rotl32(h2, 13) ^ rotl32(h3, 19) ^ ((uint32_t)w << 16 | h);
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    hash ^= hash >> 12;
+    return hash;
+}
+
+lcd_tile_diff::lcd_tile_diff()
+{
+    _events = NULL;
+    _blit = NULL;
+    _stats = NULL;
+    _fb = NULL;
+    _h_res = 0;
+    _v_res = 0;
+    _tiles_x = 0;
+    _tiles_y = 0;
+    _hashes = NULL;
+    _valid = NULL;
+}
+
+lcd_tile_diff::~lcd_tile_diff()
+{
+    end();
+}
+
+esp_err_t lcd_tile_diff::begin(esp_lcd_panel_handle_t panel, lcd_events *events, lcd_blit *blit, lcd_stats_t *stats, uint16_t h_res, uint16_t v_res)
+{
+    ESP_RETURN_ON_FALSE(panel && events && blit && h_res && v_res, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(!_hashes, ESP_ERR_INVALID_STATE, TAG, "already started");
+
+    void *fb = NULL;
+    ESP_RETURN_ON_ERROR(esp_lcd_dpi_panel_get_frame_buffer(panel, 1, &fb), TAG, "get frame buffer failed");
+
+    _tiles_x = (h_res + LCD_TILE_SIZE - 1) / LCD_TILE_SIZE;
+    _tiles_y = (v_res + LCD_TILE_SIZE - 1) / LCD_TILE_SIZE;
+    size_t tiles = (size_t)_tiles_x * _tiles_y;
+    _hashes = (uint32_t *)heap_caps_calloc(tiles, sizeof(uint32_t), MALLOC_CAP_INTERNAL);
+    _valid = (uint8_t *)heap_caps_calloc(tiles, sizeof(uint8_t), MALLOC_CAP_INTERNAL);
+    if (!_hashes || !_valid) {
+        end();
+        ESP_LOGE(TAG, "no mem for %u tile hashes", (unsigned)tiles);
+        return ESP_ERR_NO_MEM;
+    }
+
+    _events = events;
+    _blit = blit;
+    _stats = stats;
+    _fb = (uint16_t *)fb;
+    _h_res = h_res;
+    _v_res = v_res;
+    return ESP_OK;
+}
+
+void lcd_tile_diff::end()
+{
+    if (_hashes) {
+        heap_caps_free(_hashes);
+        _hashes = NULL;
+    }
+    if (_valid) {
+        heap_caps_free(_valid);
+        _valid = NULL;
+    }
+    _fb = NULL;
+}
+
+bool lcd_tile_diff::started()
+{
+    return _hashes != NULL;
+}
+
+esp_err_t lcd_tile_diff::draw(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, const uint16_t *color_data)
+{
+    ESP_RETURN_ON_FALSE(_hashes, ESP_ERR_INVALID_STATE, TAG, "not started");
+    ESP_RETURN_ON_FALSE(x_start < x_end && y_start < y_end, ESP_ERR_INVALID_ARG, TAG, "invalid area");
+
+    // 源数据的行宽按调用者给的矩形算，超出屏幕的部分裁掉，与直接绘制时的行为一致
+    const uint16_t stride = x_end - x_start;
+    if (x_start >= _h_res || y_start >= _v_res) {
+        return ESP_OK;
+    }
+    x_end = x_end < _h_res ? x_end : _h_res;
+    y_end = y_end < _v_res ? y_end : _v_res;
+    uint16_t tx_first = x_start / LCD_TILE_SIZE;
+    uint16_t tx_last = (x_end - 1) / LCD_TILE_SIZE;
+    uint16_t ty_first = y_start / LCD_TILE_SIZE;
+    uint16_t ty_last = (y_end - 1) / LCD_TILE_SIZE;
+
+    // CPU 直接写帧缓冲，必须等之前提交的 DMA 搬运全部完成，否则旧数据可能覆盖新数据
+    ESP_RETURN_ON_ERROR(_events->wait_idle(), TAG, "wait for pending draws failed");
+
+    // 各段拷贝只登记脏范围，局部宽度的行在批处理结束时合并成少数几次写回
+    _blit->batch_begin();
+    for (uint16_t ty = ty_first; ty <= ty_last; ty++) {
+        uint16_t tile_y0 = ty * LCD_TILE_SIZE;
+        uint16_t tile_y1 = tile_y0 + LCD_TILE_SIZE < _v_res ? tile_y0 + LCD_TILE_SIZE : _v_res;
+        uint16_t ry0 = tile_y0 > y_start ? tile_y0 : y_start;
+        uint16_t ry1 = tile_y1 < y_end ? tile_y1 : y_end;
+        int run_x0 = -1;
+        uint16_t run_x1 = 0;
+
+        for (uint16_t tx = tx_first; tx <= tx_last; tx++) {
+            uint16_t tile_x0 = tx * LCD_TILE_SIZE;
+            uint16_t tile_x1 = tile_x0 + LCD_TILE_SIZE < _h_res ? tile_x0 + LCD_TILE_SIZE : _h_res;
+            uint16_t rx0 = tile_x0 > x_start ? tile_x0 : x_start;
+            uint16_t rx1 = tile_x1 < x_end ? tile_x1 : x_end;
+            uint32_t idx = (uint32_t)ty * _tiles_x + tx;
+            bool dirty = true;
+
+            if (rx0 == tile_x0 && rx1 == tile_x1 && ry0 == tile_y0 && ry1 == tile_y1) {
+                const uint16_t *src = color_data + (uint32_t)(ry0 - y_start) * stride + (rx0 - x_start);
+                uint32_t hash = tile_hash(src, stride, rx1 - rx0, ry1 - ry0);
+                if (_stats) {
+                    _stats->tiles_checked++;
+                }
+                if (_valid[idx] && _hashes[idx] == hash) {
+                    dirty = false;
+                    if (_stats) {
+                        _stats->tiles_skipped++;
+                    }
+                } else {
+                    _hashes[idx] = hash;
+                    _valid[idx] = 1;
+                }
+            } else {
+                // 只覆盖了部分的瓦片无法与上一帧比较，直接写入并作废其哈希
+                _valid[idx] = 0;
+            }
+
+            // 同一行中相邻的脏瓦片合并成一次拷贝
+            if (dirty) {
+                if (run_x0 < 0) {
+                    run_x0 = rx0;
+                }
+                run_x1 = rx1;
+            } else if (run_x0 >= 0) {
+                copy_run(run_x0, ry0, run_x1, ry1, color_data, x_start, y_start, stride);
+                run_x0 = -1;
+            }
+        }
+        if (run_x0 >= 0) {
+            copy_run(run_x0, ry0, run_x1, ry1, color_data, x_start, y_start, stride);
+        }
+    }
+    _blit->batch_end();
+    return ESP_OK;
+}
+
+void lcd_tile_diff::copy_run(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end,
+                             const uint16_t *color_data, uint16_t src_x, uint16_t src_y, uint16_t stride)
+{
+    size_t bytes = (size_t)(x_end - x_start) * sizeof(uint16_t);
+
+    for (uint16_t y = y_start; y < y_end; y++) {
+        uint16_t *dst = _fb + (uint32_t)y * _h_res + x_start;
+        const uint16_t *src = color_data + (uint32_t)(y - src_y) * stride + (x_start - src_x);
+        memcpy(dst, src, bytes);
+    }
+
+    // 只记下脏缓存行，draw() 结束时和本次其他拷贝一起合并写回
+    _blit->cpu_end(x_start, y_start, x_end - x_start, y_end - y_start);
+}
+
+void lcd_tile_diff::invalidate(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end)
+{
+    if (!_valid || x_start >= x_end || y_start >= y_end) {
+        return;
+    }
+    for (uint16_t ty = y_start / LCD_TILE_SIZE; ty <= (y_end - 1) / LCD_TILE_SIZE && ty < _tiles_y; ty++) {
+        for (uint16_t tx = x_start / LCD_TILE_SIZE; tx <= (x_end - 1) / LCD_TILE_SIZE && tx < _tiles_x; tx++) {
+            _valid[(uint32_t)ty * _tiles_x + tx] = 0;
+        }
+    }
+}
+
+void lcd_tile_diff::invalidate_all()
+{
+    if (_valid) {
+        memset(_valid, 0, (size_t)_tiles_x * _tiles_y);
+    }
+}
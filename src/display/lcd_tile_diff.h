@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdio.h>
+#include "lcd_events.h"
+#include "lcd_blit.h"
+#include "lcd_stats.h"
+
+#define LCD_TILE_SIZE 32
+
+/**
+ * @brief Tile-hash change detection in front of the framebuffer
+ *
+ * The screen is split into 32x32 tiles. For every tile fully covered by an incoming bitmap a
+ * hash is computed and compared with the hash stored for the previous frame; only tiles whose
+ * hash changed (plus partially covered tiles) are copied into the DPI framebuffer. The copied rows
+ * are written back through the `lcd_blit` dirty tracker, merged once per `draw()`. Areas reaching
+ * past the screen are clipped to it.
+ */
+class lcd_tile_diff
+{
+public:
+    lcd_tile_diff();
+    ~lcd_tile_diff();
+
+    esp_err_t begin(esp_lcd_panel_handle_t panel, lcd_events *events, lcd_blit *blit, lcd_stats_t *stats, uint16_t h_res, uint16_t v_res);
+    void end();
+    bool started();
+    esp_err_t draw(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end, const uint16_t *color_data);
+    void invalidate(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end);
+    void invalidate_all();
+
+private:
+    void copy_run(uint16_t x_start, uint16_t y_start, uint16_t x_end, uint16_t y_end,
+                  const uint16_t *color_data, uint16_t src_x, uint16_t src_y, uint16_t stride);
+
+    lcd_events *_events;
+    lcd_blit *_blit;
+    lcd_stats_t *_stats;
+    uint16_t *_fb;
+    uint16_t _h_res;
+    uint16_t _v_res;
+    uint16_t _tiles_x;
+    uint16_t _tiles_y;
+    uint32_t *_hashes;
+    uint8_t *_valid;
+};
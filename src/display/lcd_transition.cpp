@@ -0,0 +1,211 @@
+#include <string.h>
+#include "esp_timer.h"
+#include "esp_check.h"
+#include "esp_err.h"
+#include "esp_log.h"
+
+#include "lcd_transition.h"
+
+static const char *TAG = "lcd_transition";
+
+#define LCD_TRANSITION_ONE 65536 // 进度为 16.16 定点数
+
+static void set_op(lcd_blit_op_t *op, uint8_t type, const uint16_t *src, uint16_t stride, uint16_t src_x,
+                   uint16_t src_y, uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    memset(op, 0, sizeof(*op));
+    op->type = (w && h) ? type : LCD_BLIT_OP_NOP;
+    op->rect.src = src;
+    op->rect.src_stride = stride;
+    op->rect.src_x = src_x;
+    op->rect.src_y = src_y;
+    op->rect.x = x;
+    op->rect.y = y;
+    op->rect.w = w;
+    op->rect.h = h;
+}
+
+lcd_transition::lcd_transition()
+{
+    _blit = NULL;
+    _stats = NULL;
+    _h_res = 0;
+    _v_res = 0;
+    _vsync_sem = NULL;
+    _vsyncs = 0;
+}
+
+esp_err_t lcd_transition::begin(lcd_blit *blit, lcd_events *events, lcd_stats_t *stats, uint16_t h_res,
+                                uint16_t v_res)
+{
+    ESP_RETURN_ON_FALSE(blit && events && h_res && v_res, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+    ESP_RETURN_ON_FALSE(!_vsync_sem, ESP_ERR_INVALID_STATE, TAG, "already started");
+
+    // 监听器无法注销，信号量和监听器与对象同生命周期
+    _vsync_sem = xSemaphoreCreateBinary();
+    ESP_RETURN_ON_FALSE(_vsync_sem, ESP_ERR_NO_MEM, TAG, "no mem for semaphore");
+    esp_err_t ret = events->add_refresh_done_listener(on_refresh_done, this);
+    if (ret != ESP_OK) {
+        vSemaphoreDelete(_vsync_sem);
+        _vsync_sem = NULL;
+        return ret;
+    }
+
+    _blit = blit;
+    _stats = stats;
+    _h_res = h_res;
+    _v_res = v_res;
+    return ESP_OK;
+}
+
+bool lcd_transition::started()
+{
+    return _blit != NULL;
+}
+
+bool lcd_transition::on_refresh_done(void *user_ctx)
+{
+    lcd_transition *self = (lcd_transition *)user_ctx;
+    BaseType_t need_yield = pdFALSE;
+
+    self->_vsyncs = self->_vsyncs + 1;
+    xSemaphoreGiveFromISR(self->_vsync_sem, &need_yield);
+    return need_yield == pdTRUE;
+}
+
+uint32_t lcd_transition::ease_out(uint32_t t)
+{
+    // 三次缓出：1 - (1 - t)^3
+    uint64_t r = LCD_TRANSITION_ONE - t;
+    return LCD_TRANSITION_ONE - (uint32_t)((r * r * r) >> 32);
+}
+
+size_t lcd_transition::build(lcd_blit_op_t *ops, const uint16_t *from, const uint16_t *to, lcd_transition_type_t type,
+                             uint32_t p)
+{
+    uint16_t w = _h_res;
+    uint16_t h = _v_res;
+    uint16_t dx = (uint16_t)(((uint64_t)w * p) >> 16);
+    uint16_t dy = (uint16_t)(((uint64_t)h * p) >> 16);
+
+    // 滑入只画新画面已露出的部分，旧画面留在帧缓冲里不动；推入时两张画面都要重画
+    switch (type) {
+    case LCD_TRANSITION_SLIDE_LEFT:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, to, w, 0, 0, w - dx, 0, dx, h);
+        return 1;
+    case LCD_TRANSITION_SLIDE_RIGHT:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, to, w, w - dx, 0, 0, 0, dx, h);
+        return 1;
+    case LCD_TRANSITION_SLIDE_UP:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, to, w, 0, 0, 0, h - dy, w, dy);
+        return 1;
+    case LCD_TRANSITION_SLIDE_DOWN:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, to, w, 0, h - dy, 0, 0, w, dy);
+        return 1;
+    case LCD_TRANSITION_PUSH_LEFT:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, from, w, dx, 0, 0, 0, w - dx, h);
+        set_op(&ops[1], LCD_BLIT_OP_BLIT, to, w, 0, 0, w - dx, 0, dx, h);
+        return 2;
+    case LCD_TRANSITION_PUSH_RIGHT:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, from, w, 0, 0, dx, 0, w - dx, h);
+        set_op(&ops[1], LCD_BLIT_OP_BLIT, to, w, w - dx, 0, 0, 0, dx, h);
+        return 2;
+    case LCD_TRANSITION_PUSH_UP:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, from, w, 0, dy, 0, 0, w, h - dy);
+        set_op(&ops[1], LCD_BLIT_OP_BLIT, to, w, 0, 0, 0, h - dy, w, dy);
+        return 2;
+    case LCD_TRANSITION_PUSH_DOWN:
+        set_op(&ops[0], LCD_BLIT_OP_BLIT, from, w, 0, 0, 0, dy, w, h - dy);
+        set_op(&ops[1], LCD_BLIT_OP_BLIT, to, w, 0, h - dy, 0, 0, w, dy);
+        return 2;
+    case LCD_TRANSITION_FADE:
+        // 每帧都从两张画面直接混合，不在帧缓冲上累积，避免 RGB565 舍入误差让渐变停滞
+        set_op(&ops[0], LCD_BLIT_OP_BLEND, to, w, 0, 0, 0, 0, w, h);
+        ops[0].alpha = (uint8_t)((p * 255) >> 16);
+        ops[0].bg = from;
+        return 1;
+    case LCD_TRANSITION_ZOOM: {
+        // PPA 的缩放比例精度为 1/16：目标宽度取整到 w / gcd(w, 16) 的倍数（w 是 16 的倍数时即 w / 16），
+        // dst_w * 16 才能被 w 整除，否则每帧都会退回 CPU；不足一档的帧跳过
+        uint16_t gx = w & -w;   // w 最低位的 1，与 16 取小即 gcd(w, 16)
+        uint16_t gy = h & -h;
+        uint16_t qx = w / (gx < 16 ? gx : 16);
+        uint16_t qy = h / (gy < 16 ? gy : 16);
+        dx -= dx % qx;
+        dy -= dy % qy;
+        if (!dx || !dy) {
+            return 0;
+        }
+        set_op(&ops[0], LCD_BLIT_OP_SCALE, to, w, 0, 0, (w - dx) / 2, (h - dy) / 2, w, h);
+        ops[0].dst_w = dx;
+        ops[0].dst_h = dy;
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+esp_err_t lcd_transition::run(const uint16_t *from, const uint16_t *to, lcd_transition_type_t type,
+                              uint32_t duration_ms, bool corrected)
+{
+    ESP_RETURN_ON_FALSE(_blit, ESP_ERR_INVALID_STATE, TAG, "not started");
+    ESP_RETURN_ON_FALSE(from && to && type < LCD_TRANSITION_MAX, ESP_ERR_INVALID_ARG, TAG, "invalid arguments");
+
+    lcd_blit_op_t ops[2];
+    int64_t duration_us = (int64_t)duration_ms * 1000;
+    uint32_t frames = 0;
+    uint32_t missed = 0;
+    uint32_t last_vsync = 0;
+    uint8_t flags = corrected ? LCD_BLIT_FLAG_CORRECTED : 0;
+
+    // 第一帧先把旧画面完整画上，滑入和缩放都以它为底
+    set_op(&ops[0], LCD_BLIT_OP_BLIT, from, _h_res, 0, 0, 0, 0, _h_res, _v_res);
+    ops[0].flags = flags;
+    ESP_RETURN_ON_ERROR(_blit->run(ops, 1), TAG, "first frame failed");
+
+    int64_t start = esp_timer_get_time();
+    last_vsync = _vsyncs;
+    for (;;) {
+        // 只在刷新完成的那一刻开始画：上一帧画的过程中留下的信号说明新的一次扫描已经开始，先清掉再等下一次
+        xSemaphoreTake(_vsync_sem, 0);
+        if (xSemaphoreTake(_vsync_sem, pdMS_TO_TICKS(LCD_TRANSITION_VSYNC_TIMEOUT_MS)) != pdTRUE) {
+            // 面板没在刷新（例如休眠中），中间帧看不到，直接画最后一帧
+            ESP_LOGW(TAG, "no refresh event, skipping to the last frame");
+            break;
+        }
+        uint32_t vsyncs = _vsyncs;
+        if (frames && vsyncs - last_vsync > 1) {
+            missed += vsyncs - last_vsync - 1;
+        }
+        last_vsync = vsyncs;
+
+        int64_t elapsed = esp_timer_get_time() - start;
+        uint32_t t = (duration_us <= 0 || elapsed >= duration_us) ? LCD_TRANSITION_ONE :
+                     (uint32_t)((elapsed << 16) / duration_us);
+        if (t >= LCD_TRANSITION_ONE) {
+            break;
+        }
+
+        size_t n = build(ops, from, to, type, ease_out(t));
+        for (size_t i = 0; i < n; i++) {
+            ops[i].flags = flags;
+        }
+        ESP_RETURN_ON_ERROR(_blit->run(ops, n), TAG, "frame failed");
+        frames++;
+    }
+
+    // 最后一帧直接拷贝新画面，不受缩放和混合精度影响
+    set_op(&ops[0], LCD_BLIT_OP_BLIT, to, _h_res, 0, 0, 0, 0, _h_res, _v_res);
+    ops[0].flags = flags;
+    esp_err_t ret = _blit->run(ops, 1);
+    frames++;
+
+    if (_stats) {
+        _stats->transition_frames += frames;
+        _stats->transition_missed += missed;
+    }
+    ESP_LOGD(TAG, "transition %d: %lu frames, %lu refreshes missed", type, (unsigned long)frames,
+             (unsigned long)missed);
+    return ret;
+}
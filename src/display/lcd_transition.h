@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "lcd_events.h"
+#include "lcd_blit.h"
+#include "lcd_stats.h"
+
+#define LCD_TRANSITION_VSYNC_TIMEOUT_MS 50 // 面板没有刷新事件时（例如休眠中）跳到最后一帧
+
+/**
+ * @brief Screen transition kinds; "left" etc. is the direction the new screen moves in
+ */
+typedef enum {
+    LCD_TRANSITION_SLIDE_LEFT = 0,  /*!< New screen slides in from the right over the old one */
+    LCD_TRANSITION_SLIDE_RIGHT,     /*!< New screen slides in from the left over the old one */
+    LCD_TRANSITION_SLIDE_UP,        /*!< New screen slides in from the bottom over the old one */
+    LCD_TRANSITION_SLIDE_DOWN,      /*!< New screen slides in from the top over the old one */
+    LCD_TRANSITION_PUSH_LEFT,       /*!< New screen comes in from the right and pushes the old one out */
+    LCD_TRANSITION_PUSH_RIGHT,      /*!< New screen comes in from the left and pushes the old one out */
+    LCD_TRANSITION_PUSH_UP,         /*!< New screen comes in from the bottom and pushes the old one out */
+    LCD_TRANSITION_PUSH_DOWN,       /*!< New screen comes in from the top and pushes the old one out */
+    LCD_TRANSITION_FADE,            /*!< Cross-fade */
+    LCD_TRANSITION_ZOOM,            /*!< New screen grows from the centre over the old one */
+    LCD_TRANSITION_MAX,
+} lcd_transition_type_t;
+
+/**
+ * @brief Plays a transition between two rendered full-screen RGB565 surfaces
+ *
+ * Every frame is at most two lcd_blit operations straight from the surfaces: slides and pushes are
+ * offset copies, the fade is one blend of both surfaces into the frame buffer and the zoom is one
+ * scaled copy, all on the PPA when available. Each frame starts only on a fresh refresh-done event;
+ * one that arrived while the previous frame was still drawing is dropped and the next is awaited.
+ * The progress follows the elapsed time, so a late frame is skipped rather than slowing the
+ * transition down. The widget renderer is not involved. Pass `corrected` when both surfaces were read
+ * back from the screen, so the colour LUT is not applied to them a second time.
+ *
+ * @note The DPI panel scans the single frame buffer these frames are drawn into. Starting on the
+ *       refresh-done event hides tearing only for frames that finish before the scan reaches the
+ *       rows they change. A full-screen fade, push or zoom that takes longer than the vertical
+ *       blanking can still tear on its lower rows. Tear-free transitions need a second DPI frame
+ *       buffer that is swapped on refresh-done, which the panel drivers do not allocate today.
+ */
+class lcd_transition
+{
+public:
+    lcd_transition();
+
+    esp_err_t begin(lcd_blit *blit, lcd_events *events, lcd_stats_t *stats, uint16_t h_res, uint16_t v_res);
+    bool started();
+    esp_err_t run(const uint16_t *from, const uint16_t *to, lcd_transition_type_t type, uint32_t duration_ms,
+                  bool corrected = false);
+
+private:
+    static bool on_refresh_done(void *user_ctx);
+    static uint32_t ease_out(uint32_t t);
+    size_t build(lcd_blit_op_t *ops, const uint16_t *from, const uint16_t *to, lcd_transition_type_t type, uint32_t p);
+
+    lcd_blit *_blit;
+    lcd_stats_t *_stats;
+    uint16_t _h_res;
+    uint16_t _v_res;
+    SemaphoreHandle_t _vsync_sem;
+    volatile uint32_t _vsyncs;
+};
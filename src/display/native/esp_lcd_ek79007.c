@@ -25,12 +25,17 @@
 #define EK79007_CMD_UPDN_BIT    (1ULL << 1)
 #define EK79007_MDCTL_VALUE_DEFAULT   (0x01)
 
+#define EK79007_SLPIN_DELAY_MS  (5)   // Wait after SLPIN before the next command
+#define EK79007_SLPOUT_DELAY_MS (120) // Wait after SLPOUT when leaving sleep-in mode
+
 typedef struct {
     esp_lcd_panel_io_handle_t io;
     int reset_gpio_num;
     uint8_t madctl_val; // save current value of LCD_CMD_MADCTL register
     const ek79007_lcd_init_cmd_t *init_cmds;
     uint16_t init_cmds_size;
+    lcd_boot_timeline_t *boot_timeline;
+    const lcd_boot_delays_t *boot_delays;
     uint8_t lane_num;
     struct {
         unsigned int reset_level: 1;
@@ -49,6 +54,8 @@ static esp_err_t panel_ek79007_init(esp_lcd_panel_t *panel);
 static esp_err_t panel_ek79007_reset(esp_lcd_panel_t *panel);
 static esp_err_t panel_ek79007_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y);
 static esp_err_t panel_ek79007_invert_color(esp_lcd_panel_t *panel, bool invert_color_data);
+static esp_err_t panel_ek79007_disp_on_off(esp_lcd_panel_t *panel, bool on_off);
+static esp_err_t panel_ek79007_sleep(esp_lcd_panel_t *panel, bool sleep);
 
 esp_err_t esp_lcd_new_panel_ek79007(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config,
                                     esp_lcd_panel_handle_t *ret_panel)
@@ -73,14 +80,18 @@ esp_err_t esp_lcd_new_panel_ek79007(const esp_lcd_panel_io_handle_t io, const es
     ek79007->io = io;
     ek79007->init_cmds = vendor_config->init_cmds;
     ek79007->init_cmds_size = vendor_config->init_cmds_size;
+    ek79007->boot_timeline = vendor_config->boot_timeline;
+    ek79007->boot_delays = vendor_config->boot_delays;
     ek79007->lane_num = vendor_config->mipi_config.lane_num;
     ek79007->reset_gpio_num = panel_dev_config->reset_gpio_num;
     ek79007->flags.reset_level = panel_dev_config->flags.reset_active_high;
     ek79007->madctl_val = EK79007_MDCTL_VALUE_DEFAULT;
 
     // Create MIPI DPI panel
-    ESP_GOTO_ON_ERROR(esp_lcd_new_panel_dpi(vendor_config->mipi_config.dsi_bus, vendor_config->mipi_config.dpi_config, ret_panel), err, TAG,
-                      "create MIPI DPI panel failed");
+    lcd_boot_stage_begin(vendor_config->boot_timeline, "new_dpi", -1);
+    ret = esp_lcd_new_panel_dpi(vendor_config->mipi_config.dsi_bus, vendor_config->mipi_config.dpi_config, ret_panel);
+    lcd_boot_stage_end(vendor_config->boot_timeline);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "create MIPI DPI panel failed");
     ESP_LOGD(TAG, "new MIPI DPI panel @%p", *ret_panel);
 
     // Save the original functions of MIPI DPI panel
@@ -92,6 +103,8 @@ esp_err_t esp_lcd_new_panel_ek79007(const esp_lcd_panel_io_handle_t io, const es
     (*ret_panel)->reset = panel_ek79007_reset;
     (*ret_panel)->mirror = panel_ek79007_mirror;
     (*ret_panel)->invert_color = panel_ek79007_invert_color;
+    (*ret_panel)->disp_on_off = panel_ek79007_disp_on_off;
+    (*ret_panel)->disp_sleep = panel_ek79007_sleep;
     (*ret_panel)->user_data = ek79007;
     ESP_LOGD(TAG, "new ek79007 panel @%p", ek79007);
 
@@ -126,6 +139,7 @@ static esp_err_t panel_ek79007_send_init_cmds(ek79007_panel_t *ek79007)
     uint16_t init_cmds_size = 0;
     uint8_t lane_command = EK79007_DSI_2_LANE;
     bool is_cmd_overwritten = false;
+    esp_err_t ret = ESP_OK;
 
     switch (ek79007->lane_num) {
     case 0:
@@ -174,8 +188,13 @@ static esp_err_t panel_ek79007_send_init_cmds(ek79007_panel_t *ek79007)
         }
 
         // Send command
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes), TAG, "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(init_cmds[i].delay_ms));
+        lcd_boot_stage_begin(ek79007->boot_timeline, "init_cmd", init_cmds[i].cmd);
+        ret = esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes);
+        if (ret == ESP_OK) {
+            lcd_boot_sleep_ms(ek79007->boot_timeline, lcd_boot_cmd_delay_ms(ek79007->boot_delays, init_cmds[i].cmd, init_cmds[i].delay_ms));
+        }
+        lcd_boot_stage_end(ek79007->boot_timeline);
+        ESP_RETURN_ON_ERROR(ret, TAG, "send command failed");
     }
 
     ESP_LOGD(TAG, "send init commands success");
@@ -203,7 +222,10 @@ static esp_err_t panel_ek79007_init(esp_lcd_panel_t *panel)
     ek79007_panel_t *ek79007 = (ek79007_panel_t *)panel->user_data;
 
     ESP_RETURN_ON_ERROR(panel_ek79007_send_init_cmds(ek79007), TAG, "send init commands failed");
-    ESP_RETURN_ON_ERROR(ek79007->init(panel), TAG, "init MIPI DPI panel failed");
+    lcd_boot_stage_begin(ek79007->boot_timeline, "dpi_init", -1);
+    esp_err_t ret = ek79007->init(panel);
+    lcd_boot_stage_end(ek79007->boot_timeline);
+    ESP_RETURN_ON_ERROR(ret, TAG, "init MIPI DPI panel failed");
 
     return ESP_OK;
 }
@@ -216,12 +238,12 @@ static esp_err_t panel_ek79007_reset(esp_lcd_panel_t *panel)
     // Perform hardware reset
     if (ek79007->reset_gpio_num >= 0) {
         gpio_set_level(ek79007->reset_gpio_num, ek79007->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(10));
+        lcd_boot_sleep_ms(ek79007->boot_timeline, LCD_BOOT_DELAY(ek79007->boot_delays, reset_assert_ms, 10));
         gpio_set_level(ek79007->reset_gpio_num, !ek79007->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(20));
+        lcd_boot_sleep_ms(ek79007->boot_timeline, LCD_BOOT_DELAY(ek79007->boot_delays, reset_release_ms, 20));
     } else if (io) { // Perform software reset
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, NULL, 0), TAG, "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(20));
+        lcd_boot_sleep_ms(ek79007->boot_timeline, LCD_BOOT_DELAY(ek79007->boot_delays, reset_release_ms, 20));
     }
 
     return ESP_OK;
@@ -272,3 +294,40 @@ static esp_err_t panel_ek79007_invert_color(esp_lcd_panel_t *panel, bool invert_
 
     return ESP_OK;
 }
+
+static esp_err_t panel_ek79007_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
+{
+    ek79007_panel_t *ek79007 = (ek79007_panel_t *)panel->user_data;
+    esp_lcd_panel_io_handle_t io = ek79007->io;
+    uint8_t command = 0;
+
+    ESP_RETURN_ON_FALSE(io, ESP_ERR_INVALID_STATE, TAG, "invalid panel IO");
+
+    if (on_off) {
+        command = LCD_CMD_DISPON;
+    } else {
+        command = LCD_CMD_DISPOFF;
+    }
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, command, NULL, 0), TAG, "send command failed");
+
+    return ESP_OK;
+}
+
+static esp_err_t panel_ek79007_sleep(esp_lcd_panel_t *panel, bool sleep)
+{
+    ek79007_panel_t *ek79007 = (ek79007_panel_t *)panel->user_data;
+    esp_lcd_panel_io_handle_t io = ek79007->io;
+
+    ESP_RETURN_ON_FALSE(io, ESP_ERR_INVALID_STATE, TAG, "invalid panel IO");
+
+    // The DSI link, DPI timing and frame buffer are left running, only the panel's own state changes
+    if (sleep) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPIN, NULL, 0), TAG, "send command failed");
+        lcd_boot_sleep_ms(ek79007->boot_timeline, EK79007_SLPIN_DELAY_MS);
+    } else {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0), TAG, "send command failed");
+        lcd_boot_sleep_ms(ek79007->boot_timeline, LCD_BOOT_DELAY(ek79007->boot_delays, sleep_out_ms, EK79007_SLPOUT_DELAY_MS));
+    }
+
+    return ESP_OK;
+}
@@ -12,6 +12,7 @@
 #if SOC_MIPI_DSI_SUPPORTED
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_mipi_dsi.h"
+#include "lcd_boot.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -45,6 +46,8 @@ typedef struct {
         const esp_lcd_dpi_panel_config_t *dpi_config;   /*!< MIPI-DPI panel configuration */
         uint8_t  lane_num;                              /*!< Number of MIPI-DSI lanes, defaults to 2 if set to 0 */
     } mipi_config;
+    lcd_boot_timeline_t *boot_timeline;             /*!< Records the bring-up stages if not NULL */
+    const lcd_boot_delays_t *boot_delays;           /*!< Fast-boot delay overrides, NULL to keep the default delays */
 } ek79007_vendor_config_t;
 
 /**
@@ -63,6 +66,22 @@ typedef struct {
 esp_err_t esp_lcd_new_panel_ek79007(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config,
                                     esp_lcd_panel_handle_t *ret_panel);
 
+/**
+ * @brief Fast-boot delays from the EK79007 datasheet minimums, with some margin
+ *
+ * @note  EK79007: reset pulse >= 10 us, 5 ms after reset release, 5 ms after SLPOUT before the next command.
+ *
+ */
+#define EK79007_FAST_BOOT_DELAYS()               \
+    {                                            \
+        .reset_idle_ms = LCD_BOOT_DELAY_DEFAULT, \
+        .reset_assert_ms = 1,                    \
+        .reset_release_ms = 5,                   \
+        .sleep_out_ms = 10,                      \
+        .display_on_ms = 0,                      \
+        .cmd_ms = LCD_BOOT_DELAY_DEFAULT,        \
+    }
+
 /**
  * @brief MIPI DSI bus configuration structure
  *
@@ -19,6 +19,9 @@
 #include "driver/gpio.h"
 #include "esp_lcd_gc9503.h"
 
+#define GC9503_SLPIN_DELAY_MS   (5)   // Wait after SLPIN before the next command
+#define GC9503_SLPOUT_DELAY_MS  (120) // Wait after SLPOUT when leaving sleep-in mode
+
 typedef struct {
     esp_lcd_panel_io_handle_t io;
     int reset_gpio_num;
@@ -26,6 +29,8 @@ typedef struct {
     uint8_t colmod_val; // save surrent value of LCD_CMD_COLMOD register
     const gc9503_lcd_init_cmd_t *init_cmds;
     uint16_t init_cmds_size;
+    lcd_boot_timeline_t *boot_timeline;
+    const lcd_boot_delays_t *boot_delays;
     struct {
         unsigned int reset_level: 1;
     } flags;
@@ -42,6 +47,7 @@ static esp_err_t panel_gc9503_reset(esp_lcd_panel_t *panel);
 static esp_err_t panel_gc9503_invert_color(esp_lcd_panel_t *panel, bool invert_color_data);
 static esp_err_t panel_gc9503_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y);
 static esp_err_t panel_gc9503_disp_on_off(esp_lcd_panel_t *panel, bool on_off);
+static esp_err_t panel_gc9503_sleep(esp_lcd_panel_t *panel, bool sleep);
 
 esp_err_t esp_lcd_new_panel_gc9503(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config,
                                    esp_lcd_panel_handle_t *ret_panel)
@@ -91,19 +97,26 @@ esp_err_t esp_lcd_new_panel_gc9503(const esp_lcd_panel_io_handle_t io, const esp
     }
 
     uint8_t ID[3];
-    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_rx_param(io, 0x04, ID, 3), err, TAG, "read ID failed");
+    lcd_boot_stage_begin(vendor_config->boot_timeline, "read_id", -1);
+    ret = esp_lcd_panel_io_rx_param(io, 0x04, ID, 3);
+    lcd_boot_stage_end(vendor_config->boot_timeline);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "read ID failed");
     ESP_LOGI(TAG, "LCD ID: %02X %02X %02X", ID[0], ID[1], ID[2]);
 
     gc9503->io = io;
     gc9503->init_cmds = vendor_config->init_cmds;
     gc9503->init_cmds_size = vendor_config->init_cmds_size;
+    gc9503->boot_timeline = vendor_config->boot_timeline;
+    gc9503->boot_delays = vendor_config->boot_delays;
     gc9503->reset_gpio_num = panel_dev_config->reset_gpio_num;
     gc9503->flags.reset_level = panel_dev_config->flags.reset_active_high;
 
     // Create MIPI DPI panel
     esp_lcd_panel_handle_t panel_handle = NULL;
-    ESP_GOTO_ON_ERROR(esp_lcd_new_panel_dpi(vendor_config->mipi_config.dsi_bus, vendor_config->mipi_config.dpi_config, &panel_handle), err, TAG,
-                      "create MIPI DPI panel failed");
+    lcd_boot_stage_begin(vendor_config->boot_timeline, "new_dpi", -1);
+    ret = esp_lcd_new_panel_dpi(vendor_config->mipi_config.dsi_bus, vendor_config->mipi_config.dpi_config, &panel_handle);
+    lcd_boot_stage_end(vendor_config->boot_timeline);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "create MIPI DPI panel failed");
     ESP_LOGD(TAG, "new MIPI DPI panel @%p", panel_handle);
 
     // Save the original functions of MIPI DPI panel
@@ -116,6 +129,7 @@ esp_err_t esp_lcd_new_panel_gc9503(const esp_lcd_panel_io_handle_t io, const esp
     panel_handle->mirror = panel_gc9503_mirror;
     panel_handle->invert_color = panel_gc9503_invert_color;
     panel_handle->disp_on_off = panel_gc9503_disp_on_off;
+    panel_handle->disp_sleep = panel_gc9503_sleep;
     panel_handle->user_data = gc9503;
     *ret_panel = panel_handle;
     ESP_LOGD(TAG, "new gc9503 panel @%p", gc9503);
@@ -230,6 +244,7 @@ static esp_err_t panel_gc9503_init(esp_lcd_panel_t *panel)
     const gc9503_lcd_init_cmd_t *init_cmds = NULL;
     uint16_t init_cmds_size = 0;
     bool is_cmd_overwritten = false;
+    esp_err_t ret = ESP_OK;
 
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
         gc9503->madctl_val,
@@ -266,12 +281,20 @@ static esp_err_t panel_gc9503_init(esp_lcd_panel_t *panel)
         }
 
         // Send command
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes), TAG, "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(init_cmds[i].delay_ms));
+        lcd_boot_stage_begin(gc9503->boot_timeline, "init_cmd", init_cmds[i].cmd);
+        ret = esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes);
+        if (ret == ESP_OK) {
+            lcd_boot_sleep_ms(gc9503->boot_timeline, lcd_boot_cmd_delay_ms(gc9503->boot_delays, init_cmds[i].cmd, init_cmds[i].delay_ms));
+        }
+        lcd_boot_stage_end(gc9503->boot_timeline);
+        ESP_RETURN_ON_ERROR(ret, TAG, "send command failed");
     }
     ESP_LOGD(TAG, "send init commands success");
 
-    ESP_RETURN_ON_ERROR(gc9503->init(panel), TAG, "init MIPI DPI panel failed");
+    lcd_boot_stage_begin(gc9503->boot_timeline, "dpi_init", -1);
+    ret = gc9503->init(panel);
+    lcd_boot_stage_end(gc9503->boot_timeline);
+    ESP_RETURN_ON_ERROR(ret, TAG, "init MIPI DPI panel failed");
 
     return ESP_OK;
 }
@@ -284,14 +307,14 @@ static esp_err_t panel_gc9503_reset(esp_lcd_panel_t *panel)
     // Perform hardware reset
     if (gc9503->reset_gpio_num >= 0) {
         gpio_set_level(gc9503->reset_gpio_num, !gc9503->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(5));
+        lcd_boot_sleep_ms(gc9503->boot_timeline, LCD_BOOT_DELAY(gc9503->boot_delays, reset_idle_ms, 5));
         gpio_set_level(gc9503->reset_gpio_num, gc9503->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(10));
+        lcd_boot_sleep_ms(gc9503->boot_timeline, LCD_BOOT_DELAY(gc9503->boot_delays, reset_assert_ms, 10));
         gpio_set_level(gc9503->reset_gpio_num, !gc9503->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(120));
+        lcd_boot_sleep_ms(gc9503->boot_timeline, LCD_BOOT_DELAY(gc9503->boot_delays, reset_release_ms, 120));
     } else if (io) { // Perform software reset
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, NULL, 0), TAG, "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(120));
+        lcd_boot_sleep_ms(gc9503->boot_timeline, LCD_BOOT_DELAY(gc9503->boot_delays, reset_release_ms, 120));
     }
 
     return ESP_OK;
@@ -356,4 +379,23 @@ static esp_err_t panel_gc9503_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, command, NULL, 0), TAG, "send command failed");
     return ESP_OK;
 }
+
+static esp_err_t panel_gc9503_sleep(esp_lcd_panel_t *panel, bool sleep)
+{
+    gc9503_panel_t *gc9503 = (gc9503_panel_t *)panel->user_data;
+    esp_lcd_panel_io_handle_t io = gc9503->io;
+
+    ESP_RETURN_ON_FALSE(io, ESP_ERR_INVALID_STATE, TAG, "invalid panel IO");
+
+    // The DSI link, DPI timing and frame buffer are left running, only the panel's own state changes
+    if (sleep) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPIN, NULL, 0), TAG, "send command failed");
+        lcd_boot_sleep_ms(gc9503->boot_timeline, GC9503_SLPIN_DELAY_MS);
+    } else {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0), TAG, "send command failed");
+        lcd_boot_sleep_ms(gc9503->boot_timeline, LCD_BOOT_DELAY(gc9503->boot_delays, sleep_out_ms, GC9503_SLPOUT_DELAY_MS));
+    }
+
+    return ESP_OK;
+}
 #endif
@@ -19,6 +19,9 @@
 #include "driver/gpio.h"
 #include "esp_lcd_st7703.h"
 
+#define ST7703_SLPIN_DELAY_MS   (5)   // Wait after SLPIN before the next command
+#define ST7703_SLPOUT_DELAY_MS  (120) // Wait after SLPOUT when leaving sleep-in mode
+
 typedef struct {
     esp_lcd_panel_io_handle_t io;
     int reset_gpio_num;
@@ -26,6 +29,8 @@ typedef struct {
     uint8_t colmod_val; // save surrent value of LCD_CMD_COLMOD register
     const st7703_lcd_init_cmd_t *init_cmds;
     uint16_t init_cmds_size;
+    lcd_boot_timeline_t *boot_timeline;
+    const lcd_boot_delays_t *boot_delays;
     uint8_t lane_num;
     struct {
         unsigned int reset_level: 1;
@@ -43,6 +48,7 @@ static esp_err_t panel_st7703_reset(esp_lcd_panel_t *panel);
 static esp_err_t panel_st7703_invert_color(esp_lcd_panel_t *panel, bool invert_color_data);
 static esp_err_t panel_st7703_mirror(esp_lcd_panel_t *panel, bool mirror_x, bool mirror_y);
 static esp_err_t panel_st7703_disp_on_off(esp_lcd_panel_t *panel, bool on_off);
+static esp_err_t panel_st7703_sleep(esp_lcd_panel_t *panel, bool sleep);
 
 esp_err_t esp_lcd_new_panel_st7703(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *panel_dev_config,
                                    esp_lcd_panel_handle_t *ret_panel)
@@ -92,20 +98,27 @@ esp_err_t esp_lcd_new_panel_st7703(const esp_lcd_panel_io_handle_t io, const esp
     }
 
     uint8_t ID[3];
-    ESP_GOTO_ON_ERROR(esp_lcd_panel_io_rx_param(io, 0x04, ID, 3), err, TAG, "read ID failed");
+    lcd_boot_stage_begin(vendor_config->boot_timeline, "read_id", -1);
+    ret = esp_lcd_panel_io_rx_param(io, 0x04, ID, 3);
+    lcd_boot_stage_end(vendor_config->boot_timeline);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "read ID failed");
     ESP_LOGI(TAG, "LCD ID: %02X %02X %02X", ID[0], ID[1], ID[2]);
 
     st7703->io = io;
     st7703->init_cmds = vendor_config->init_cmds;
     st7703->init_cmds_size = vendor_config->init_cmds_size;
+    st7703->boot_timeline = vendor_config->boot_timeline;
+    st7703->boot_delays = vendor_config->boot_delays;
     st7703->lane_num = vendor_config->mipi_config.lane_num;
     st7703->reset_gpio_num = panel_dev_config->reset_gpio_num;
     st7703->flags.reset_level = panel_dev_config->flags.reset_active_high;
 
     // Create MIPI DPI panel
     esp_lcd_panel_handle_t panel_handle = NULL;
-    ESP_GOTO_ON_ERROR(esp_lcd_new_panel_dpi(vendor_config->mipi_config.dsi_bus, vendor_config->mipi_config.dpi_config, &panel_handle), err, TAG,
-                      "create MIPI DPI panel failed");
+    lcd_boot_stage_begin(vendor_config->boot_timeline, "new_dpi", -1);
+    ret = esp_lcd_new_panel_dpi(vendor_config->mipi_config.dsi_bus, vendor_config->mipi_config.dpi_config, &panel_handle);
+    lcd_boot_stage_end(vendor_config->boot_timeline);
+    ESP_GOTO_ON_ERROR(ret, err, TAG, "create MIPI DPI panel failed");
     ESP_LOGD(TAG, "new MIPI DPI panel @%p", panel_handle);
 
     // Save the original functions of MIPI DPI panel
@@ -118,6 +131,7 @@ esp_err_t esp_lcd_new_panel_st7703(const esp_lcd_panel_io_handle_t io, const esp
     panel_handle->mirror = panel_st7703_mirror;
     panel_handle->invert_color = panel_st7703_invert_color;
     panel_handle->disp_on_off = panel_st7703_disp_on_off;
+    panel_handle->disp_sleep = panel_st7703_sleep;
     panel_handle->user_data = st7703;
     *ret_panel = panel_handle;
     ESP_LOGD(TAG, "new st7703 panel @%p", st7703);
@@ -204,7 +218,10 @@ static esp_err_t panel_st7703_init(esp_lcd_panel_t *panel)
     uint16_t init_cmds_size = 0;
     bool is_cmd_overwritten = false;
 
-    ESP_RETURN_ON_ERROR(st7703->init(panel), TAG, "init MIPI DPI panel failed");
+    lcd_boot_stage_begin(st7703->boot_timeline, "dpi_init", -1);
+    esp_err_t ret = st7703->init(panel);
+    lcd_boot_stage_end(st7703->boot_timeline);
+    ESP_RETURN_ON_ERROR(ret, TAG, "init MIPI DPI panel failed");
 
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_MADCTL, (uint8_t[]) {
         st7703->madctl_val,
@@ -248,8 +265,13 @@ static esp_err_t panel_st7703_init(esp_lcd_panel_t *panel)
         }
 
         // Send command
-        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes), TAG, "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(init_cmds[i].delay_ms));
+        lcd_boot_stage_begin(st7703->boot_timeline, "init_cmd", init_cmds[i].cmd);
+        ret = esp_lcd_panel_io_tx_param(io, init_cmds[i].cmd, init_cmds[i].data, init_cmds[i].data_bytes);
+        if (ret == ESP_OK) {
+            lcd_boot_sleep_ms(st7703->boot_timeline, lcd_boot_cmd_delay_ms(st7703->boot_delays, init_cmds[i].cmd, init_cmds[i].delay_ms));
+        }
+        lcd_boot_stage_end(st7703->boot_timeline);
+        ESP_RETURN_ON_ERROR(ret, TAG, "send command failed");
     }
     ESP_LOGD(TAG, "send init commands success");
 
@@ -264,14 +286,14 @@ static esp_err_t panel_st7703_reset(esp_lcd_panel_t *panel)
     // Perform hardware reset
     if (st7703->reset_gpio_num >= 0) {
         gpio_set_level(st7703->reset_gpio_num, !st7703->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(5));
+        lcd_boot_sleep_ms(st7703->boot_timeline, LCD_BOOT_DELAY(st7703->boot_delays, reset_idle_ms, 5));
         gpio_set_level(st7703->reset_gpio_num, st7703->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(10));
+        lcd_boot_sleep_ms(st7703->boot_timeline, LCD_BOOT_DELAY(st7703->boot_delays, reset_assert_ms, 10));
         gpio_set_level(st7703->reset_gpio_num, !st7703->flags.reset_level);
-        vTaskDelay(pdMS_TO_TICKS(120));
+        lcd_boot_sleep_ms(st7703->boot_timeline, LCD_BOOT_DELAY(st7703->boot_delays, reset_release_ms, 120));
     } else if (io) { // Perform software reset
         ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SWRESET, NULL, 0), TAG, "send command failed");
-        vTaskDelay(pdMS_TO_TICKS(120));
+        lcd_boot_sleep_ms(st7703->boot_timeline, LCD_BOOT_DELAY(st7703->boot_delays, reset_release_ms, 120));
     }
 
     return ESP_OK;
@@ -336,4 +358,23 @@ static esp_err_t panel_st7703_disp_on_off(esp_lcd_panel_t *panel, bool on_off)
     ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, command, NULL, 0), TAG, "send command failed");
     return ESP_OK;
 }
+
+static esp_err_t panel_st7703_sleep(esp_lcd_panel_t *panel, bool sleep)
+{
+    st7703_panel_t *st7703 = (st7703_panel_t *)panel->user_data;
+    esp_lcd_panel_io_handle_t io = st7703->io;
+
+    ESP_RETURN_ON_FALSE(io, ESP_ERR_INVALID_STATE, TAG, "invalid panel IO");
+
+    // The DSI link, DPI timing and frame buffer are left running, only the panel's own state changes
+    if (sleep) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPIN, NULL, 0), TAG, "send command failed");
+        lcd_boot_sleep_ms(st7703->boot_timeline, ST7703_SLPIN_DELAY_MS);
+    } else {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_io_tx_param(io, LCD_CMD_SLPOUT, NULL, 0), TAG, "send command failed");
+        lcd_boot_sleep_ms(st7703->boot_timeline, LCD_BOOT_DELAY(st7703->boot_delays, sleep_out_ms, ST7703_SLPOUT_DELAY_MS));
+    }
+
+    return ESP_OK;
+}
 #endif
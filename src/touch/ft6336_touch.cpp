@@ -12,18 +12,19 @@
 
 static const char *TAG = "example";
 
-esp_lcd_touch_handle_t tp;
-esp_lcd_panel_io_handle_t tp_io_handle;
-
-uint16_t touch_strength[1];
-uint8_t touch_cnt = 0;
-
-ft6336_touch::ft6336_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int8_t int_pin)
+ft6336_touch::ft6336_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int8_t int_pin, i2c_port_t i2c_port)
 {
     _sda = sda_pin;
     _scl = scl_pin;
     _rst = rst_pin;
     _int = int_pin;
+    _i2c_port = i2c_port;
+    _tp = NULL;
+    _tp_io_handle = NULL;
+    _touch_strength[0] = 0;
+    _touch_cnt = 0;
+    _suspended = false;
+    _executor = NULL;
 }
 
 void ft6336_touch::begin()
@@ -37,12 +38,12 @@ void ft6336_touch::begin()
     };
     i2c_conf.master.clk_speed = 400000; // 400kHz
 
-    ESP_ERROR_CHECK(i2c_param_config(I2C_NUM_0, &i2c_conf));
-    ESP_ERROR_CHECK(i2c_driver_install(I2C_NUM_0, i2c_conf.mode, 0, 0, 0));
+    ESP_ERROR_CHECK(i2c_param_config(_i2c_port, &i2c_conf));
+    ESP_ERROR_CHECK(i2c_driver_install(_i2c_port, i2c_conf.mode, 0, 0, 0));
 
     esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_FT5x06_CONFIG();
     ESP_LOGI(TAG, "Initialize touch IO (I2C)");
-    esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_NUM_0, &tp_io_config, &tp_io_handle);
+    esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)_i2c_port, &tp_io_config, &_tp_io_handle);
 
     esp_lcd_touch_config_t tp_cfg = {
         .x_max = CONFIG_LCD_HRES,
@@ -61,13 +62,13 @@ void ft6336_touch::begin()
     };
 
     ESP_LOGI(TAG, "Initialize touch controller ft6336");
-    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_ft5x06(tp_io_handle, &tp_cfg, &tp));
+    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_ft5x06(_tp_io_handle, &tp_cfg, &_tp));
 }
 
 bool ft6336_touch::getTouch(uint16_t *x, uint16_t *y)
 {
-    esp_lcd_touch_read_data(tp);
-    bool touchpad_pressed = esp_lcd_touch_get_coordinates(tp, x, y, touch_strength, &touch_cnt, 1);
+    esp_lcd_touch_read_data(_tp);
+    bool touchpad_pressed = esp_lcd_touch_get_coordinates(_tp, x, y, _touch_strength, &_touch_cnt, 1);
 
     return touchpad_pressed;
 }
@@ -75,25 +76,107 @@ bool ft6336_touch::getTouch(uint16_t *x, uint16_t *y)
 void ft6336_touch::set_rotation(uint8_t r){
 switch(r){
     case 0:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, false);
-        esp_lcd_touch_set_mirror_y(tp, false);
+        esp_lcd_touch_set_swap_xy(_tp, false);   
+        esp_lcd_touch_set_mirror_x(_tp, false);
+        esp_lcd_touch_set_mirror_y(_tp, false);
         break;
     case 1:
-        esp_lcd_touch_set_swap_xy(tp, false);
-        esp_lcd_touch_set_mirror_x(tp, true);
-        esp_lcd_touch_set_mirror_y(tp, true);
+        esp_lcd_touch_set_swap_xy(_tp, false);
+        esp_lcd_touch_set_mirror_x(_tp, true);
+        esp_lcd_touch_set_mirror_y(_tp, true);
         break;
     case 2:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, false);
-        esp_lcd_touch_set_mirror_y(tp, false);
+        esp_lcd_touch_set_swap_xy(_tp, false);   
+        esp_lcd_touch_set_mirror_x(_tp, false);
+        esp_lcd_touch_set_mirror_y(_tp, false);
         break;
     case 3:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, true);
-        esp_lcd_touch_set_mirror_y(tp, true);
+        esp_lcd_touch_set_swap_xy(_tp, false);   
+        esp_lcd_touch_set_mirror_x(_tp, true);
+        esp_lcd_touch_set_mirror_y(_tp, true);
         break;
     }
 
-}
\ No newline at end of file
+}
+
+esp_lcd_touch_handle_t ft6336_touch::get_touch_handle()
+{
+    return _tp;
+}
+
+bool ft6336_touch::set_executor(lcd_executor *executor)
+{
+    if (!_tp || !executor) {
+        return false;
+    }
+    _executor = executor;
+    // 没接 INT 脚就没有中断可等，next_event() 直接返回 ESP_ERR_NOT_SUPPORTED
+    if (_int < 0) {
+        return false;
+    }
+    esp_err_t ret = esp_lcd_touch_register_interrupt_callback_with_data(_tp, on_interrupt, this);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "register touch interrupt failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
+lcd_touch_op ft6336_touch::next_event()
+{
+    return lcd_touch_op(_executor, event_start, read_event, this);
+}
+
+esp_err_t ft6336_touch::event_start(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx)
+{
+    ft6336_touch *self = (ft6336_touch *)ctx;
+    if (self->_int < 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return self->_waiters.add(done_cb, done_ctx);
+}
+
+bool ft6336_touch::read_event(void *ctx, uint16_t *x, uint16_t *y)
+{
+    // 在执行器任务里读 I2C，中断里只负责唤醒
+    return ((ft6336_touch *)ctx)->getTouch(x, y);
+}
+
+void ft6336_touch::on_interrupt(esp_lcd_touch_handle_t tp)
+{
+    ft6336_touch *self = (ft6336_touch *)tp->config.user_data;
+    if (self->_waiters.complete_from_isr()) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+bool ft6336_touch::suspend()
+{
+    if (!_tp || _suspended) {
+        return _tp != NULL;
+    }
+
+    // 控制器不支持休眠时保持原状，由其自身的低功耗模式接管
+    esp_err_t ret = esp_lcd_touch_enter_sleep(_tp);
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGE(TAG, "touch enter sleep failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    _suspended = (ret == ESP_OK);
+    return true;
+}
+
+bool ft6336_touch::resume()
+{
+    if (!_suspended) {
+        return _tp != NULL;
+    }
+
+    esp_err_t ret = esp_lcd_touch_exit_sleep(_tp);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "touch exit sleep failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    _suspended = false;
+    return true;
+}
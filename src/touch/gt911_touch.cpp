@@ -1,3 +1,4 @@
+#include <string.h>
 #include "sdkconfig.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -12,22 +13,29 @@
 
 static const char *TAG = "example";
 
-esp_lcd_touch_handle_t tp;
-esp_lcd_panel_io_handle_t tp_io_handle;
-
-uint16_t touch_strength[1];
-uint8_t touch_cnt = 0;
-
-gt911_touch::gt911_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int8_t int_pin)
+gt911_touch::gt911_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin, int8_t int_pin, i2c_port_t i2c_port)
 {
     _sda = sda_pin;
     _scl = scl_pin;
     _rst = rst_pin;
     _int = int_pin;
+    _i2c_port = i2c_port;
+    _tp = NULL;
+    _tp_io_handle = NULL;
+    _touch_strength[0] = 0;
+    _touch_cnt = 0;
+    _suspended = false;
+    _executor = NULL;
+    memset(&_boot, 0, sizeof(_boot));
+    _boot_delays = LCD_BOOT_DELAYS_DEFAULT();
+    _gt911_config.boot_timeline = &_boot;
+    _gt911_config.boot_delays = &_boot_delays;
 }
 
 void gt911_touch::begin()
 {
+    lcd_boot_timeline_reset(&_boot);
+    lcd_boot_stage_begin(&_boot, "touch_begin", -1);
     i2c_config_t i2c_conf = {
         .mode = I2C_MODE_MASTER,
         .sda_io_num = (gpio_num_t)_sda,
@@ -37,12 +45,16 @@ void gt911_touch::begin()
     };
     i2c_conf.master.clk_speed = 400000; // 400kHz
 
-    ESP_ERROR_CHECK(i2c_param_config(I2C_NUM_0, &i2c_conf));
-    ESP_ERROR_CHECK(i2c_driver_install(I2C_NUM_0, i2c_conf.mode, 0, 0, 0));
+    lcd_boot_stage_begin(&_boot, "i2c_install", -1);
+    ESP_ERROR_CHECK(i2c_param_config(_i2c_port, &i2c_conf));
+    ESP_ERROR_CHECK(i2c_driver_install(_i2c_port, i2c_conf.mode, 0, 0, 0));
+    lcd_boot_stage_end(&_boot);
 
     esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG();
     ESP_LOGI(TAG, "Initialize touch IO (I2C)");
-    esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_NUM_0, &tp_io_config, &tp_io_handle);
+    lcd_boot_stage_begin(&_boot, "touch_io", -1);
+    esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)_i2c_port, &tp_io_config, &_tp_io_handle);
+    lcd_boot_stage_end(&_boot);
 
     esp_lcd_touch_config_t tp_cfg = {
         .x_max = CONFIG_LCD_HRES,
@@ -58,16 +70,20 @@ void gt911_touch::begin()
             .mirror_x = 0,
             .mirror_y = 0,
         },
+        .driver_data = &_gt911_config,
     };
 
     ESP_LOGI(TAG, "Initialize touch controller gt911");
-    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp));
+    lcd_boot_stage_begin(&_boot, "new_gt911", -1);
+    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(_tp_io_handle, &tp_cfg, &_tp));
+    lcd_boot_stage_end(&_boot);
+    lcd_boot_stage_end(&_boot);
 }
 
 bool gt911_touch::getTouch(uint16_t *x, uint16_t *y)
 {
-    esp_lcd_touch_read_data(tp);
-    bool touchpad_pressed = esp_lcd_touch_get_coordinates(tp, x, y, touch_strength, &touch_cnt, 1);
+    esp_lcd_touch_read_data(_tp);
+    bool touchpad_pressed = esp_lcd_touch_get_coordinates(_tp, x, y, _touch_strength, &_touch_cnt, 1);
 
     return touchpad_pressed;
 }
@@ -75,25 +91,125 @@ bool gt911_touch::getTouch(uint16_t *x, uint16_t *y)
 void gt911_touch::set_rotation(uint8_t r){
 switch(r){
     case 0:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, false);
-        esp_lcd_touch_set_mirror_y(tp, false);
+        esp_lcd_touch_set_swap_xy(_tp, false);   
+        esp_lcd_touch_set_mirror_x(_tp, false);
+        esp_lcd_touch_set_mirror_y(_tp, false);
         break;
     case 1:
-        esp_lcd_touch_set_swap_xy(tp, false);
-        esp_lcd_touch_set_mirror_x(tp, true);
-        esp_lcd_touch_set_mirror_y(tp, true);
+        esp_lcd_touch_set_swap_xy(_tp, false);
+        esp_lcd_touch_set_mirror_x(_tp, true);
+        esp_lcd_touch_set_mirror_y(_tp, true);
         break;
     case 2:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, false);
-        esp_lcd_touch_set_mirror_y(tp, false);
+        esp_lcd_touch_set_swap_xy(_tp, false);   
+        esp_lcd_touch_set_mirror_x(_tp, false);
+        esp_lcd_touch_set_mirror_y(_tp, false);
         break;
     case 3:
-        esp_lcd_touch_set_swap_xy(tp, false);   
-        esp_lcd_touch_set_mirror_x(tp, true);
-        esp_lcd_touch_set_mirror_y(tp, true);
+        esp_lcd_touch_set_swap_xy(_tp, false);   
+        esp_lcd_touch_set_mirror_x(_tp, true);
+        esp_lcd_touch_set_mirror_y(_tp, true);
         break;
     }
 
-}
\ No newline at end of file
+}
+
+esp_lcd_touch_handle_t gt911_touch::get_touch_handle()
+{
+    return _tp;
+}
+
+bool gt911_touch::set_executor(lcd_executor *executor)
+{
+    if (!_tp || !executor) {
+        return false;
+    }
+    _executor = executor;
+    // 没接 INT 脚就没有中断可等，next_event() 直接返回 ESP_ERR_NOT_SUPPORTED
+    if (_int < 0) {
+        return false;
+    }
+    esp_err_t ret = esp_lcd_touch_register_interrupt_callback_with_data(_tp, on_interrupt, this);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "register touch interrupt failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    return true;
+}
+
+lcd_touch_op gt911_touch::next_event()
+{
+    return lcd_touch_op(_executor, event_start, read_event, this);
+}
+
+esp_err_t gt911_touch::event_start(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx)
+{
+    gt911_touch *self = (gt911_touch *)ctx;
+    if (self->_int < 0) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    return self->_waiters.add(done_cb, done_ctx);
+}
+
+bool gt911_touch::read_event(void *ctx, uint16_t *x, uint16_t *y)
+{
+    // 在执行器任务里读 I2C，中断里只负责唤醒
+    return ((gt911_touch *)ctx)->getTouch(x, y);
+}
+
+void gt911_touch::on_interrupt(esp_lcd_touch_handle_t tp)
+{
+    gt911_touch *self = (gt911_touch *)tp->config.user_data;
+    if (self->_waiters.complete_from_isr()) {
+        portYIELD_FROM_ISR();
+    }
+}
+
+bool gt911_touch::suspend()
+{
+    if (!_tp || _suspended) {
+        return _tp != NULL;
+    }
+
+    // 控制器不支持休眠时保持原状，由其自身的低功耗模式接管
+    esp_err_t ret = esp_lcd_touch_enter_sleep(_tp);
+    if (ret != ESP_OK && ret != ESP_ERR_NOT_SUPPORTED) {
+        ESP_LOGE(TAG, "touch enter sleep failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    _suspended = (ret == ESP_OK);
+    return true;
+}
+
+bool gt911_touch::resume()
+{
+    if (!_suspended) {
+        return _tp != NULL;
+    }
+
+    lcd_boot_timeline_reset(&_boot);
+    lcd_boot_stage_begin(&_boot, "touch_resume", -1);
+    esp_err_t ret = esp_lcd_touch_exit_sleep(_tp);
+    lcd_boot_stage_end(&_boot);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "touch exit sleep failed: %s", esp_err_to_name(ret));
+        return false;
+    }
+    _suspended = false;
+    return true;
+}
+
+void gt911_touch::set_fast_boot(const lcd_boot_delays_t *delays)
+{
+    // 需在 begin() 之前调用；传 NULL 恢复驱动默认延时
+    if (delays) {
+        _boot_delays = *delays;
+    } else {
+        _boot_delays = LCD_BOOT_DELAYS_DEFAULT();
+    }
+}
+
+const lcd_boot_timeline_t *gt911_touch::boot_timeline()
+{
+    return &_boot;
+}
@@ -1,18 +1,47 @@
 #ifndef _GT911_TOUCH_H
 #define _GT911_TOUCH_H
 #include <stdio.h>
+#include "driver/i2c.h"
+#include "native/esp_lcd_touch.h"
+#include "native/esp_lcd_touch_gt911.h"
+#include "lcd_async.h"
 
 class gt911_touch
 {
 public:
-    gt911_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin = -1, int8_t int_pin = -1);
+    gt911_touch(int8_t sda_pin, int8_t scl_pin, int8_t rst_pin = -1, int8_t int_pin = -1, i2c_port_t i2c_port = I2C_NUM_0);
 
     void begin();
     bool getTouch(uint16_t *x, uint16_t *y);
     void set_rotation(uint8_t r);
+    esp_lcd_touch_handle_t get_touch_handle();
+
+    bool suspend();
+    bool resume();
+
+    bool set_executor(lcd_executor *executor);
+    lcd_touch_op next_event();
+
+    void set_fast_boot(const lcd_boot_delays_t *delays);
+    const lcd_boot_timeline_t *boot_timeline();
 
 private:
+    static esp_err_t event_start(void *ctx, lcd_async_done_cb_t done_cb, void *done_ctx);
+    static bool read_event(void *ctx, uint16_t *x, uint16_t *y);
+    static void on_interrupt(esp_lcd_touch_handle_t tp);
+
     int8_t _sda, _scl, _rst, _int;
+    i2c_port_t _i2c_port;
+    esp_lcd_touch_handle_t _tp;
+    esp_lcd_panel_io_handle_t _tp_io_handle;
+    uint16_t _touch_strength[1];
+    uint8_t _touch_cnt;
+    bool _suspended;
+    lcd_executor *_executor;
+    lcd_async_waiters _waiters;
+    lcd_boot_timeline_t _boot;
+    lcd_boot_delays_t _boot_delays;
+    esp_lcd_touch_gt911_config_t _gt911_config;
 };
 
 #endif
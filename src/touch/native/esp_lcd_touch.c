@@ -13,12 +13,16 @@
 #include "esp_check.h"
 #include "esp_log.h"
 #include "esp_lcd_touch.h"
+#include "lcd_trace.h"
 
 static const char *TAG = "TP";
 
 /*******************************************************************************
 * Function definitions
 *******************************************************************************/
+#if LCD_TRACE_ENABLE
+static void esp_lcd_touch_trace_isr(void *arg);
+#endif
 
 /*******************************************************************************
 * Local variables
@@ -55,7 +59,10 @@ esp_err_t esp_lcd_touch_read_data(esp_lcd_touch_handle_t tp)
     assert(tp != NULL);
     assert(tp->read_data != NULL);
 
-    return tp->read_data(tp);
+    LCD_TRACE_BEGIN("touch.read_data");
+    esp_err_t ret = tp->read_data(tp);
+    LCD_TRACE_END("touch.read_data");
+    return ret;
 }
 
 bool esp_lcd_touch_get_coordinates(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength, uint8_t *point_num, uint8_t max_point_num)
@@ -244,7 +251,12 @@ esp_err_t esp_lcd_touch_register_interrupt_callback(esp_lcd_touch_handle_t tp, e
         /* Add GPIO ISR handler */
         ret = gpio_intr_enable(tp->config.int_gpio_num);
         ESP_RETURN_ON_ERROR(ret, TAG, "GPIO ISR install failed");
+#if LCD_TRACE_ENABLE
+        /* Record the interrupt before handing it to the user callback */
+        ret = gpio_isr_handler_add(tp->config.int_gpio_num, esp_lcd_touch_trace_isr, tp);
+#else
         ret = gpio_isr_handler_add(tp->config.int_gpio_num, (gpio_isr_t)tp->config.interrupt_callback, tp);
+#endif
         ESP_RETURN_ON_ERROR(ret, TAG, "GPIO ISR install failed");
     } else {
         /* Remove GPIO ISR handler */
@@ -264,3 +276,18 @@ esp_err_t esp_lcd_touch_register_interrupt_callback_with_data(esp_lcd_touch_hand
     tp->config.user_data = user_data;
     return esp_lcd_touch_register_interrupt_callback(tp, callback);
 }
+
+/*******************************************************************************
+* Private API function
+*******************************************************************************/
+#if LCD_TRACE_ENABLE
+static void IRAM_ATTR esp_lcd_touch_trace_isr(void *arg)
+{
+    esp_lcd_touch_handle_t tp = (esp_lcd_touch_handle_t)arg;
+
+    LCD_TRACE_INSTANT("touch.interrupt", tp->config.int_gpio_num);
+    if (tp->config.interrupt_callback) {
+        tp->config.interrupt_callback(tp);
+    }
+}
+#endif
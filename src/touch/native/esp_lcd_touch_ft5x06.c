@@ -74,12 +74,17 @@ static const char *TAG = "FT5x06";
 #define FT5x06_ID_G_FT5201ID            (0xA8)
 #define FT5x06_ID_G_ERR                 (0xA9)
 
+/* Power modes (ID_G_PMODE) */
+#define FT5x06_PMODE_HIBERNATE          (0x03)
+
 /*******************************************************************************
 * Function definitions
 *******************************************************************************/
 static esp_err_t esp_lcd_touch_ft5x06_read_data(esp_lcd_touch_handle_t tp);
 static bool esp_lcd_touch_ft5x06_get_xy(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength, uint8_t *point_num, uint8_t max_point_num);
 static esp_err_t esp_lcd_touch_ft5x06_del(esp_lcd_touch_handle_t tp);
+static esp_err_t esp_lcd_touch_ft5x06_enter_sleep(esp_lcd_touch_handle_t tp);
+static esp_err_t esp_lcd_touch_ft5x06_exit_sleep(esp_lcd_touch_handle_t tp);
 
 /* I2C read */
 static esp_err_t touch_ft5x06_i2c_write(esp_lcd_touch_handle_t tp, uint8_t reg, uint8_t data);
@@ -112,6 +117,8 @@ esp_err_t esp_lcd_touch_new_i2c_ft5x06(const esp_lcd_panel_io_handle_t io, const
     esp_lcd_touch_ft5x06->read_data = esp_lcd_touch_ft5x06_read_data;
     esp_lcd_touch_ft5x06->get_xy = esp_lcd_touch_ft5x06_get_xy;
     esp_lcd_touch_ft5x06->del = esp_lcd_touch_ft5x06_del;
+    esp_lcd_touch_ft5x06->enter_sleep = esp_lcd_touch_ft5x06_enter_sleep;
+    esp_lcd_touch_ft5x06->exit_sleep = esp_lcd_touch_ft5x06_exit_sleep;
 
     /* Mutex */
     esp_lcd_touch_ft5x06->data.lock.owner = portMUX_FREE_VAL;
@@ -256,6 +263,42 @@ static esp_err_t esp_lcd_touch_ft5x06_del(esp_lcd_touch_handle_t tp)
     return ESP_OK;
 }
 
+static esp_err_t esp_lcd_touch_ft5x06_enter_sleep(esp_lcd_touch_handle_t tp)
+{
+    assert(tp != NULL);
+
+    /* Hibernate is only left through a reset; without the RST line the controller stays in its own monitor mode */
+    if (tp->config.rst_gpio_num == GPIO_NUM_NC) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    if (tp->config.int_gpio_num != GPIO_NUM_NC && tp->config.interrupt_callback) {
+        gpio_intr_disable(tp->config.int_gpio_num);
+    }
+    ESP_RETURN_ON_ERROR(touch_ft5x06_i2c_write(tp, FT5x06_ID_G_PMODE, FT5x06_PMODE_HIBERNATE), TAG, "FT5x06 write error!");
+
+    return ESP_OK;
+}
+
+static esp_err_t esp_lcd_touch_ft5x06_exit_sleep(esp_lcd_touch_handle_t tp)
+{
+    assert(tp != NULL);
+
+    if (tp->config.rst_gpio_num == GPIO_NUM_NC) {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    /* The reset clears the thresholds, write them again */
+    ESP_RETURN_ON_ERROR(touch_ft5x06_reset(tp), TAG, "FT5x06 reset failed");
+    ESP_RETURN_ON_ERROR(touch_ft5x06_init(tp), TAG, "FT5x06 init failed");
+
+    if (tp->config.int_gpio_num != GPIO_NUM_NC && tp->config.interrupt_callback) {
+        gpio_intr_enable(tp->config.int_gpio_num);
+    }
+
+    return ESP_OK;
+}
+
 /*******************************************************************************
 * Private API function
 *******************************************************************************/
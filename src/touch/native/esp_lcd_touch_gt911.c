@@ -16,6 +16,7 @@
 #include "driver/i2c.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_touch.h"
+#include "esp_lcd_touch_gt911.h"
 
 static const char *TAG = "GT911";
 
@@ -23,6 +24,13 @@ static const char *TAG = "GT911";
 #define ESP_LCD_TOUCH_GT911_READ_XY_REG (0x814E)
 #define ESP_LCD_TOUCH_GT911_CONFIG_REG  (0x8047)
 #define ESP_LCD_TOUCH_GT911_PRODUCT_ID_REG (0x8140)
+#define ESP_LCD_TOUCH_GT911_COMMAND_REG (0x8040)
+
+/* GT911 commands */
+#define ESP_LCD_TOUCH_GT911_CMD_SLEEP   (0x05)
+
+/* High pulse on INT that wakes the controller up, 2~5 ms */
+#define ESP_LCD_TOUCH_GT911_WAKE_PULSE_MS (5)
 
 /*******************************************************************************
 * Function definitions
@@ -30,6 +38,8 @@ static const char *TAG = "GT911";
 static esp_err_t esp_lcd_touch_gt911_read_data(esp_lcd_touch_handle_t tp);
 static bool esp_lcd_touch_gt911_get_xy(esp_lcd_touch_handle_t tp, uint16_t *x, uint16_t *y, uint16_t *strength, uint8_t *point_num, uint8_t max_point_num);
 static esp_err_t esp_lcd_touch_gt911_del(esp_lcd_touch_handle_t tp);
+static esp_err_t esp_lcd_touch_gt911_enter_sleep(esp_lcd_touch_handle_t tp);
+static esp_err_t esp_lcd_touch_gt911_exit_sleep(esp_lcd_touch_handle_t tp);
 
 /* I2C read/write */
 static esp_err_t touch_gt911_i2c_read(esp_lcd_touch_handle_t tp, uint16_t reg, uint8_t *data, uint8_t len);
@@ -52,6 +62,9 @@ esp_err_t esp_lcd_touch_new_i2c_gt911(const esp_lcd_panel_io_handle_t io, const
     assert(config != NULL);
     assert(out_touch != NULL);
 
+    const esp_lcd_touch_gt911_config_t *gt911_config = (const esp_lcd_touch_gt911_config_t *)config->driver_data;
+    lcd_boot_timeline_t *boot_timeline = gt911_config ? gt911_config->boot_timeline : NULL;
+
     /* Prepare main structure */
     esp_lcd_touch_handle_t esp_lcd_touch_gt911 = heap_caps_calloc(1, sizeof(esp_lcd_touch_t), MALLOC_CAP_DEFAULT);
     ESP_GOTO_ON_FALSE(esp_lcd_touch_gt911, ESP_ERR_NO_MEM, err, TAG, "no mem for GT911 controller");
@@ -63,6 +76,8 @@ esp_err_t esp_lcd_touch_new_i2c_gt911(const esp_lcd_panel_io_handle_t io, const
     esp_lcd_touch_gt911->read_data = esp_lcd_touch_gt911_read_data;
     esp_lcd_touch_gt911->get_xy = esp_lcd_touch_gt911_get_xy;
     esp_lcd_touch_gt911->del = esp_lcd_touch_gt911_del;
+    esp_lcd_touch_gt911->enter_sleep = esp_lcd_touch_gt911_enter_sleep;
+    esp_lcd_touch_gt911->exit_sleep = esp_lcd_touch_gt911_exit_sleep;
 
     /* Mutex */
     esp_lcd_touch_gt911->data.lock.owner = portMUX_FREE_VAL;
@@ -97,11 +112,15 @@ esp_err_t esp_lcd_touch_new_i2c_gt911(const esp_lcd_panel_io_handle_t io, const
     }
 
     /* Reset controller */
+    lcd_boot_stage_begin(boot_timeline, "gt911_reset", -1);
     ret = touch_gt911_reset(esp_lcd_touch_gt911);
+    lcd_boot_stage_end(boot_timeline);
     ESP_GOTO_ON_ERROR(ret, err, TAG, "GT911 reset failed");
 
     /* Read status and config info */
+    lcd_boot_stage_begin(boot_timeline, "gt911_read_cfg", -1);
     ret = touch_gt911_read_cfg(esp_lcd_touch_gt911);
+    lcd_boot_stage_end(boot_timeline);
     ESP_GOTO_ON_ERROR(ret, err, TAG, "GT911 init failed");
 
 err:
@@ -217,6 +236,47 @@ static esp_err_t esp_lcd_touch_gt911_del(esp_lcd_touch_handle_t tp)
     return ESP_OK;
 }
 
+static esp_err_t esp_lcd_touch_gt911_enter_sleep(esp_lcd_touch_handle_t tp)
+{
+    assert(tp != NULL);
+
+    /* INT has to be held low while the controller sleeps, a rising edge wakes it up */
+    if (tp->config.int_gpio_num != GPIO_NUM_NC) {
+        if (tp->config.interrupt_callback) {
+            gpio_intr_disable(tp->config.int_gpio_num);
+        }
+        ESP_RETURN_ON_ERROR(gpio_set_direction(tp->config.int_gpio_num, GPIO_MODE_OUTPUT), TAG, "GPIO set direction error!");
+        ESP_RETURN_ON_ERROR(gpio_set_level(tp->config.int_gpio_num, 0), TAG, "GPIO set level error!");
+    }
+
+    ESP_RETURN_ON_ERROR(touch_gt911_i2c_write(tp, ESP_LCD_TOUCH_GT911_COMMAND_REG, ESP_LCD_TOUCH_GT911_CMD_SLEEP), TAG,
+                        "GT911 write error!");
+
+    return ESP_OK;
+}
+
+static esp_err_t esp_lcd_touch_gt911_exit_sleep(esp_lcd_touch_handle_t tp)
+{
+    assert(tp != NULL);
+
+    const esp_lcd_touch_gt911_config_t *gt911_config = (const esp_lcd_touch_gt911_config_t *)tp->config.driver_data;
+    lcd_boot_timeline_t *boot_timeline = gt911_config ? gt911_config->boot_timeline : NULL;
+
+    /* Without INT the controller can only be woken up by a reset */
+    if (tp->config.int_gpio_num == GPIO_NUM_NC) {
+        return touch_gt911_reset(tp);
+    }
+
+    ESP_RETURN_ON_ERROR(gpio_set_level(tp->config.int_gpio_num, 1), TAG, "GPIO set level error!");
+    lcd_boot_sleep_ms(boot_timeline, ESP_LCD_TOUCH_GT911_WAKE_PULSE_MS);
+    ESP_RETURN_ON_ERROR(gpio_set_direction(tp->config.int_gpio_num, GPIO_MODE_INPUT), TAG, "GPIO set direction error!");
+    if (tp->config.interrupt_callback) {
+        gpio_intr_enable(tp->config.int_gpio_num);
+    }
+
+    return ESP_OK;
+}
+
 /*******************************************************************************
 * Private API function
 *******************************************************************************/
@@ -226,11 +286,15 @@ static esp_err_t touch_gt911_reset(esp_lcd_touch_handle_t tp)
 {
     assert(tp != NULL);
 
+    const esp_lcd_touch_gt911_config_t *gt911_config = (const esp_lcd_touch_gt911_config_t *)tp->config.driver_data;
+    lcd_boot_timeline_t *boot_timeline = gt911_config ? gt911_config->boot_timeline : NULL;
+    const lcd_boot_delays_t *boot_delays = gt911_config ? gt911_config->boot_delays : NULL;
+
     if (tp->config.rst_gpio_num != GPIO_NUM_NC) {
         ESP_RETURN_ON_ERROR(gpio_set_level(tp->config.rst_gpio_num, tp->config.levels.reset), TAG, "GPIO set level error!");
-        vTaskDelay(pdMS_TO_TICKS(10));
+        lcd_boot_sleep_ms(boot_timeline, LCD_BOOT_DELAY(boot_delays, reset_assert_ms, 10));
         ESP_RETURN_ON_ERROR(gpio_set_level(tp->config.rst_gpio_num, !tp->config.levels.reset), TAG, "GPIO set level error!");
-        vTaskDelay(pdMS_TO_TICKS(10));
+        lcd_boot_sleep_ms(boot_timeline, LCD_BOOT_DELAY(boot_delays, reset_release_ms, 10));
     }
 
     return ESP_OK;
@@ -12,11 +12,40 @@
 #pragma once
 
 #include "esp_lcd_touch.h"
+#include "lcd_boot.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief GT911 bring-up options
+ *
+ * @note  Optional, pass through the `driver_data` field in `esp_lcd_touch_config_t`. The driver keeps the pointer,
+ *        so the structure must stay valid while the touch handle is in use.
+ *
+ */
+typedef struct {
+    lcd_boot_timeline_t *boot_timeline;   /*!< Records the bring-up stages if not NULL */
+    const lcd_boot_delays_t *boot_delays; /*!< Fast-boot overrides for the reset delays, NULL to keep the defaults */
+} esp_lcd_touch_gt911_config_t;
+
+/**
+ * @brief Fast-boot delays from the GT911 datasheet minimums, with some margin
+ *
+ * @note  GT911: reset pulse >= 100 us; the 10 ms after reset release is kept for the I2C address latch.
+ *
+ */
+#define GT911_FAST_BOOT_DELAYS()                    \
+    {                                               \
+        .reset_idle_ms = LCD_BOOT_DELAY_DEFAULT,    \
+        .reset_assert_ms = 1,                       \
+        .reset_release_ms = LCD_BOOT_DELAY_DEFAULT, \
+        .sleep_out_ms = LCD_BOOT_DELAY_DEFAULT,     \
+        .display_on_ms = LCD_BOOT_DELAY_DEFAULT,    \
+        .cmd_ms = LCD_BOOT_DELAY_DEFAULT,           \
+    }
+
 /**
  * @brief Create a new GT911 touch driver
  *
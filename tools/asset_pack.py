@@ -0,0 +1,205 @@
+#!/usr/bin/env python3
+"""
+Build an image asset pack for lcd_asset_pack.
+
+Every PNG is converted ahead of time to the panel's pixel format and byte
+order, and optionally rotated for the mounting orientation, so the device can
+draw it straight out of the memory-mapped partition. With --compress the
+images are stored as Q565 streams instead and decoded row by row straight
+into the frame buffer. The pixel blocks are aligned for DMA. Names are looked
+up on the device through a hash-and-displace perfect hash stored in the pack.
+
+An asset is named after its path relative to the input directory, without the
+extension, e.g. "icons/wifi" for icons/wifi.png. Transparent pixels are
+blended over the background colour.
+
+Add a data partition for the pack to partitions.csv, e.g.
+    assets, data, 0x41, , 0x400000
+then flash it with
+    parttool.py --partition-name assets write_partition --input assets.bin
+
+Example:
+    python3 tools/asset_pack.py ui/ --rotate 90 -o assets.bin
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+import q565
+
+try:
+    from PIL import Image
+except ImportError:
+    sys.exit("asset_pack needs Pillow: pip install pillow")
+
+MAGIC = 0x314B5041  # "APK1"
+VERSION = 1
+FORMAT_RGB565 = 0
+FORMAT_RGB565_SWAPPED = 1
+FORMAT_Q565 = 2
+HEADER = struct.Struct("<IHHIIIIII")
+ENTRY = struct.Struct("<IIHHBBH")
+MMU_PAGE = 0x10000
+
+
+def fnv1a(name, seed):
+    """Same seeded FNV-1a as lcd_asset_pack::hash()."""
+    h = 2166136261 ^ seed
+    for c in name.encode("utf-8"):
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def perfect_hash(names):
+    """Return (seeds, slot of each name) for a hash-and-displace table of len(names) buckets."""
+    n = len(names)
+    buckets = [[] for _ in range(n)]
+    for i, name in enumerate(names):
+        buckets[fnv1a(name, 0) % n].append(i)
+
+    seeds = [0] * n
+    slots = [None] * n
+    taken = [False] * n
+    # Largest buckets first, they are the hardest to place
+    order = sorted(range(n), key=lambda b: -len(buckets[b]))
+    for b in order:
+        keys = buckets[b]
+        if len(keys) <= 1:
+            break
+        d = 1
+        while True:
+            pos = [fnv1a(names[k], d) % n for k in keys]
+            if len(set(pos)) == len(pos) and not any(taken[p] for p in pos):
+                break
+            d += 1
+            if d > 1 << 24:
+                sys.exit("no perfect hash found, check for duplicate names")
+        seeds[b] = d
+        for k, p in zip(keys, pos):
+            taken[p] = True
+            slots[k] = p
+
+    # Single-key buckets take a free slot directly, stored as -slot - 1
+    free = (p for p in range(n) if not taken[p])
+    for b in order:
+        if len(buckets[b]) == 1:
+            p = next(free)
+            taken[p] = True
+            seeds[b] = -p - 1
+            slots[buckets[b][0]] = p
+    return seeds, slots
+
+
+def parse_color(text):
+    text = text.lstrip("#")
+    if len(text) != 6:
+        raise argparse.ArgumentTypeError("colour must be RRGGBB")
+    return tuple(int(text[i:i + 2], 16) for i in (0, 2, 4))
+
+
+def convert(path, rotate, swap, compress, background):
+    img = Image.open(path).convert("RGBA")
+    if rotate:
+        # PIL rotates counter-clockwise, the pack records clockwise steps
+        img = img.rotate(-rotate, expand=True)
+    flat = Image.new("RGB", img.size, background)
+    flat.paste(img, mask=img.getchannel("A"))
+
+    raw = flat.tobytes()
+    values = [((raw[i] & 0xF8) << 8) | ((raw[i + 1] & 0xFC) << 3) | (raw[i + 2] >> 3) for i in range(0, len(raw), 3)]
+    if compress:
+        return flat.width, flat.height, q565.encode(values, flat.width, flat.height)
+    return flat.width, flat.height, struct.pack((">%dH" if swap else "<%dH") % len(values), *values)
+
+
+def collect(inputs):
+    """Return sorted (name, path) pairs for every PNG given or found under the given directories."""
+    found = {}
+    for item in inputs:
+        if os.path.isdir(item):
+            for root, _, files in os.walk(item):
+                for f in files:
+                    if f.lower().endswith(".png"):
+                        path = os.path.join(root, f)
+                        name = os.path.splitext(os.path.relpath(path, item))[0].replace(os.sep, "/")
+                        found.setdefault(name, []).append(path)
+        else:
+            found.setdefault(os.path.splitext(os.path.basename(item))[0], []).append(item)
+    for name, paths in found.items():
+        if len(paths) > 1:
+            sys.exit("duplicate asset name %r: %s" % (name, ", ".join(paths)))
+    return sorted((name, paths[0]) for name, paths in found.items())
+
+
+def align_up(value, align):
+    return (value + align - 1) // align * align
+
+
+def build(assets, rotate, swap, compress, background, align):
+    names = [name for name, _ in assets]
+    seeds, slots = perfect_hash(names)
+    n = len(names)
+
+    seeds_offset = HEADER.size
+    entries_offset = seeds_offset + 4 * n
+    names_offset = entries_offset + ENTRY.size * n
+    name_blob = bytearray()
+    name_at = []
+    for name in names:
+        name_at.append(names_offset + len(name_blob))
+        name_blob += name.encode("utf-8") + b"\0"
+
+    data = bytearray()
+    data_start = align_up(names_offset + len(name_blob), align)
+    entries = [None] * n
+    for i, (name, path) in enumerate(assets):
+        width, height, pixels = convert(path, rotate, swap, compress, background)
+        offset = data_start + align_up(len(data), align)
+        data += bytes(offset - data_start - len(data)) + pixels
+        fmt = FORMAT_Q565 if compress else FORMAT_RGB565_SWAPPED if swap else FORMAT_RGB565
+        entries[slots[i]] = ENTRY.pack(name_at[i], offset, width, height, fmt, rotate // 90, 0)
+        print("  %-32s %4dx%-4d @0x%06X %7d bytes" % (name, width, height, offset, len(pixels)), file=sys.stderr)
+
+    size = data_start + len(data)
+    out = bytearray(HEADER.pack(MAGIC, VERSION, n, n, seeds_offset, entries_offset, names_offset, size, align))
+    out += struct.pack("<%di" % n, *seeds)
+    out += b"".join(entries)
+    out += name_blob
+    out += bytes(data_start - len(out))
+    out += data
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("inputs", nargs="+", help="PNG files or directories")
+    parser.add_argument("-o", "--output", default="assets.bin", help="pack image (default: assets.bin)")
+    parser.add_argument("--rotate", type=int, choices=(0, 90, 180, 270), default=0,
+                        help="clockwise pre-rotation for the mounting orientation")
+    parser.add_argument("--swap-bytes", action="store_true", help="big-endian RGB565 for SPI/I80 panels")
+    parser.add_argument("--compress", action="store_true", help="store Q565 streams instead of raw pixels")
+    parser.add_argument("--background", type=parse_color, default=(0, 0, 0), help="RRGGBB (default: 000000)")
+    parser.add_argument("--align", type=int, default=128, help="pixel block alignment in bytes (default: 128)")
+    args = parser.parse_args()
+
+    if args.align <= 0 or args.align & (args.align - 1):
+        sys.exit("--align must be a power of two")
+    if args.swap_bytes and args.compress:
+        sys.exit("Q565 streams are always little-endian, --swap-bytes cannot be combined with --compress")
+    assets = collect(args.inputs)
+    if not assets:
+        sys.exit("no PNG files found")
+    if len(assets) > 0xFFFF:
+        sys.exit("too many assets")
+
+    pack = build(assets, args.rotate, args.swap_bytes, args.compress, args.background, args.align)
+    with open(args.output, "wb") as f:
+        f.write(pack)
+    print("%s: %d asset(s), %d bytes, needs a partition of at least 0x%X"
+          % (args.output, len(assets), len(pack), align_up(len(pack), MMU_PAGE)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
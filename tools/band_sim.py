@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""
+Host simulation of the band-rendering mode (lcd_band) to pick a band height.
+
+The renderer fills a band in internal SRAM, then the DMA2D copies it into the
+DPI framebuffer while the renderer starts on the next free band. This script
+models that pipeline for a sweep of band heights and prints the frame time,
+renderer stall time and SRAM cost of each, next to the full-frame PSRAM setup
+used by the original examples.
+
+Example:
+    python3 tools/band_sim.py --width 1024 --height 600 --bands 2
+"""
+
+import argparse
+
+
+def simulate(width, height, band_lines, band_num, render_ns_px, dma_mb_s, band_setup_us):
+    """Return (frame_us, stall_us) for one full frame rendered in bands."""
+    band_px = width * band_lines
+    bands = (height + band_lines - 1) // band_lines
+    render_us = band_px * render_ns_px / 1000.0
+    dma_us = band_px * 2 / dma_mb_s + band_setup_us
+
+    free_at = [0.0] * band_num  # time at which each ring slot becomes free
+    cpu = 0.0                   # renderer time cursor
+    dma = 0.0                   # DMA time cursor
+    stall = 0.0
+    for i in range(bands):
+        slot = i % band_num
+        if free_at[slot] > cpu:
+            stall += free_at[slot] - cpu
+            cpu = free_at[slot]
+        cpu += render_us
+        dma = max(dma, cpu) + dma_us
+        free_at[slot] = dma
+    return dma, stall
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--width", type=int, default=1024)
+    parser.add_argument("--height", type=int, default=600)
+    parser.add_argument("--bands", type=int, default=2, help="number of band buffers in the ring (2~4)")
+    parser.add_argument("--render-sram-ns", type=float, default=6.0, help="render cost per pixel into internal SRAM (ns)")
+    parser.add_argument("--render-psram-ns", type=float, default=11.0, help="render cost per pixel into PSRAM (ns)")
+    parser.add_argument("--dma-mb-s", type=float, default=400.0, help="DMA2D SRAM->PSRAM throughput (MB/s)")
+    parser.add_argument("--band-setup-us", type=float, default=15.0, help="fixed cost per submitted band (us)")
+    parser.add_argument("--lines", type=int, nargs="*", default=[8, 16, 24, 32, 40, 60, 80, 120])
+    args = parser.parse_args()
+
+    full_us = args.width * args.height * args.render_psram_ns / 1000.0
+    full_us += args.width * args.height * 2 / args.dma_mb_s + args.band_setup_us
+    full_kb = args.width * args.height * 2 * 2 / 1024
+    print(f"full frame (2 x PSRAM): {full_us / 1000:7.2f} ms  {1e6 / full_us:6.1f} fps  {full_kb:8.0f} KB PSRAM")
+    print(f"{'lines':>5} {'frame ms':>9} {'fps':>6} {'stall ms':>9} {'SRAM KB':>8}")
+    for lines in args.lines:
+        frame, stall = simulate(args.width, args.height, lines, args.bands,
+                                args.render_sram_ns, args.dma_mb_s, args.band_setup_us)
+        sram_kb = args.width * lines * 2 * args.bands / 1024
+        print(f"{lines:5d} {frame / 1000:9.2f} {1e6 / frame:6.1f} {stall / 1000:9.2f} {sram_kb:8.0f}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+Rasterise a TrueType/OpenType font into an anti-aliased bitmap font for lcd_font.
+
+Each glyph is rendered once on the host at the requested pixel size and stored
+as 4 or 8 bit alpha, cropped to its ink box. The bitmaps are packed back to
+back into one atlas, with identical bitmaps stored once. Kerning pairs between
+the selected characters are measured through Pillow's text layout and kept
+only where they move the pen by at least half a pixel; GPOS kerning needs a
+Pillow built with libraqm.
+
+The output can be embedded in the firmware or flashed to a data partition and
+memory-mapped; it is used in place, pass it to font_begin() / lcd_font::begin().
+
+Example:
+    python3 tools/font2bin.py Inter.ttf --size 24 -o inter24.bin
+    python3 tools/font2bin.py NotoSansSC.otf --size 20 --text strings.txt --bpp 4 -o ui20.bin
+"""
+
+import argparse
+import struct
+import sys
+
+try:
+    from PIL import Image, ImageDraw, ImageFont
+except ImportError:
+    sys.exit("font2bin needs Pillow: pip install pillow")
+
+MAGIC = 0x31544E46  # "FNT1"
+HEADER = struct.Struct("<IBBHhHIIIIII")
+GLYPH = struct.Struct("<IIBBbbhH")
+KERN = struct.Struct("<IhH")
+
+
+def parse_ranges(text):
+    """Parse "32-126,0x4E00-0x4E2F,0xB0" into a set of code points."""
+    points = set()
+    for part in text.split(","):
+        part = part.strip()
+        if not part:
+            continue
+        lo, _, hi = part.partition("-")
+        lo = int(lo, 0)
+        hi = int(hi, 0) if hi else lo
+        if hi < lo:
+            raise argparse.ArgumentTypeError("bad range %r" % part)
+        points.update(range(lo, hi + 1))
+    return points
+
+
+def rasterise(font, ch, bpp):
+    """Return (width, height, x_off, y_off, advance, rows) for one character."""
+    advance = int(round(font.getlength(ch)))
+    x0, y0, x1, y1 = font.getbbox(ch, anchor="ls")
+    w, h = max(0, x1 - x0), max(0, y1 - y0)
+    if w == 0 or h == 0:
+        return 0, 0, 0, 0, advance, b""
+    if w > 255 or h > 255 or not -128 <= x0 <= 127 or not -128 <= y0 <= 127:
+        sys.exit("glyph U+%04X is too large for the format, use a smaller --size" % ord(ch))
+
+    img = Image.new("L", (w, h), 0)
+    ImageDraw.Draw(img).text((-x0, -y0), ch, fill=255, font=font, anchor="ls")
+    alpha = img.tobytes()
+    if bpp == 8:
+        return w, h, x0, y0, advance, alpha
+
+    # 4 bpp, high nibble first, every row starts on a byte boundary
+    rows = bytearray()
+    for y in range(h):
+        line = [(a * 15 + 127) // 255 for a in alpha[y * w:(y + 1) * w]]
+        if w & 1:
+            line.append(0)
+        rows += bytes(line[i] << 4 | line[i + 1] for i in range(0, len(line), 2))
+    return w, h, x0, y0, advance, bytes(rows)
+
+
+def kerning(font, chars, limit):
+    """Return {(left, right): adjust} for pairs among the first `limit` characters."""
+    pairs = {}
+    chars = chars[:limit]
+    width = {c: font.getlength(c) for c in chars}
+    for a in chars:
+        for b in chars:
+            k = font.getlength(a + b) - width[a] - width[b]
+            if abs(k) >= 0.5:
+                pairs[(a, b)] = int(round(k))
+    return pairs
+
+
+def build(font, points, bpp, kern_limit):
+    chars = []
+    glyphs = []
+    atlas = bytearray()
+    seen = {}
+    # Characters missing from the font render as .notdef, skip them
+    notdef = rasterise(font, chr(0x10FFFF), bpp)
+    for cp in sorted(points):
+        ch = chr(cp)
+        glyph = rasterise(font, ch, bpp)
+        if glyph == notdef and cp != ord("?"):
+            print("  U+%04X not in the font, skipped" % cp, file=sys.stderr)
+            continue
+        w, h, x_off, y_off, advance, rows = glyph
+        if rows not in seen:
+            seen[rows] = len(atlas)
+            atlas += rows
+        chars.append(ch)
+        glyphs.append((cp, seen[rows], w, h, x_off, y_off, advance))
+
+    index = {c: i for i, c in enumerate(chars)}
+    kerns = sorted((index[a] << 16 | index[b], k) for (a, b), k in kerning(font, chars, kern_limit).items())
+
+    ascent, descent = font.getmetrics()
+    glyphs_offset = HEADER.size
+    kern_offset = glyphs_offset + GLYPH.size * len(glyphs)
+    atlas_offset = kern_offset + KERN.size * len(kerns)
+    size = atlas_offset + len(atlas)
+
+    out = bytearray(HEADER.pack(MAGIC, bpp, 0, ascent + descent, ascent, 0, len(glyphs), glyphs_offset,
+                                len(kerns), kern_offset, atlas_offset, size))
+    for g in glyphs:
+        out += GLYPH.pack(*g, 0)
+    for pair, k in kerns:
+        out += KERN.pack(pair, k, 0)
+    out += atlas
+    return bytes(out), len(glyphs), len(kerns), len(atlas)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("font", help="TTF/OTF file")
+    parser.add_argument("-o", "--output", default="font.bin", help="output font (default: font.bin)")
+    parser.add_argument("--size", type=int, required=True, help="pixel size")
+    parser.add_argument("--bpp", type=int, choices=(4, 8), default=8, help="alpha bits per pixel (default: 8)")
+    parser.add_argument("--range", type=parse_ranges, default=parse_ranges("32-126"),
+                        help="code points, e.g. 32-126,0xB0 (default: printable ASCII)")
+    parser.add_argument("--text", action="append", default=[], help="also include every character of this UTF-8 file")
+    parser.add_argument("--kern-limit", type=int, default=256,
+                        help="only kern pairs among the first N characters (default: 256)")
+    args = parser.parse_args()
+
+    points = set(args.range)
+    for path in args.text:
+        with open(path, encoding="utf-8") as f:
+            points.update(ord(c) for c in f.read() if c not in "\r\n\t")
+    points.add(ord("?"))  # fallback for missing glyphs
+
+    font = ImageFont.truetype(args.font, args.size)
+    data, glyphs, kerns, atlas = build(font, points, args.bpp, args.kern_limit)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("%s: %d glyphs, %d kerning pairs, %d byte atlas, %d bytes"
+          % (args.output, glyphs, kerns, atlas, len(data)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
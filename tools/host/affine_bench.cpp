@@ -0,0 +1,211 @@
+/*
+ * Host check and benchmark for lcd_affine.
+ *
+ * Compares lcd_affine_draw() against a naive per-pixel float transform over random rotations,
+ * scales and pivots, checks the bilinear, ARGB8888, clip and colour LUT paths, then times the naive
+ * transform against the fixed-point nearest and bilinear spans on a 720x720 destination.
+ *
+ * Example:
+ *     g++ -std=gnu++2b -O2 -Itools/host/stub -Isrc/display \
+ *         tools/host/affine_bench.cpp src/display/lcd_affine.cpp -o /tmp/affine_bench && /tmp/affine_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include "esp_timer.h"
+#include "lcd_affine.h"
+
+#define DST_W 720
+#define DST_H 720
+#define SRC_W 200
+#define SRC_H 120
+
+static uint16_t s_src[SRC_W * SRC_H];
+static uint32_t s_src32[SRC_W * SRC_H];
+static uint16_t s_ref[DST_W * DST_H];
+static uint16_t s_dst[DST_W * DST_H];
+
+int64_t esp_timer_get_time(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 参考实现：整张目标图逐像素用浮点反算源坐标，每个像素都做越界判断
+static void naive_draw(uint16_t *dst, const lcd_affine_xform_t *xf)
+{
+    float r = xf->angle * (float)M_PI / 180;
+    float c = cosf(r), s = sinf(r);
+    for (int y = 0; y < DST_H; y++) {
+        for (int x = 0; x < DST_W; x++) {
+            float dx = x + 0.5f - xf->x, dy = y + 0.5f - xf->y;
+            float u = xf->pivot_x + (c * dx + s * dy) / xf->scale_x;
+            float v = xf->pivot_y + (-s * dx + c * dy) / xf->scale_y;
+            int iu = (int)floorf(u), iv = (int)floorf(v);
+            if (iu >= 0 && iu < SRC_W && iv >= 0 && iv < SRC_H) {
+                dst[y * DST_W + x] = s_src[iv * SRC_W + iu];
+            }
+        }
+    }
+}
+
+static bool outside(int i, const uint16_t b[4])
+{
+    int x = i % DST_W, y = i / DST_W;
+    return x < b[0] || y < b[1] || x >= b[0] + b[2] || y >= b[1] + b[3];
+}
+
+template <typename F>
+static double time_us(F f)
+{
+    const int rounds = 50;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        f();
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / rounds;
+}
+
+int main()
+{
+    lcd_stats_t stats = {};
+    uint16_t bounds[4];
+    lcd_affine_image_t img = {s_src, SRC_W, SRC_W, SRC_H, LCD_AFFINE_RGB565};
+    lcd_affine_image_t img32 = {s_src32, SRC_W, SRC_W, SRC_H, LCD_AFFINE_ARGB8888};
+
+    // 最近邻：200 组随机变换，与参考实现逐像素比较，落点必须都在返回的 bounds 内
+    srand(1);
+    for (int i = 0; i < SRC_W * SRC_H; i++) {
+        s_src[i] = rand() | 1;
+    }
+    long total = 0, diff = 0;
+    for (int k = 0; k < 200; k++) {
+        lcd_affine_xform_t xf = {(float)(k * 7.3 - 300), 0.3f + (k % 17) * 0.25f, 0.4f + (k % 11) * 0.3f,
+                                 (float)(k % SRC_W), (float)(k % SRC_H), k * 13 % DST_W - 50, k * 29 % DST_H - 50, false};
+        memset(s_ref, 0, sizeof(s_ref));
+        memset(s_dst, 0, sizeof(s_dst));
+        naive_draw(s_ref, &xf);
+        lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img, &xf, 0, 0, DST_W, DST_H, bounds, &stats);
+        for (int i = 0; i < DST_W * DST_H; i++) {
+            total += s_ref[i] || s_dst[i];
+            diff += s_ref[i] != s_dst[i];
+            if (s_dst[i] && outside(i, bounds)) {
+                printf("FAIL: pixel %d outside bounds\n", i);
+                return 1;
+            }
+        }
+    }
+    // 边缘像素中心恰好落在源图边界上时浮点和定点的取舍可能不同，差异应远小于 1%
+    printf("nearest: %ld/%ld pixels differ (%.4f%%)\n", diff, total, 100.0 * diff / total);
+    if (diff * 100 > total) {
+        printf("FAIL: nearest differs from the reference\n");
+        return 1;
+    }
+
+    // 双线性：纯色源图插值后仍是同一颜色，单位变换与源图逐像素一致
+    for (int i = 0; i < SRC_W * SRC_H; i++) {
+        s_src[i] = 0x7BEF;
+    }
+    lcd_affine_xform_t xf = {33, 1.7f, 1.7f, 100, 60, 360, 360, true};
+    memset(s_dst, 0, sizeof(s_dst));
+    lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img, &xf, 0, 0, DST_W, DST_H, bounds, &stats);
+    for (int i = 0; i < DST_W * DST_H; i++) {
+        if (s_dst[i] && s_dst[i] != 0x7BEF) {
+            printf("FAIL: bilinear constant source gave %04x\n", s_dst[i]);
+            return 1;
+        }
+    }
+    for (int i = 0; i < SRC_W * SRC_H; i++) {
+        s_src[i] = rand();
+    }
+    lcd_affine_xform_t ident = {0, 1, 1, 0, 0, 10, 20, true};
+    memset(s_dst, 0, sizeof(s_dst));
+    lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img, &ident, 0, 0, DST_W, DST_H, bounds, &stats);
+    for (int y = 0; y < SRC_H; y++) {
+        for (int x = 0; x < SRC_W; x++) {
+            if (s_dst[(y + 20) * DST_W + x + 10] != s_src[y * SRC_W + x]) {
+                printf("FAIL: bilinear identity at %d,%d\n", x, y);
+                return 1;
+            }
+        }
+    }
+    printf("bilinear: ok\n");
+
+    // ARGB8888：alpha 0 不改目标，alpha 255 直接覆盖
+    lcd_affine_xform_t rot = {45, 1, 1, 100, 60, 360, 360, true};
+    for (int i = 0; i < SRC_W * SRC_H; i++) {
+        s_src32[i] = 0x00FF0000;
+    }
+    for (int i = 0; i < DST_W * DST_H; i++) {
+        s_dst[i] = 0x1234;
+    }
+    lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img32, &rot, 0, 0, DST_W, DST_H, bounds, &stats);
+    for (int i = 0; i < DST_W * DST_H; i++) {
+        if (s_dst[i] != 0x1234) {
+            printf("FAIL: transparent ARGB source changed the destination\n");
+            return 1;
+        }
+    }
+    for (int i = 0; i < SRC_W * SRC_H; i++) {
+        s_src32[i] = 0xFF00FF00;
+    }
+    lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img32, &rot, 0, 0, DST_W, DST_H, bounds, &stats);
+    long green = 0;
+    for (int i = 0; i < DST_W * DST_H; i++) {
+        green += s_dst[i] == 0x07E0;
+    }
+    printf("argb: %ld opaque pixels (source has %d)\n", green, SRC_W * SRC_H);
+
+    // 裁剪：只能写进裁剪矩形
+    memset(s_dst, 0, sizeof(s_dst));
+    lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img, &rot, 300, 300, 50, 40, bounds, &stats);
+    for (int i = 0; i < DST_W * DST_H; i++) {
+        int x = i % DST_W, y = i / DST_W;
+        if (s_dst[i] && (x < 300 || x >= 350 || y < 300 || y >= 340)) {
+            printf("FAIL: pixel %d,%d outside the clip\n", x, y);
+            return 1;
+        }
+    }
+    printf("clip: ok, bounds %u %u %u %u\n", bounds[0], bounds[1], bounds[2], bounds[3]);
+
+    // 色彩校正：带 LUT 的最近邻结果等于先画再逐像素查表
+    lcd_color_lut_table_t lut;
+    for (int i = 0; i < 32; i++) {
+        lut.r[i] = (uint16_t)((31 - i) << 11);
+        lut.b[i] = (uint16_t)(i / 2);
+    }
+    for (int i = 0; i < 64; i++) {
+        lut.g[i] = (uint16_t)((i * 3 / 4) << 5);
+    }
+    for (int i = 0; i < SRC_W * SRC_H; i++) {
+        s_src[i] = rand() | 1;
+    }
+    memset(s_ref, 0, sizeof(s_ref));
+    memset(s_dst, 0, sizeof(s_dst));
+    rot.bilinear = false;
+    lcd_affine_draw(s_ref, DST_W, DST_W, DST_H, &img, &rot, 0, 0, DST_W, DST_H, bounds, &stats);
+    lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img, &rot, 0, 0, DST_W, DST_H, bounds, &stats, &lut);
+    for (int i = 0; i < DST_W * DST_H; i++) {
+        if (s_ref[i] && s_dst[i] != lcd_color_lut_lookup(&lut, s_ref[i])) {
+            printf("FAIL: corrected pixel %d\n", i);
+            return 1;
+        }
+    }
+    printf("lut: ok\n");
+
+    // 基准：旋转 30 度放大 2 倍，整张 720x720 目标
+    lcd_affine_xform_t bench = {30, 2, 2, 100, 60, 360, 360, false};
+    double naive_us = time_us([&] { naive_draw(s_ref, &bench); });
+    double nearest_us = time_us([&] {
+        lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img, &bench, 0, 0, DST_W, DST_H, bounds, &stats);
+    });
+    bench.bilinear = true;
+    double bilinear_us = time_us([&] {
+        lcd_affine_draw(s_dst, DST_W, DST_W, DST_H, &img, &bench, 0, 0, DST_W, DST_H, bounds, &stats);
+    });
+    printf("naive %.0f us, fixed nearest %.0f us, fixed bilinear %.0f us\n", naive_us, nearest_us, bilinear_us);
+    return 0;
+}
@@ -0,0 +1,243 @@
+/*
+ * Simulated panel bring-up on the host, for the boot timeline and the fast-boot delay presets.
+ *
+ * Runs the ST7703, GC9503 and EK79007 native drivers against a fake DBI command bus, reset GPIO and
+ * DPI panel on a virtual clock. Delays advance the clock by their full length, so a run takes no
+ * real time. Each panel is brought up twice: once with the driver delays and once with its
+ * *_FAST_BOOT_DELAYS() preset. The program checks that both runs send the same command stream,
+ * that every boot stage is closed, and that the preset is not slower. It then prints both
+ * totals. Pass -v to print the full timelines.
+ *
+ * Bus and DPI costs are rough models (BUS_* below), so only the delay part of the totals is exact.
+ *
+ * Example:
+ *     gcc -std=gnu17 -O2 -Wall -Itools/host/stub -Isrc/common -Isrc/display/native tools/host/boot_sim.c \
+ *         src/common/lcd_boot.c src/display/native/esp_lcd_st7703.c src/display/native/esp_lcd_gc9503.c \
+ *         src/display/native/esp_lcd_ek79007.c -o /tmp/boot_sim && /tmp/boot_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_timer.h"
+#include "esp_lcd_panel_interface.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_mipi_dsi.h"
+#include "lcd_boot.h"
+#include "esp_lcd_st7703.h"
+#include "esp_lcd_gc9503.h"
+#include "esp_lcd_ek79007.h"
+
+#define BUS_PACKET_US 20     // 每个 LP 模式命令包的固定开销
+#define BUS_BYTE_US 1        // LP 模式约 10 Mbps，每字节约 1 us
+#define BUS_READ_US 100      // 读 ID 需要总线反转，按一次往返计
+#define DPI_NEW_US 500       // 创建 DPI 面板：分配帧缓冲、配置 DMA
+#define DPI_INIT_US 1000     // 启动 DPI 视频流
+#define RESET_GPIO 27
+#define MAX_CMDS 256
+
+typedef struct {
+    int cmd;
+    size_t size;
+    uint32_t hash;
+} sent_cmd_t;
+
+static int64_t s_now_us;
+static sent_cmd_t s_cmds[MAX_CMDS];
+static size_t s_num_cmds;
+static int s_verbose;
+static int s_failures;
+
+#define CHECK(cond) do {                                              \
+        if (!(cond)) {                                                \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+            s_failures++;                                             \
+        }                                                             \
+    } while (0)
+
+int64_t esp_timer_get_time(void)
+{
+    return s_now_us;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    s_now_us += (int64_t)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    return ESP_OK;
+}
+
+// 记下每条命令和参数的哈希，快速启动前后的命令流必须一致，只有延时不同
+esp_err_t esp_lcd_panel_io_tx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, const void *param, size_t param_size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < param_size; i++) {
+        hash = (hash ^ ((const uint8_t *)param)[i]) * 16777619u;
+    }
+    if (s_num_cmds < MAX_CMDS) {
+        s_cmds[s_num_cmds].cmd = lcd_cmd;
+        s_cmds[s_num_cmds].size = param_size;
+        s_cmds[s_num_cmds].hash = hash;
+    }
+    s_num_cmds++;
+    s_now_us += BUS_PACKET_US + (int64_t)(1 + param_size) * BUS_BYTE_US;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_io_rx_param(esp_lcd_panel_io_handle_t io, int lcd_cmd, void *param, size_t param_size)
+{
+    memset(param, 0x5A, param_size);
+    s_now_us += BUS_READ_US;
+    return ESP_OK;
+}
+
+static esp_err_t dpi_init(esp_lcd_panel_t *panel)
+{
+    s_now_us += DPI_INIT_US;
+    return ESP_OK;
+}
+
+static esp_err_t dpi_del(esp_lcd_panel_t *panel)
+{
+    free(panel);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_dpi(esp_lcd_dsi_bus_handle_t bus, const esp_lcd_dpi_panel_config_t *panel_config,
+                                esp_lcd_panel_handle_t *ret_panel)
+{
+    esp_lcd_panel_t *panel = (esp_lcd_panel_t *)calloc(1, sizeof(esp_lcd_panel_t));
+    if (!panel) {
+        return ESP_ERR_NO_MEM;
+    }
+    panel->init = dpi_init;
+    panel->del = dpi_del;
+    s_now_us += DPI_NEW_US;
+    *ret_panel = panel;
+    return ESP_OK;
+}
+
+typedef esp_err_t (*new_panel_fn_t)(const esp_lcd_panel_io_handle_t io, const esp_lcd_panel_dev_config_t *config,
+                                    esp_lcd_panel_handle_t *ret_panel);
+
+typedef struct {
+    uint32_t total_us;
+    uint32_t sleep_us;
+    size_t num_cmds;
+    sent_cmd_t cmds[MAX_CMDS];
+} run_t;
+
+// 与显示类的 begin() 一样按 new_panel、reset、init 三段记录；vendor_config 由调用者按面板类型填好
+static void run(new_panel_fn_t new_panel, void *vendor_config, lcd_boot_timeline_t *tl, run_t *out)
+{
+    esp_lcd_panel_dev_config_t dev_config = {
+        .reset_gpio_num = RESET_GPIO,
+        .rgb_ele_order = LCD_RGB_ELEMENT_ORDER_RGB,
+        .bits_per_pixel = 16,
+        .vendor_config = vendor_config,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+
+    s_now_us = 0;
+    s_num_cmds = 0;
+    lcd_boot_timeline_reset(tl);
+    lcd_boot_stage_begin(tl, "new_panel", -1);
+    CHECK(new_panel((esp_lcd_panel_io_handle_t)1, &dev_config, &panel) == ESP_OK);
+    lcd_boot_stage_end(tl);
+    if (!panel) {
+        return;
+    }
+    lcd_boot_stage_begin(tl, "reset", -1);
+    CHECK(panel->reset(panel) == ESP_OK);
+    lcd_boot_stage_end(tl);
+    lcd_boot_stage_begin(tl, "init", -1);
+    CHECK(panel->init(panel) == ESP_OK);
+    lcd_boot_stage_end(tl);
+    panel->del(panel);
+
+    CHECK(tl->depth == 0 && tl->dropped == 0 && s_num_cmds <= MAX_CMDS);
+    out->total_us = lcd_boot_total_us(tl);
+    out->sleep_us = 0;
+    for (uint16_t i = 0; i < tl->num; i++) {
+        if (tl->stages[i].depth == 0) {
+            out->sleep_us += tl->stages[i].sleep_us;
+        }
+    }
+    out->num_cmds = s_num_cmds;
+    memcpy(out->cmds, s_cmds, sizeof(s_cmds));
+    if (s_verbose) {
+        lcd_boot_timeline_print(tl, NULL, NULL);
+    }
+}
+
+static void report(const char *name, const run_t *def, const run_t *fast)
+{
+    int failures = s_failures;
+
+    CHECK(def->num_cmds == fast->num_cmds && def->num_cmds > 0);
+    CHECK(memcmp(def->cmds, fast->cmds, def->num_cmds * sizeof(sent_cmd_t)) == 0);
+    CHECK(fast->total_us <= def->total_us);
+    // 除延时外的时间两次应一致，差别只来自延时
+    CHECK(def->total_us - def->sleep_us == fast->total_us - fast->sleep_us);
+    printf("%-8s %3zu cmds | default %8.3f ms (%8.3f in delays) | fast %8.3f ms (%8.3f in delays) | %s\n", name,
+           def->num_cmds, def->total_us / 1000.0, def->sleep_us / 1000.0, fast->total_us / 1000.0,
+           fast->sleep_us / 1000.0, s_failures != failures ? "FAIL" : "ok");
+}
+
+int main(int argc, char **argv)
+{
+    static lcd_boot_timeline_t tl;
+    static run_t def, fast;
+    esp_lcd_dsi_bus_handle_t bus = (esp_lcd_dsi_bus_handle_t)1;
+    s_verbose = argc > 1 && !strcmp(argv[1], "-v");
+
+    {
+        const esp_lcd_dpi_panel_config_t dpi = ST7703_720_720_PANEL_60HZ_DPI_CONFIG(LCD_COLOR_PIXEL_FORMAT_RGB565);
+        const lcd_boot_delays_t delays = ST7703_FAST_BOOT_DELAYS();
+        st7703_vendor_config_t vendor = {.mipi_config = {.dsi_bus = bus, .dpi_config = &dpi, .lane_num = 2},
+                                         .boot_timeline = &tl};
+        run(esp_lcd_new_panel_st7703, &vendor, &tl, &def);
+        vendor.boot_delays = &delays;
+        run(esp_lcd_new_panel_st7703, &vendor, &tl, &fast);
+        report("st7703", &def, &fast);
+    }
+    {
+        const esp_lcd_dpi_panel_config_t dpi = GC9503_376_960_PANEL_60HZ_DPI_CONFIG(LCD_COLOR_PIXEL_FORMAT_RGB565);
+        const lcd_boot_delays_t delays = GC9503_FAST_BOOT_DELAYS();
+        gc9503_vendor_config_t vendor = {.mipi_config = {.dsi_bus = bus, .dpi_config = &dpi, .lane_num = 2},
+                                         .boot_timeline = &tl};
+        run(esp_lcd_new_panel_gc9503, &vendor, &tl, &def);
+        vendor.boot_delays = &delays;
+        run(esp_lcd_new_panel_gc9503, &vendor, &tl, &fast);
+        report("gc9503", &def, &fast);
+    }
+    {
+        const esp_lcd_dpi_panel_config_t dpi = EK79007_1024_600_PANEL_60HZ_CONFIG(LCD_COLOR_PIXEL_FORMAT_RGB565);
+        const lcd_boot_delays_t delays = EK79007_FAST_BOOT_DELAYS();
+        ek79007_vendor_config_t vendor = {.mipi_config = {.dsi_bus = bus, .dpi_config = &dpi, .lane_num = 2},
+                                          .boot_timeline = &tl};
+        run(esp_lcd_new_panel_ek79007, &vendor, &tl, &def);
+        vendor.boot_delays = &delays;
+        run(esp_lcd_new_panel_ek79007, &vendor, &tl, &fast);
+        report("ek79007", &def, &fast);
+    }
+
+    printf("%s\n", s_failures ? "FAILED" : "all passed");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,297 @@
+/*
+ * Host test and benchmark for lcd_dirty_ranges.
+ *
+ * Checks merging and splitting of ranges, the cap of LCD_DIRTY_MAX_RANGES with its merge of the
+ * closest pair, the switch to one full-buffer sync, and random rectangles against a per-cache-line
+ * reference. The benchmark prints the sync calls and bytes written back for typical draws next to
+ * one sync per row, and the cost of add_rect() + flush().
+ *
+ * Example:
+ *     g++ -std=gnu++2b -O2 -Wall -Isrc/display tools/host/dirty_ranges_test.cpp src/display/lcd_dirty_ranges.cpp \
+ *         -o /tmp/dirty_ranges_test && /tmp/dirty_ranges_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <chrono>
+#include "lcd_dirty_ranges.h"
+
+static int s_failures;
+
+#define CHECK(cond) do {                                              \
+        if (!(cond)) {                                                \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+            s_failures++;                                             \
+        }                                                             \
+    } while (0)
+
+// 720x1280 RGB565 竖屏帧缓冲，64 字节缓存行；行宽 1440 字节不是缓存行的整数倍
+#define FB_W 720
+#define FB_H 1280
+#define STRIDE (FB_W * 2)
+#define FB_SIZE (STRIDE * FB_H)
+#define LINE 64
+
+typedef struct {
+    size_t offset;
+    size_t size;
+} sync_t;
+
+static void record(size_t offset, size_t size, void *ctx)
+{
+    ((std::vector<sync_t> *)ctx)->push_back({offset, size});
+}
+
+static std::vector<sync_t> flush(lcd_dirty_ranges &d)
+{
+    std::vector<sync_t> out;
+    size_t calls = d.flush(record, &out);
+    CHECK(calls == out.size());
+    CHECK(d.empty() && d.count() == 0 && d.dirty_bytes() == 0);
+    return out;
+}
+
+static void test_merge()
+{
+    int failures = s_failures;
+    lcd_dirty_ranges d;
+    d.begin(FB_SIZE, LINE, 256);
+
+    // 不对齐的写扩到整行
+    d.add(70, 10);
+    CHECK(d.count() == 1 && d.dirty_bytes() == LINE);
+
+    // 间隔不超过 256 字节的合并，超过的单独成段
+    d.add(64 + 64 + 256, 1);
+    CHECK(d.count() == 1);
+    d.add(4096, 64);
+    CHECK(d.count() == 2);
+
+    // 插在中间保持有序，跨两段的写把三段并成一段
+    d.add(2048, 64);
+    CHECK(d.count() == 3);
+    d.add(400, 3700);
+    CHECK(d.count() == 1);
+    std::vector<sync_t> out = flush(d);
+    CHECK(out.size() == 1 && out[0].offset == 64 && out[0].size == 4160 - 64);
+
+    // 超出缓冲区的部分裁掉，起点在外面或长度为 0 的忽略
+    d.add(FB_SIZE - 10, 100);
+    d.add(FB_SIZE, 64);
+    d.add(0, 0);
+    out = flush(d);
+    CHECK(out.size() == 1 && out[0].offset == FB_SIZE - LINE && out[0].size == LINE);
+
+    // 局部宽度矩形：间隔为 0 时每行一段，默认间隔下并成一段。行宽 1440 字节不是缓存行的整数倍，
+    // 各行扩到整行后覆盖的行数不同
+    const size_t rect = (100 * FB_W + 64) * 2;
+    size_t per_row = 0;
+    for (size_t row = 0; row < 10; row++) {
+        size_t a = rect + row * STRIDE;
+        per_row += (a + 128 + LINE - 1) / LINE * LINE - a / LINE * LINE;
+    }
+    size_t span = (rect + 9 * STRIDE + 128 + LINE - 1) / LINE * LINE - rect / LINE * LINE;
+    d.begin(FB_SIZE, LINE, 0);
+    d.add_rect(rect, 64 * 2, STRIDE, 10);
+    CHECK(d.count() == 10 && d.dirty_bytes() == per_row);
+    d.begin(FB_SIZE, LINE);
+    d.add_rect(rect, 64 * 2, STRIDE, 10);
+    CHECK(d.count() == 1 && d.dirty_bytes() == span);
+
+    // 同一块重复写不增加范围和字节数
+    for (int i = 0; i < 10; i++) {
+        d.add_rect(rect, 64 * 2, STRIDE, 10);
+    }
+    CHECK(d.count() == 1 && d.dirty_bytes() == span);
+    printf("merge/split: %s\n", s_failures != failures ? "FAIL" : "ok");
+}
+
+static void test_cap()
+{
+    int failures = s_failures;
+    lcd_dirty_ranges d;
+    d.begin(FB_SIZE, LINE, 0);
+
+    // 每段一行，间隔依次变大；只有第 5、6 段之间特别近，超出上限时应先合并它们
+    const size_t n = LCD_DIRTY_MAX_RANGES + 1;
+    std::vector<size_t> starts;
+    size_t pos = 0;
+    for (size_t i = 0; i < n; i++) {
+        starts.push_back(pos);
+        pos += LINE + (i == 4 ? LINE : LINE * (10 + i));
+    }
+    for (size_t i = 0; i < n; i++) {
+        d.add(starts[i], LINE);
+    }
+    CHECK(d.count() == LCD_DIRTY_MAX_RANGES);
+    CHECK(d.dirty_bytes() == n * LINE + LINE);
+    std::vector<sync_t> out = flush(d);
+    CHECK(out.size() == LCD_DIRTY_MAX_RANGES);
+    CHECK(out[4].offset == starts[4] && out[4].size == starts[5] + LINE - starts[4]);
+    CHECK(out[5].offset == starts[6]);
+
+    // 随机写下去也一直不超过上限，且覆盖所有写过的行
+    srand(2);
+    std::vector<bool> truth(FB_SIZE / LINE, false);
+    for (int i = 0; i < 500; i++) {
+        size_t line = rand() % (FB_SIZE / LINE / 4);
+        d.add(line * LINE, LINE);
+        truth[line] = true;
+        CHECK(d.count() <= LCD_DIRTY_MAX_RANGES);
+    }
+    out = flush(d);
+    std::vector<bool> cover(FB_SIZE / LINE, false);
+    for (auto &s : out) {
+        for (size_t l = s.offset / LINE; l < (s.offset + s.size) / LINE; l++) {
+            cover[l] = true;
+        }
+    }
+    int missed = 0;
+    for (size_t l = 0; l < truth.size(); l++) {
+        missed += truth[l] && !cover[l];
+    }
+    CHECK(missed == 0);
+    printf("cap and collapse: %s\n", s_failures != failures ? "FAIL" : "ok");
+}
+
+static void test_full()
+{
+    int failures = s_failures;
+    lcd_dirty_ranges d;
+    d.begin(FB_SIZE, LINE);
+
+    // 刚好不到一半时仍按范围同步，过半后整块同步一次
+    d.add(0, FB_SIZE / 2 - LINE);
+    CHECK(!d.full() && d.count() == 1);
+    d.add(FB_SIZE - LINE, LINE);
+    CHECK(d.full() && d.count() == 1 && d.dirty_bytes() == FB_SIZE);
+    d.add(FB_SIZE / 2, 64);
+    std::vector<sync_t> out = flush(d);
+    CHECK(out.size() == 1 && out[0].offset == 0 && out[0].size == FB_SIZE);
+
+    // 整行宽度的矩形走一段，60% 的高度也是整块同步
+    d.add_rect(0, STRIDE, STRIDE, FB_H * 6 / 10);
+    CHECK(d.full());
+    flush(d);
+
+    // 阈值可调
+    d.begin(FB_SIZE, LINE, LCD_DIRTY_MERGE_GAP, 10);
+    d.add_rect(0, STRIDE, STRIDE, FB_H / 8);
+    CHECK(d.full());
+    printf("full buffer: %s\n", s_failures != failures ? "FAIL" : "ok");
+}
+
+static void test_random()
+{
+    int failures = s_failures;
+    srand(1);
+    for (int trial = 0; trial < 2000; trial++) {
+        lcd_dirty_ranges d;
+        size_t gap = trial % 3 == 0 ? 0 : (trial % 3 == 1 ? 256 : LCD_DIRTY_MERGE_GAP);
+        d.begin(FB_SIZE, LINE, gap);
+        std::vector<bool> truth(FB_SIZE / LINE, false);
+
+        int rects = 1 + rand() % 12;
+        for (int k = 0; k < rects; k++) {
+            size_t x = rand() % FB_W, y = rand() % FB_H;
+            size_t max_w = trial % 5 == 0 ? FB_W - x : (FB_W - x < 80 ? FB_W - x : 80);
+            size_t w = 1 + rand() % max_w;
+            size_t h = 1 + rand() % (FB_H - y < 100 ? FB_H - y : 100);
+            d.add_rect((y * FB_W + x) * 2, w * 2, STRIDE, h);
+            for (size_t r = 0; r < h; r++) {
+                size_t a = ((y + r) * FB_W + x) * 2;
+                for (size_t l = a / LINE; l < (a + w * 2 + LINE - 1) / LINE; l++) {
+                    truth[l] = true;
+                }
+            }
+        }
+
+        bool full = d.full();
+        size_t ranges = d.count();
+        size_t bytes = d.dirty_bytes();
+        std::vector<sync_t> out = flush(d);
+        CHECK(out.size() <= LCD_DIRTY_MAX_RANGES && (!full || out.size() == 1));
+
+        // 有序、不重叠、按行对齐、相邻两段的间隔大于合并间隔，字节数与 dirty_bytes() 一致
+        std::vector<bool> cover(FB_SIZE / LINE, false);
+        size_t prev_end = 0, sum = 0;
+        for (size_t i = 0; i < out.size(); i++) {
+            const sync_t &s = out[i];
+            CHECK(s.offset % LINE == 0 && s.size % LINE == 0 && s.size && s.offset + s.size <= FB_SIZE);
+            CHECK(i == 0 || (s.offset >= prev_end && s.offset - prev_end > gap));
+            prev_end = s.offset + s.size;
+            sum += s.size;
+            for (size_t l = s.offset / LINE; l < prev_end / LINE; l++) {
+                cover[l] = true;
+            }
+        }
+        CHECK(sum == bytes);
+
+        // 没有合并过的话，同步的行与写过的行完全一致
+        size_t missed = 0, extra = 0;
+        for (size_t l = 0; l < truth.size(); l++) {
+            missed += truth[l] && !cover[l];
+            extra += !truth[l] && cover[l];
+        }
+        CHECK(missed == 0);
+        CHECK(full || gap || ranges == LCD_DIRTY_MAX_RANGES || extra == 0);
+        if (s_failures - failures > 10) {
+            break;
+        }
+    }
+    printf("random rectangles: %s\n", s_failures != failures ? "FAIL" : "ok");
+}
+
+// 一个典型绘制：n 个 w x h 的矩形，比较逐行同步与合并后的同步次数和字节数，并给出 add_rect() + flush() 的耗时
+static void bench(const char *name, int n, size_t w, size_t h)
+{
+    lcd_dirty_ranges d;
+    std::vector<size_t> offsets;
+    srand(3);
+    for (int i = 0; i < n; i++) {
+        offsets.push_back(((rand() % (FB_H - h)) * FB_W + rand() % (FB_W - w)) * 2);
+    }
+
+    size_t rows = 0, row_bytes = 0;
+    for (int i = 0; i < n; i++) {
+        rows += h;
+        row_bytes += h * (((offsets[i] + w * 2 + LINE - 1) / LINE) - offsets[i] / LINE) * LINE;
+    }
+    d.begin(FB_SIZE, LINE);
+    for (int i = 0; i < n; i++) {
+        d.add_rect(offsets[i], w * 2, STRIDE, h);
+    }
+    size_t bytes = d.dirty_bytes();
+    std::vector<sync_t> out = flush(d);
+
+    const int rounds = 2000;
+    std::vector<sync_t> sink;
+    sink.reserve(LCD_DIRTY_MAX_RANGES);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            d.add_rect(offsets[i], w * 2, STRIDE, h);
+        }
+        sink.clear();
+        d.flush(record, &sink);
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / rounds;
+    printf("%-22s per-row %5zu syncs %8zu bytes | merged %2zu syncs %8zu bytes | %.2f us\n", name, rows, row_bytes,
+           out.size(), bytes, us);
+}
+
+int main()
+{
+    test_merge();
+    test_cap();
+    test_full();
+    test_random();
+
+    bench("1 rect 200x100", 1, 200, 100);
+    bench("40 glyphs 16x24", 40, 16, 24);
+    bench("8 widgets 120x60", 8, 120, 60);
+    bench("200 glyphs 16x24", 200, 16, 24);
+    printf("%s\n", s_failures ? "FAILED" : "all passed");
+    return s_failures ? 1 : 0;
+}
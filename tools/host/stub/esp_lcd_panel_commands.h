@@ -0,0 +1,12 @@
+#pragma once
+
+#define LCD_CMD_SWRESET 0x01
+#define LCD_CMD_SLPIN   0x10
+#define LCD_CMD_SLPOUT  0x11
+#define LCD_CMD_INVOFF  0x20
+#define LCD_CMD_INVON   0x21
+#define LCD_CMD_DISPOFF 0x28
+#define LCD_CMD_DISPON  0x29
+#define LCD_CMD_MADCTL  0x36
+#define LCD_CMD_COLMOD  0x3A
+#define LCD_CMD_BGR_BIT (1 << 3)
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "esp_err.h"
+
+typedef struct esp_lcd_panel_io_t *esp_lcd_panel_io_handle_t;
+typedef struct esp_lcd_panel_t *esp_lcd_panel_handle_t;
+
+typedef enum {
+    LCD_RGB_ELEMENT_ORDER_RGB = 0,
+    LCD_RGB_ELEMENT_ORDER_BGR,
+} lcd_rgb_element_order_t;
+
+typedef enum {
+    LCD_RGB_DATA_ENDIAN_BIG = 0,
+    LCD_RGB_DATA_ENDIAN_LITTLE,
+} lcd_rgb_data_endian_t;
+
+typedef enum {
+    LCD_COLOR_PIXEL_FORMAT_RGB565 = 16,
+    LCD_COLOR_PIXEL_FORMAT_RGB666 = 18,
+    LCD_COLOR_PIXEL_FORMAT_RGB888 = 24,
+} lcd_color_rgb_pixel_format_t;
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 由各主机程序自己实现：基准测试用真实时钟，启动模拟用虚拟时钟
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+
+// 主机程序都是单线程的，临界区直接展开为空
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  1
+#define portMAX_DELAY           0xffffffffu
+#define pdMS_TO_TICKS(ms)       ((TickType_t)(ms))
+#define portTICK_PERIOD_MS      1
+
+typedef struct {
+    uint32_t owner;
+    uint32_t count;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0xB33FFFFF, 0 }
+#define portENTER_CRITICAL(mux)      (void)(mux)
+#define portEXIT_CRITICAL(mux)       (void)(mux)
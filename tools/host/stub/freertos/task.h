@@ -0,0 +1,14 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 与 esp_timer_get_time() 一样由主机程序实现
+void vTaskDelay(TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
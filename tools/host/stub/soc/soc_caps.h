@@ -0,0 +1,3 @@
+#pragma once
+
+#define SOC_MIPI_DSI_SUPPORTED 1
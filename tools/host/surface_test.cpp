@@ -0,0 +1,234 @@
+/*
+ * Host test for lcd_surface.h.
+ *
+ * Checks format conversion, rotation by 90/180/270 degrees on non-square surfaces with padded
+ * strides, and clipping in sub(). lcd_surface.h is header-only and needs no ESP-IDF stubs.
+ *
+ * Example:
+ *     g++ -std=gnu++2b -O2 -Wall -Isrc/display tools/host/surface_test.cpp -o /tmp/surface_test && /tmp/surface_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lcd_surface.h"
+
+static int s_failures;
+
+#define CHECK(cond) do {                                              \
+        if (!(cond)) {                                                \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+            s_failures++;                                             \
+        }                                                             \
+    } while (0)
+
+// 源图宽高都不是 16 的倍数，分块转置的边角块也会被走到；行宽留出余量，检查不会写到行尾之外
+#define SRC_W 37
+#define SRC_H 23
+#define PAD 5
+#define GUARD 0xA5
+
+template <class F>
+static void fill_random(const lcd_surface<F> &s)
+{
+    for (auto *row : s.rows()) {
+        for (uint32_t i = 0; i < s.width() * F::units; i++) {
+            row[i] = (typename F::storage_t)rand();
+        }
+    }
+}
+
+template <class F>
+static bool same_pixel(const typename F::storage_t *a, const typename F::storage_t *b)
+{
+    return memcmp(a, b, F::units * sizeof(typename F::storage_t)) == 0;
+}
+
+// 行宽余量里的字节必须保持哨兵值
+template <class F>
+static bool padding_intact(const lcd_surface<F> &s)
+{
+    for (auto *row : s.rows()) {
+        const uint8_t *p = (const uint8_t *)(row + s.width() * F::units);
+        size_t bytes = (s.stride() - s.width()) * F::units * sizeof(typename F::storage_t);
+        for (size_t i = 0; i < bytes; i++) {
+            if (p[i] != GUARD) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <class F>
+static void test_rotate(const char *name)
+{
+    typedef typename F::storage_t T;
+    int failures = s_failures;
+    static T a[(SRC_W + PAD) * SRC_H * 3], b[(SRC_H + PAD) * SRC_W * 3], c[(SRC_W + PAD) * SRC_H * 3];
+    memset(a, GUARD, sizeof(a));
+    memset(b, GUARD, sizeof(b));
+    memset(c, GUARD, sizeof(c));
+    lcd_surface<F> src(a, SRC_W, SRC_H, SRC_W + PAD);
+    lcd_surface<F> tall(b, SRC_H, SRC_W, SRC_H + PAD);
+    lcd_surface<F> wide(c, SRC_W, SRC_H, SRC_W + PAD);
+    fill_random(src);
+
+    int bad = 0;
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_90>(tall, src);
+    for (uint16_t y = 0; y < SRC_H; y++) {
+        for (uint16_t x = 0; x < SRC_W; x++) {
+            bad += !same_pixel<F>(tall.at(SRC_H - 1 - y, x), src.at(x, y));
+        }
+    }
+    CHECK(padding_intact(tall));
+
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_270>(wide, tall);
+    for (uint16_t y = 0; y < SRC_H; y++) {
+        for (uint16_t x = 0; x < SRC_W; x++) {
+            bad += !same_pixel<F>(wide.at(x, y), src.at(x, y));
+        }
+    }
+    CHECK(padding_intact(wide));
+
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_180>(wide, src);
+    for (uint16_t y = 0; y < SRC_H; y++) {
+        for (uint16_t x = 0; x < SRC_W; x++) {
+            bad += !same_pixel<F>(wide.at(SRC_W - 1 - x, SRC_H - 1 - y), src.at(x, y));
+        }
+    }
+    CHECK(padding_intact(wide));
+
+    // 270 度直接转与 90 度转三次一致
+    static T d[(SRC_H + PAD) * SRC_W * 3];
+    lcd_surface<F> tall2(d, SRC_H, SRC_W, SRC_H + PAD);
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_270>(tall2, src);
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_90>(tall, src);
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_90>(wide, tall);
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_90>(tall, wide);
+    for (uint16_t y = 0; y < SRC_W; y++) {
+        bad += memcmp(tall.row(y), tall2.row(y), SRC_H * F::units * sizeof(T)) != 0;
+    }
+    CHECK(bad == 0);
+
+    // 目标放不下时什么都不写
+    memset(b, GUARD, sizeof(b));
+    lcd_surface<F> small(b, SRC_H, SRC_W - 1, SRC_H + PAD);
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_90>(small, src);
+    lcd_surface<F> narrow(b, SRC_W - 1, SRC_H, SRC_W + PAD);
+    lcd_surface_rotate<LCD_SURFACE_ROTATE_180>(narrow, src);
+    bool untouched = true;
+    for (size_t i = 0; i < sizeof(b); i++) {
+        untouched &= ((const uint8_t *)b)[i] == GUARD;
+    }
+    CHECK(untouched);
+    printf("rotate %s: %s\n", name, s_failures != failures ? "FAIL" : "ok");
+}
+
+static void test_convert()
+{
+    int failures = s_failures;
+    static uint8_t rgb[SRC_W * SRC_H * 3];
+    static uint16_t px[(SRC_W + PAD) * SRC_H];
+    static uint32_t argb[SRC_W * SRC_H];
+    lcd_surface<lcd_format_rgb888> r(rgb, SRC_W, SRC_H);
+    lcd_surface<lcd_format_rgb565> p(px, SRC_W, SRC_H, SRC_W + PAD);
+    lcd_surface<lcd_format_argb8888> q(argb, SRC_W, SRC_H);
+
+    // RGB888 走专用循环，结果要与经 0xAARRGGBB 的通用路径一致
+    fill_random(r);
+    memset(px, GUARD, sizeof(px));
+    lcd_surface_convert(p, r);
+    int bad = 0;
+    for (uint16_t y = 0; y < SRC_H; y++) {
+        for (uint16_t x = 0; x < SRC_W; x++) {
+            bad += *p.at(x, y) != lcd_format_rgb565::from_argb(lcd_format_rgb888::to_argb(r.at(x, y)));
+        }
+    }
+    CHECK(bad == 0);
+    CHECK(padding_intact(p));
+
+    // RGB565 -> ARGB8888 -> RGB565 无损，alpha 为不透明
+    static uint16_t back[SRC_W * SRC_H];
+    lcd_surface<lcd_format_rgb565> b(back, SRC_W, SRC_H);
+    lcd_surface_convert(q, p);
+    lcd_surface_convert(b, q);
+    for (uint16_t y = 0; y < SRC_H; y++) {
+        bad += memcmp(b.row(y), p.row(y), SRC_W * 2) != 0;
+        bad += (*q.at(0, y) >> 24) != 0xFF;
+    }
+    CHECK(bad == 0);
+
+    // ARGB8888 -> RGB888 丢掉 alpha，不做混合
+    lcd_surface_fill(q, 0x40123456);
+    lcd_surface_convert(r, q);
+    CHECK(rgb[0] == 0x56 && rgb[1] == 0x34 && rgb[2] == 0x12);
+    lcd_surface_fill(r, 0x12FF80);
+    CHECK(rgb[0] == 0x80 && rgb[1] == 0xFF && rgb[2] == 0x12);
+
+    // 尺寸不同时只拷左上角重叠的部分
+    lcd_surface_fill(p, 0x1111);
+    lcd_surface_fill(b, 0x2222);
+    lcd_surface_blit(p, b.sub(0, 0, 10, 5));
+    CHECK(*p.at(9, 4) == 0x2222 && *p.at(10, 4) == 0x1111 && *p.at(9, 5) == 0x1111);
+    CHECK(padding_intact(p));
+    printf("convert: %s\n", s_failures != failures ? "FAIL" : "ok");
+}
+
+static void test_sub()
+{
+    int failures = s_failures;
+    static uint16_t px[(SRC_W + PAD) * SRC_H];
+    lcd_surface<lcd_format_rgb565> s(px, SRC_W, SRC_H, SRC_W + PAD);
+    memset(px, GUARD, sizeof(px));
+
+    auto inside = s.sub(3, 4, 10, 6);
+    CHECK(inside.width() == 10 && inside.height() == 6 && inside.stride() == s.stride());
+    CHECK(inside.data() == s.at(3, 4));
+
+    // 越过右边和下边的部分被裁掉
+    auto corner = s.sub(30, 20, 100, 100);
+    CHECK(corner.width() == SRC_W - 30 && corner.height() == SRC_H - 20 && corner.data() == s.at(30, 20));
+    int rows = 0;
+    for (auto *row : corner.rows()) {
+        CHECK(row == s.at(30, 20 + rows));
+        rows++;
+    }
+    CHECK(rows == SRC_H - 20);
+
+    // 起点在外面或尺寸为 0 时得到空表面
+    CHECK(s.sub(SRC_W, 0, 1, 1).empty());
+    CHECK(s.sub(0, SRC_H, 1, 1).empty());
+    CHECK(s.sub(0, 0, 0, 5).empty());
+    CHECK(s.sub(SRC_W - 1, SRC_H - 1, 1, 1).width() == 1);
+
+    // 子表面填充不越界
+    lcd_surface_fill(corner, 0xBEEF);
+    int outside = 0, filled = 0;
+    for (uint16_t y = 0; y < SRC_H; y++) {
+        for (uint16_t x = 0; x < SRC_W; x++) {
+            bool in = x >= 30 && y >= 20;
+            filled += in && *s.at(x, y) == 0xBEEF;
+            outside += !in && *s.at(x, y) != (GUARD << 8 | GUARD);
+        }
+    }
+    CHECK(filled == (SRC_W - 30) * (SRC_H - 20) && outside == 0);
+    CHECK(padding_intact(s));
+
+    // 格式不符的视图转换得到空表面
+    lcd_surface_view v(s);
+    CHECK(v.as<lcd_format_rgb565>().data() == px && !v.as<lcd_format_rgb888>().data());
+    printf("sub: %s\n", s_failures != failures ? "FAIL" : "ok");
+}
+
+int main()
+{
+    srand(1);
+    test_rotate<lcd_format_rgb565>("rgb565");
+    test_rotate<lcd_format_rgb888>("rgb888");
+    test_rotate<lcd_format_argb8888>("argb8888");
+    test_convert();
+    test_sub();
+    printf("%s\n", s_failures ? "FAILED" : "all passed");
+    return s_failures ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+Convert a PNG into a splash partition image for lcd_splash_show().
+
+The output is a 16-byte lcd_splash_header_t followed by little-endian RGB565
+rows, the same layout as the DPI frame buffer, so the device copies it
+straight out of the memory-mapped partition. Images larger than the screen
+are scaled down to fit; by default the image is centred. Transparent pixels
+are blended over the background colour.
+
+Add a data partition big enough for the output to partitions.csv, e.g.
+    splash, data, 0x40, , 0x180000
+then flash it with
+    parttool.py --partition-name splash write_partition --input splash.bin
+
+Example:
+    python3 tools/png2splash.py logo.png --screen 720x720 -o splash.bin
+"""
+
+import argparse
+import struct
+import sys
+
+try:
+    from PIL import Image
+except ImportError:
+    sys.exit("png2splash needs Pillow: pip install pillow")
+
+MAGIC = 0x314C5053  # "SPL1"
+FORMAT_RGB565 = 0
+HEADER = struct.Struct("<IHHHHB3x")
+MMU_PAGE = 0x10000
+
+
+def parse_size(text):
+    w, _, h = text.lower().partition("x")
+    return int(w), int(h)
+
+
+def parse_color(text):
+    text = text.lstrip("#")
+    if len(text) != 6:
+        raise argparse.ArgumentTypeError("colour must be RRGGBB")
+    return tuple(int(text[i:i + 2], 16) for i in (0, 2, 4))
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def convert(img, screen, pos, background, full):
+    sw, sh = screen
+    if img.width > sw or img.height > sh:
+        scale = min(sw / img.width, sh / img.height)
+        img = img.resize((max(1, int(img.width * scale)), max(1, int(img.height * scale))), Image.LANCZOS)
+
+    flat = Image.new("RGB", img.size, background)
+    flat.paste(img, mask=img.getchannel("A") if "A" in img.getbands() else None)
+
+    x, y = pos if pos else ((sw - flat.width) // 2, (sh - flat.height) // 2)
+    if x + flat.width > sw or y + flat.height > sh:
+        sys.exit("image %dx%d at (%d, %d) does not fit a %dx%d screen" % (flat.width, flat.height, x, y, sw, sh))
+    if full:
+        # Cover the whole screen so nothing of the previous frame buffer content shows
+        canvas = Image.new("RGB", screen, background)
+        canvas.paste(flat, (x, y))
+        flat, x, y = canvas, 0, 0
+
+    raw = flat.tobytes()
+    pixels = bytearray()
+    for i in range(0, len(raw), 3):
+        pixels += struct.pack("<H", rgb565(raw[i], raw[i + 1], raw[i + 2]))
+    return HEADER.pack(MAGIC, flat.width, flat.height, x, y, FORMAT_RGB565) + bytes(pixels)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", help="PNG file")
+    parser.add_argument("-o", "--output", default="splash.bin", help="partition image (default: splash.bin)")
+    parser.add_argument("--screen", type=parse_size, required=True, help="panel resolution, e.g. 1024x600")
+    parser.add_argument("--pos", type=parse_size, help="top-left corner as XxY instead of centring")
+    parser.add_argument("--background", type=parse_color, default=(0, 0, 0), help="RRGGBB (default: 000000)")
+    parser.add_argument("--full", action="store_true", help="pad the image to the full screen with the background")
+    args = parser.parse_args()
+
+    img = Image.open(args.input).convert("RGBA")
+    data = convert(img, args.screen, args.pos, args.background, args.full)
+    with open(args.output, "wb") as f:
+        f.write(data)
+
+    part = (len(data) + MMU_PAGE - 1) // MMU_PAGE * MMU_PAGE
+    print("%s: %d bytes, needs a partition of at least 0x%X" % (args.output, len(data), part), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
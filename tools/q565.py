@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""
+Encode PNG images as Q565 streams for lcd_q565_decoder.
+
+Q565 is a QOI-style codec working directly on RGB565 pixels, so the device
+decodes into band buffers or the frame buffer without a conversion step. Each
+op is one to three bytes: an index into the last 64 hashed colours, a small
+per-channel delta, a green-relative delta, a run of the previous pixel or a
+literal pixel. Transparent pixels are blended over the background colour.
+
+Example:
+    python3 tools/q565.py photo.png -o photo.q565
+    python3 tools/q565.py --check photo.q565 photo.png
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x35363551  # "Q565"
+HEADER = struct.Struct("<IHHI")
+
+OP_INDEX = 0x00
+OP_DIFF = 0x40
+OP_LUMA = 0x80
+OP_RUN = 0xC0
+OP_RGB = 0xFE
+MAX_RUN = 62
+
+
+def q565_hash(px):
+    return ((px >> 11) * 3 + ((px >> 5) & 0x3F) * 5 + (px & 0x1F) * 7) & 0x3F
+
+
+def wrap(value, bits):
+    """Signed difference modulo 2**bits, in [-2**(bits-1), 2**(bits-1))."""
+    half = 1 << (bits - 1)
+    return ((value + half) & ((1 << bits) - 1)) - half
+
+
+def encode(pixels, width, height):
+    """Encode a list of RGB565 values, row-major, into a Q565 stream."""
+    out = bytearray()
+    index = [0] * 64
+    prev = 0
+    run = 0
+    for i, px in enumerate(pixels):
+        if px == prev:
+            run += 1
+            if run == MAX_RUN:
+                out.append(OP_RUN | (run - 1))
+                run = 0
+            continue
+        if run:
+            out.append(OP_RUN | (run - 1))
+            run = 0
+
+        h = q565_hash(px)
+        if index[h] == px:
+            out.append(OP_INDEX | h)
+        else:
+            index[h] = px
+            dr = wrap((px >> 11) - (prev >> 11), 5)
+            dg = wrap(((px >> 5) & 0x3F) - ((prev >> 5) & 0x3F), 6)
+            db = wrap((px & 0x1F) - (prev & 0x1F), 5)
+            dr_dg = wrap(dr - (dg >> 1), 5)
+            db_dg = wrap(db - (dg >> 1), 5)
+            if -2 <= dr <= 1 and -2 <= dg <= 1 and -2 <= db <= 1:
+                out.append(OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2))
+            elif -8 <= dr_dg <= 7 and -8 <= db_dg <= 7:
+                out.append(OP_LUMA | (dg + 32))
+                out.append((dr_dg + 8) << 4 | (db_dg + 8))
+            else:
+                out += bytes((OP_RGB, px & 0xFF, px >> 8))
+        prev = px
+    if run:
+        out.append(OP_RUN | (run - 1))
+    return HEADER.pack(MAGIC, width, height, len(out)) + bytes(out)
+
+
+def decode(data):
+    """Reference decoder, returns (width, height, pixels)."""
+    magic, width, height, size = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("not a Q565 stream")
+    p = HEADER.size
+    end = p + size
+    index = [0] * 64
+    px = 0
+    pixels = []
+    total = width * height
+    while len(pixels) < total:
+        if p >= end:
+            raise ValueError("truncated stream")
+        op = data[p]
+        p += 1
+        if op < OP_DIFF:
+            px = index[op]
+        elif op < OP_LUMA:
+            r = ((px >> 11) + ((op >> 4) & 3) - 2) & 0x1F
+            g = (((px >> 5) & 0x3F) + ((op >> 2) & 3) - 2) & 0x3F
+            b = ((px & 0x1F) + (op & 3) - 2) & 0x1F
+            px = r << 11 | g << 5 | b
+        elif op < OP_RUN:
+            dg = (op & 0x3F) - 32
+            rb = data[p]
+            p += 1
+            r = ((px >> 11) + (dg >> 1) + (rb >> 4) - 8) & 0x1F
+            g = (((px >> 5) & 0x3F) + dg) & 0x3F
+            b = ((px & 0x1F) + (dg >> 1) + (rb & 0x0F) - 8) & 0x1F
+            px = r << 11 | g << 5 | b
+        elif op < OP_RGB:
+            pixels += [px] * (op - OP_RUN + 1)
+            continue
+        elif op == OP_RGB:
+            px = data[p] | data[p + 1] << 8
+            p += 2
+        else:
+            raise ValueError("bad op 0x%02X" % op)
+        index[q565_hash(px)] = px
+        pixels.append(px)
+    return width, height, pixels[:total]
+
+
+def load_png(path, background):
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("q565 needs Pillow: pip install pillow")
+    img = Image.open(path).convert("RGBA")
+    flat = Image.new("RGB", img.size, background)
+    flat.paste(img, mask=img.getchannel("A"))
+    raw = flat.tobytes()
+    pixels = [((raw[i] & 0xF8) << 8) | ((raw[i + 1] & 0xFC) << 3) | (raw[i + 2] >> 3) for i in range(0, len(raw), 3)]
+    return flat.width, flat.height, pixels
+
+
+def parse_color(text):
+    text = text.lstrip("#")
+    if len(text) != 6:
+        raise argparse.ArgumentTypeError("colour must be RRGGBB")
+    return tuple(int(text[i:i + 2], 16) for i in (0, 2, 4))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", help="PNG file, or the Q565 stream with --check")
+    parser.add_argument("png", nargs="?", help="with --check: PNG to compare against")
+    parser.add_argument("-o", "--output", help="output stream (default: input with .q565)")
+    parser.add_argument("--background", type=parse_color, default=(0, 0, 0), help="RRGGBB (default: 000000)")
+    parser.add_argument("--check", action="store_true", help="decode a stream and compare it with the PNG")
+    args = parser.parse_args()
+
+    if args.check:
+        if not args.png:
+            parser.error("--check needs the stream and the PNG")
+        with open(args.input, "rb") as f:
+            width, height, pixels = decode(f.read())
+        if (width, height, pixels) != load_png(args.png, args.background):
+            sys.exit("%s does not match %s" % (args.input, args.png))
+        print("%s: %dx%d, matches" % (args.input, width, height), file=sys.stderr)
+        return
+
+    width, height, pixels = load_png(args.input, args.background)
+    data = encode(pixels, width, height)
+    output = args.output or args.input.rsplit(".", 1)[0] + ".q565"
+    with open(output, "wb") as f:
+        f.write(data)
+    print("%s: %dx%d, %d bytes, %.1f%% of raw RGB565"
+          % (output, width, height, len(data), 100.0 * len(data) / (2 * width * height)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
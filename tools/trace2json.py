@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""
+Convert an lcd_trace serial dump into Chrome trace JSON.
+
+Build with LCD_TRACE_ENABLE=1, call lcd_trace_dump() and capture the serial
+output to a file. Every "@core,ts,tid,phase,arg,name" line in the capture is
+turned into a trace event; other log lines are ignored. Open the result in
+chrome://tracing or https://ui.perfetto.dev.
+
+Example:
+    python3 tools/trace2json.py serial.log -o trace.json
+"""
+
+import argparse
+import json
+import sys
+
+
+def parse(lines):
+    """Return per-core lists of (ts, tid, phase, arg, name) in ring order."""
+    cores = {}
+    for line in lines:
+        line = line.strip()
+        at = line.find("@")
+        if at < 0:
+            continue
+        fields = line[at + 1:].split(",", 5)
+        if len(fields) != 6:
+            continue
+        try:
+            core, ts, tid, arg = int(fields[0]), int(fields[1]), int(fields[2], 16), int(fields[4])
+        except ValueError:
+            continue
+        cores.setdefault(core, []).append((ts, tid, fields[3], arg, fields[5]))
+    return cores
+
+
+def unwrap(records):
+    """The device keeps the low 32 bits of esp_timer; undo the wrap-around per core."""
+    out = []
+    base = 0
+    last = None
+    for ts, tid, phase, arg, name in records:
+        if last is not None and ts < last and last - ts > 1 << 31:
+            base += 1 << 32
+        last = ts
+        out.append((ts + base, tid, phase, arg, name))
+    return out
+
+
+def convert(cores):
+    events = []
+    threads = {}
+    for core, records in sorted(cores.items()):
+        for ts, tid, phase, arg, name in unwrap(records):
+            # ISR records carry no task; give each core its own "ISR" track
+            key = tid if tid else -1 - core
+            if key not in threads:
+                threads[key] = len(threads) + 1
+                label = "task %08x" % tid if tid else "ISR core %d" % core
+                events.append({"ph": "M", "name": "thread_name", "pid": 0, "tid": threads[key],
+                               "args": {"name": label}})
+            ev = {"name": name, "ph": phase, "ts": ts, "pid": 0, "tid": threads[key]}
+            if phase in ("b", "e"):
+                ev["cat"] = name
+                ev["id"] = arg
+            elif phase == "C":
+                ev["args"] = {name: arg}
+            elif phase == "i":
+                ev["s"] = "t"
+                ev["args"] = {"arg": arg}
+            events.append(ev)
+    events.sort(key=lambda e: e.get("ts", -1))
+    return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("input", nargs="?", help="serial capture, stdin if omitted")
+    parser.add_argument("-o", "--output", help="output JSON, stdout if omitted")
+    args = parser.parse_args()
+
+    if args.input:
+        with open(args.input, encoding="utf-8", errors="replace") as f:
+            cores = parse(f)
+    else:
+        cores = parse(sys.stdin)
+    if not cores:
+        sys.exit("no lcd_trace records found")
+
+    trace = convert(cores)
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            json.dump(trace, f)
+    else:
+        json.dump(trace, sys.stdout)
+    print("%d events from %d core(s)" % (len(trace["traceEvents"]), len(cores)), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()